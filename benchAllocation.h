@@ -0,0 +1,89 @@
+/***********************************************************************
+ * Header:
+ *    BENCH ALLOCATION
+ * Summary:
+ *    The memory a priority_queue<int> of 10^6 keys costs, through
+ *    tracking_allocator: grown by push from empty, grown into a vector
+ *    reserved up front, heapified from a vector filled first, and
+ *    after popping half of it. For each: the peak bytes, the bytes
+ *    live at the end and how many of them hold no element.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "priority_queue.h"
+#include "tracking_allocator.h"
+
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cout
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+class BenchAllocation : public Benchmark
+{
+public:
+   void run()
+   {
+      const size_t numKeys = 1000000;
+      bench_build("push from empty", numKeys, false, false, false);
+      bench_build("reserve, then push", numKeys, true, false, false);
+      bench_build("fill, then heapify", numKeys, true, true, false);
+      bench_build("push, then pop half", numKeys, false, false, true);
+      report("Allocation");
+
+      std::cout << "\t" << std::left << std::setw(28) << "memory"
+                << std::right << std::setw(12) << "peak" << std::setw(12) << "live"
+                << std::setw(12) << "wasted" << std::setw(8) << "allocs" << "\n";
+      for (auto & row : rows)
+         std::cout << "\t" << std::left << std::setw(28) << row.name << std::right
+                   << std::setw(10) << row.report.bytesPeak / 1024 << "KB"
+                   << std::setw(10) << row.report.bytesLive / 1024 << "KB"
+                   << std::setw(10) << row.report.bytesWasted() / 1024 << "KB"
+                   << std::setw(8) << row.report.allocations << "\n";
+   }
+
+private:
+   typedef custom::vector<int, custom::tracking_allocator<int>> Vector;
+   typedef custom::priority_queue<int, Vector> PQueue;
+
+   struct Row
+   {
+      std::string name;
+      custom::allocation_report report;
+   };
+   std::vector<Row> rows;
+
+   /*************************************************************
+    * BUILD
+    * One way of filling a queue, timed and tracked
+    *************************************************************/
+   void bench_build(const std::string & name, size_t numKeys,
+                    bool reserving, bool heapifying, bool poppingHalf)
+   {
+      seed = 41;
+      custom::allocation_tracker tracker;
+      custom::allocation_report report;
+      double ns = measure(numKeys, [&]()
+      {
+         Vector v{ custom::tracking_allocator<int>(tracker) };
+         if (reserving)
+            v.reserve(numKeys);
+         if (heapifying)
+            for (size_t i = 0; i < numKeys; i++)
+               v.push_back((int)(random() >> 33));
+         PQueue q(std::less<int>(), std::move(v));
+         if (!heapifying)
+            for (size_t i = 0; i < numKeys; i++)
+               q.push((int)(random() >> 33));
+         if (poppingHalf)
+            for (size_t i = 0; i < numKeys / 2; i++)
+               q.pop();
+         report = tracker.report();
+      });
+      record(name, numKeys, ns);
+      rows.push_back(Row{ name, report });
+   }
+};
@@ -0,0 +1,69 @@
+/***********************************************************************
+ * Header:
+ *    BENCH BOUNDED PRIORITY QUEUE
+ * Summary:
+ *    Top-1000 of a stream of 10^7 random keys: the bounded queue's
+ *    offer() against push-then-pop on an unbounded min-heap.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "bounded_priority_queue.h"
+#include "priority_queue.h"
+
+#include <functional>   // for std::greater
+
+class BenchBoundedPQueue : public Benchmark
+{
+public:
+   void run()
+   {
+      const size_t k = 1000;
+      const size_t numRecords = 10000000;
+      bench_offer(k, numRecords);
+      bench_pushPop(k, numRecords);
+      report("BoundedPQueue");
+   }
+
+   /*************************************************************
+    * OFFER
+    * bounded_priority_queue::offer for every record
+    *************************************************************/
+   void bench_offer(size_t k, size_t numRecords)
+   {
+      seed = 21;
+      custom::bounded_priority_queue<uint64_t> q(k);
+      double ns = measure(numRecords, [&]()
+      {
+         for (size_t i = 0; i < numRecords; i++)
+            q.offer(random());
+      });
+      consume(q.top());
+      record("bounded_priority_queue::offer", k, ns);
+   }
+
+   /*************************************************************
+    * PUSH POP
+    * The unbounded way: push every record, pop the smallest
+    * whenever there are more than K
+    *************************************************************/
+   void bench_pushPop(size_t k, size_t numRecords)
+   {
+      seed = 21;
+      custom::priority_queue<uint64_t, custom::vector<uint64_t>, std::greater<uint64_t>> q;
+      double ns = measure(numRecords, [&]()
+      {
+         for (size_t i = 0; i < numRecords; i++)
+         {
+            q.push(random());
+            if (q.size() > k)
+               q.pop();
+         }
+      });
+      consume(q.top());
+      record("priority_queue push + pop", k, ns);
+   }
+};
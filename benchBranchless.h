@@ -0,0 +1,75 @@
+/***********************************************************************
+ * Header:
+ *    BENCH BRANCHLESS
+ * Summary:
+ *    Build a priority_queue of 10^6 keys, then pop them all, with the
+ *    keys random, ascending and descending. uint64_t takes the
+ *    branchless sift; the same key in a wrapper that is not trivially
+ *    copyable takes the original swapping one.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "priority_queue.h"
+
+#include <string>   // for std::string
+
+class BenchBranchless : public Benchmark
+{
+public:
+   void run()
+   {
+      const size_t numKeys = 1000000;
+      for (int order = 0; order < 3; order++)
+      {
+         bench_drain<Branchy>("branchy", numKeys, order);
+         bench_drain<uint64_t>("branchless", numKeys, order);
+      }
+      report("Branchless");
+   }
+
+   /*************************************************************
+    * BRANCHY
+    * A uint64_t with a user-provided copy, so the queue
+    * cannot treat it as trivially copyable
+    *************************************************************/
+   struct Branchy
+   {
+      Branchy(uint64_t v = 0) : value(v) { }
+      Branchy(const Branchy & rhs) : value(rhs.value) { }
+      Branchy & operator = (const Branchy & rhs) { value = rhs.value; return *this; }
+      bool operator < (const Branchy & rhs) const { return value < rhs.value; }
+      operator uint64_t () const { return value; }
+      uint64_t value;
+   };
+
+   /*************************************************************
+    * DRAIN
+    * Heapify, then pop every key. ORDER is 0 for random,
+    * 1 for ascending and 2 for descending keys.
+    *************************************************************/
+   template <class T>
+   void bench_drain(const std::string & name, size_t numKeys, int order)
+   {
+      static const char * orders[] = { " random", " ascending", " descending" };
+      seed = 36;
+      custom::vector<T> keys;
+      keys.reserve(numKeys);
+      for (size_t i = 0; i < numKeys; i++)
+         keys.push_back(order == 0 ? random() : order == 1 ? i : numKeys - i);
+
+      double ns = measure(numKeys, [&]()
+      {
+         custom::priority_queue<T> q(std::less<T>(), keys);
+         while (!q.empty())
+         {
+            consume(q.top());
+            q.pop();
+         }
+      });
+      record(name + orders[order], numKeys, ns);
+   }
+};
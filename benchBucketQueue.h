@@ -0,0 +1,81 @@
+/***********************************************************************
+ * Header:
+ *    BENCH BUCKET QUEUE
+ * Summary:
+ *    Bucket queue against a binary heap with 256 QoS levels. The heap
+ *    is given {priority, sequence} pairs so both are FIFO within a level.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "bucket_queue.h"
+#include "priority_queue.h"
+
+#include <utility>   // for std::pair
+
+class BenchBucketQueue : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t numJobs : { (size_t)1000, (size_t)1000000 })
+      {
+         bench_bucketQueue(numJobs);
+         bench_binaryHeap(numJobs);
+      }
+      report("BucketQueue");
+   }
+
+   /*************************************************************
+    * BUCKET QUEUE
+    * Hold numJobs jobs; pop one and push one, 4 * numJobs times
+    *************************************************************/
+   void bench_bucketQueue(size_t numJobs)
+   {
+      const size_t numOps = numJobs * 4;
+      seed = 3;
+      custom::bucket_queue<uint8_t> q;
+      for (size_t i = 0; i < numJobs; i++)
+         q.push((uint8_t)random());
+
+      double ns = measure(numOps, [&]()
+      {
+         for (size_t i = 0; i < numOps; i++)
+         {
+            consume(q.top());
+            q.pop();
+            q.push((uint8_t)random());
+         }
+      });
+      record("bucket_queue", numJobs, ns);
+   }
+
+   /*************************************************************
+    * BINARY HEAP
+    * The same workload with {priority, -sequence} pairs
+    *************************************************************/
+   void bench_binaryHeap(size_t numJobs)
+   {
+      typedef std::pair<uint8_t, int64_t> Job;
+      const size_t numOps = numJobs * 4;
+      int64_t sequence = 0;
+      seed = 3;
+      custom::priority_queue<Job> q;
+      for (size_t i = 0; i < numJobs; i++)
+         q.push(Job((uint8_t)random(), --sequence));
+
+      double ns = measure(numOps, [&]()
+      {
+         for (size_t i = 0; i < numOps; i++)
+         {
+            consume(q.top().first);
+            q.pop();
+            q.push(Job((uint8_t)random(), --sequence));
+         }
+      });
+      record("priority_queue (binary heap)", numJobs, ns);
+   }
+};
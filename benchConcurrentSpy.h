@@ -0,0 +1,110 @@
+/***********************************************************************
+ * Header:
+ *    BENCH CONCURRENT SPY
+ * Summary:
+ *    What counting costs when several threads each drive their own
+ *    priority_queue: 10^6 pushes and pops split across 1, 2 and 4
+ *    threads, with keys that count nothing, that count into one
+ *    shared atomic array (a lock-prefixed add to lines every thread
+ *    writes), and ConcurrentSpy.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "concurrent_spy.h"
+#include "priority_queue.h"
+
+#include <atomic>    // for std::atomic
+#include <string>    // for std::string
+#include <thread>    // for std::thread
+#include <vector>    // for std::vector
+
+class BenchConcurrentSpy : public Benchmark
+{
+public:
+   void run()
+   {
+      const size_t numOps = 1000000;
+      for (size_t numThreads = 1; numThreads <= 4; numThreads *= 2)
+      {
+         bench_threads<Plain>("uncounted", numOps, numThreads);
+         bench_threads<Shared>("shared atomic", numOps, numThreads);
+         bench_threads<ConcurrentSpy>("ConcurrentSpy", numOps, numThreads);
+      }
+      report("ConcurrentSpy");
+   }
+
+   /*************************************************************
+    * PLAIN
+    * The same shape as ConcurrentSpy, counting nothing
+    *************************************************************/
+   struct Plain
+   {
+      Plain(uint64_t v = 0) : value(v) { }
+      Plain(const Plain & rhs) : value(rhs.value) { }
+      Plain & operator = (const Plain & rhs) { value = rhs.value; return *this; }
+      bool operator < (const Plain & rhs) const { return value < rhs.value; }
+      uint64_t get() const { return value; }
+      uint64_t value;
+   };
+
+   /*************************************************************
+    * SHARED
+    * Counting into one array of atomics all threads share
+    *************************************************************/
+   struct Shared
+   {
+      Shared(uint64_t v = 0) : value(v) { count(NONDEFAULT); }
+      Shared(const Shared & rhs) : value(rhs.value) { count(COPY); }
+      ~Shared() { count(DESTRUCTOR); }
+      Shared & operator = (const Shared & rhs) { value = rhs.value; count(ASSIGN); return *this; }
+      bool operator < (const Shared & rhs) const { count(LESSTHAN); return value < rhs.value; }
+      uint64_t get() const { return value; }
+      static void count(int marker)
+      {
+         static std::atomic<uint64_t> counters[NUM_MARKERS];
+         counters[marker].fetch_add(1, std::memory_order_relaxed);
+      }
+      uint64_t value;
+   };
+
+private:
+   /*************************************************************
+    * THREADS
+    * Each thread pushes its share of random keys, then pops them
+    *************************************************************/
+   template <class T>
+   void bench_threads(const std::string & name, size_t numOps, size_t numThreads)
+   {
+      size_t perThread = numOps / numThreads / 2;
+      double ns = measure(numOps, [&]()
+      {
+         std::vector<std::thread> threads;
+         for (size_t t = 0; t < numThreads; t++)
+            threads.emplace_back([perThread, t]()
+            {
+               uint64_t state = 40 + t;
+               uint64_t sum = 0;
+               custom::priority_queue<T> q;
+               for (size_t i = 0; i < perThread; i++)
+               {
+                  state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                  q.push(T(state >> 16));
+               }
+               while (!q.empty())
+               {
+                  sum += q.top().get();
+                  q.pop();
+               }
+               volatile uint64_t keep = sum;
+               (void)keep;
+            });
+         for (auto & thread : threads)
+            thread.join();
+      });
+      record(name + " x" + std::to_string(numThreads), numOps, ns);
+   }
+};
@@ -0,0 +1,345 @@
+/***********************************************************************
+ * Header:
+ *    BENCH CORE
+ * Summary:
+ *    The everyday operations of priority_queue and vector against
+ *    std::priority_queue and std::vector: push, pop, push+pop,
+ *    heapify and range construction; push_back, reserve, copy and
+ *    move. Each runs on int, a 16-byte POD, Spy and std::string, at
+ *    sizes from 10 up to Benchmark::maxSize(). Small sizes are
+ *    repeated until about 10^6 operations have run.
+ *
+ *    Besides ns/op, the heap results carry comparisons/op (through a
+ *    counting comparator) and all results allocations/op (through the
+ *    driver's operator new).
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "priority_queue.h"
+#include "vector.h"
+#include "spy.h"
+
+#include <new>       // for placement new
+#include <queue>     // for std::priority_queue
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+/*************************************************************
+ * POD 16
+ * A key with a payload, sixteen bytes and trivially copyable
+ *************************************************************/
+struct Pod16
+{
+   uint64_t key;
+   uint64_t payload;
+   bool operator < (const Pod16 & rhs) const { return key < rhs.key; }
+};
+
+/*************************************************************
+ * BENCH KEY
+ * How to make each element type from a random number, fold
+ * it into the sink, and how big a sweep it can afford: Spy
+ * and std::string cost a heap block per element
+ *************************************************************/
+template <class T> struct BenchKey;
+
+template <> struct BenchKey<int>
+{
+   static constexpr const char * name = "int";
+   static const size_t maxSize = 100000000;
+   static int make(uint64_t r)          { return (int)(r >> 33); }
+   static uint64_t value(const int & t) { return (uint64_t)t; }
+};
+
+template <> struct BenchKey<Pod16>
+{
+   static constexpr const char * name = "Pod16";
+   static const size_t maxSize = 100000000;
+   static Pod16 make(uint64_t r)          { return Pod16{ r, ~r }; }
+   static uint64_t value(const Pod16 & t) { return t.key + t.payload; }
+};
+
+template <> struct BenchKey<Spy>
+{
+   static constexpr const char * name = "Spy";
+   static const size_t maxSize = 10000000;
+   static Spy make(uint64_t r)          { return Spy((int)(r >> 33)); }
+   static uint64_t value(const Spy & t) { return (uint64_t)t.get(); }
+};
+
+template <> struct BenchKey<std::string>
+{
+   static constexpr const char * name = "std::string";
+   static const size_t maxSize = 10000000;
+   static std::string make(uint64_t r)          { return std::to_string(r); }
+   static uint64_t value(const std::string & t) { return t.size() + (uint64_t)t[0]; }
+};
+
+class BenchCore : public Benchmark
+{
+public:
+   void run()
+   {
+      bench_type<int>();
+      bench_type<Pod16>();
+      bench_type<Spy>();
+      bench_type<std::string>();
+   }
+
+   /*************************************************************
+    * COUNTING LESS
+    * std::less that counts how often it is asked
+    *************************************************************/
+   template <class T>
+   struct CountingLess
+   {
+      bool operator () (const T & lhs, const T & rhs) const
+      {
+         comparisons()++;
+         return lhs < rhs;
+      }
+      static uint64_t & comparisons()
+      {
+         static uint64_t count = 0;
+         return count;
+      }
+   };
+
+private:
+   // time, comparisons and allocations over the timed parts of a sweep
+   struct Tally
+   {
+      double   ns = 0.0;
+      uint64_t comparisons = 0;
+      uint64_t allocations = 0;
+   };
+
+   static const size_t OPS_PER_SIZE = 1000000;
+
+   /*************************************************************
+    * TIMED
+    * Run F as part of TALLY
+    *************************************************************/
+   template <class T, class Function>
+   void timed(Tally & tally, Function f)
+   {
+      uint64_t comparisons = CountingLess<T>::comparisons();
+      uint64_t allocs = allocations();
+      tally.ns += measure(0, f);
+      tally.comparisons += CountingLess<T>::comparisons() - comparisons;
+      tally.allocations += allocations() - allocs;
+   }
+
+   void recordTally(const std::string & name, size_t size, const Tally & tally,
+                    size_t numOps, bool comparing)
+   {
+      record(name, size, tally.ns / (double)numOps,
+             comparing ? (double)tally.comparisons / (double)numOps : -1.0,
+             (double)tally.allocations / (double)numOps);
+   }
+
+   /*************************************************************
+    * TYPE
+    * Every operation at every size for one element type
+    *************************************************************/
+   template <class T>
+   void bench_type()
+   {
+      typedef custom::priority_queue<T, custom::vector<T>, CountingLess<T>> PQueue;
+      typedef std::priority_queue<T, std::vector<T>, CountingLess<T>>       StdPQueue;
+      std::string type = std::string("<") + BenchKey<T>::name + ">";
+
+      for (size_t size = 10; size <= maxSize() && size <= BenchKey<T>::maxSize; size *= 10)
+      {
+         seed = 37;
+         std::vector<T> keys;
+         keys.reserve(size);
+         for (size_t i = 0; i < size; i++)
+            keys.push_back(BenchKey<T>::make(random()));
+         size_t reps = size < OPS_PER_SIZE ? OPS_PER_SIZE / size : 1;
+
+         bench_push<T, PQueue>   ("priority_queue" + type, keys, reps);
+         bench_push<T, StdPQueue>("std::priority_queue" + type, keys, reps);
+         bench_pop<T, PQueue>    ("priority_queue" + type, keys, reps);
+         bench_pop<T, StdPQueue> ("std::priority_queue" + type, keys, reps);
+         bench_pushPop<T, PQueue>   ("priority_queue" + type, keys, reps);
+         bench_pushPop<T, StdPQueue>("std::priority_queue" + type, keys, reps);
+         bench_heapify<T, PQueue, custom::vector<T>>("priority_queue" + type, keys, reps);
+         bench_heapify<T, StdPQueue, std::vector<T>>("std::priority_queue" + type, keys, reps);
+         bench_range<T, PQueue>   ("priority_queue" + type, keys, reps);
+         bench_range<T, StdPQueue>("std::priority_queue" + type, keys, reps);
+
+         bench_vector<T, custom::vector<T>>("vector" + type, keys, reps);
+         bench_vector<T, std::vector<T>>   ("std::vector" + type, keys, reps);
+      }
+      report(("Core" + type).c_str());
+   }
+
+   /*************************************************************
+    * PUSH
+    * Push every key onto an empty heap
+    *************************************************************/
+   template <class T, class Heap>
+   void bench_push(const std::string & name, const std::vector<T> & keys, size_t reps)
+   {
+      Tally tally;
+      for (size_t rep = 0; rep < reps; rep++)
+      {
+         Heap q;
+         timed<T>(tally, [&]()
+         {
+            for (auto & key : keys)
+               q.push(key);
+         });
+      }
+      recordTally(name + " push", keys.size(), tally, keys.size() * reps, true);
+   }
+
+   /*************************************************************
+    * POP
+    * Pop a full heap down to empty
+    *************************************************************/
+   template <class T, class Heap>
+   void bench_pop(const std::string & name, const std::vector<T> & keys, size_t reps)
+   {
+      Tally tally;
+      for (size_t rep = 0; rep < reps; rep++)
+      {
+         Heap q(keys.begin(), keys.end(), CountingLess<T>());
+         timed<T>(tally, [&]()
+         {
+            while (!q.empty())
+            {
+               consume(BenchKey<T>::value(q.top()));
+               q.pop();
+            }
+         });
+      }
+      recordTally(name + " pop", keys.size(), tally, keys.size() * reps, true);
+   }
+
+   /*************************************************************
+    * PUSH POP
+    * The hold model: pop the top and push a key, at a steady size
+    *************************************************************/
+   template <class T, class Heap>
+   void bench_pushPop(const std::string & name, const std::vector<T> & keys, size_t reps)
+   {
+      Tally tally;
+      for (size_t rep = 0; rep < reps; rep++)
+      {
+         Heap q(keys.begin(), keys.end(), CountingLess<T>());
+         timed<T>(tally, [&]()
+         {
+            for (size_t i = keys.size(); i-- > 0; )
+            {
+               consume(BenchKey<T>::value(q.top()));
+               q.pop();
+               q.push(keys[i]);
+            }
+         });
+      }
+      recordTally(name + " push+pop", keys.size(), tally, keys.size() * reps, true);
+   }
+
+   /*************************************************************
+    * HEAPIFY
+    * Build a heap in place from a container moved into it
+    *************************************************************/
+   template <class T, class Heap, class Container>
+   void bench_heapify(const std::string & name, const std::vector<T> & keys, size_t reps)
+   {
+      Tally tally;
+      for (size_t rep = 0; rep < reps; rep++)
+      {
+         Container container;
+         container.reserve(keys.size());
+         for (auto & key : keys)
+            container.push_back(key);
+         alignas(Heap) unsigned char buffer[sizeof(Heap)];
+         Heap * q = nullptr;
+         timed<T>(tally, [&]()
+         {
+            q = new (buffer) Heap(CountingLess<T>(), std::move(container));
+         });
+         q->~Heap();
+      }
+      recordTally(name + " heapify", keys.size(), tally, keys.size() * reps, true);
+   }
+
+   /*************************************************************
+    * RANGE
+    * Construct a heap from an iterator range, copying the keys
+    *************************************************************/
+   template <class T, class Heap>
+   void bench_range(const std::string & name, const std::vector<T> & keys, size_t reps)
+   {
+      Tally tally;
+      for (size_t rep = 0; rep < reps; rep++)
+      {
+         alignas(Heap) unsigned char buffer[sizeof(Heap)];
+         Heap * q = nullptr;
+         timed<T>(tally, [&]()
+         {
+            q = new (buffer) Heap(keys.begin(), keys.end(), CountingLess<T>());
+         });
+         q->~Heap();
+      }
+      recordTally(name + " range", keys.size(), tally, keys.size() * reps, true);
+   }
+
+   /*************************************************************
+    * VECTOR
+    * push_back from empty, push_back after reserve, copy
+    * construction (all per element) and move construction
+    * (per move)
+    *************************************************************/
+   template <class T, class Vector>
+   void bench_vector(const std::string & name, const std::vector<T> & keys, size_t reps)
+   {
+      Tally pushBack;
+      Tally reserve;
+      Tally copy;
+      Tally move;
+      for (size_t rep = 0; rep < reps; rep++)
+      {
+         Vector grown;
+         timed<T>(pushBack, [&]()
+         {
+            for (auto & key : keys)
+               grown.push_back(key);
+         });
+
+         Vector reserved;
+         timed<T>(reserve, [&]()
+         {
+            reserved.reserve(keys.size());
+            for (auto & key : keys)
+               reserved.push_back(key);
+         });
+
+         alignas(Vector) unsigned char buffer[sizeof(Vector)];
+         Vector * v = nullptr;
+         timed<T>(copy, [&]()
+         {
+            v = new (buffer) Vector(grown);
+         });
+         v->~Vector();
+
+         timed<T>(move, [&]()
+         {
+            v = new (buffer) Vector(std::move(grown));
+         });
+         v->~Vector();
+      }
+      size_t size = keys.size();
+      recordTally(name + " push_back", size, pushBack, size * reps, false);
+      recordTally(name + " reserve+push_back", size, reserve, size * reps, false);
+      recordTally(name + " copy", size, copy, size * reps, false);
+      recordTally(name + " move", size, move, reps, false);
+   }
+};
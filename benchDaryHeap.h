@@ -0,0 +1,91 @@
+/***********************************************************************
+ * Header:
+ *    BENCH D-ARY HEAP
+ * Summary:
+ *    Push 10^6 random keys, then pop them all: the binary
+ *    priority_queue against 4-ary and 8-ary heaps, with the AVX2
+ *    child selection on and off.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "dary_heap.h"
+#include "priority_queue.h"
+
+#include <string>   // for std::string
+
+class BenchDaryHeap : public Benchmark
+{
+public:
+   void run()
+   {
+      const size_t numKeys = 1000000;
+      bench_binary<uint32_t>("priority_queue<uint32_t>", numKeys);
+      bench_both<uint32_t, 4>("dary_heap<uint32_t, 4>", numKeys);
+      bench_both<uint32_t, 8>("dary_heap<uint32_t, 8>", numKeys);
+      bench_binary<uint64_t>("priority_queue<uint64_t>", numKeys);
+      bench_both<uint64_t, 4>("dary_heap<uint64_t, 4>", numKeys);
+      bench_both<uint64_t, 8>("dary_heap<uint64_t, 8>", numKeys);
+      bench_both<float, 8>("dary_heap<float, 8>", numKeys);
+      bench_both<double, 8>("dary_heap<double, 8>", numKeys);
+      report("DaryHeap");
+   }
+
+   /*************************************************************
+    * BINARY
+    * The existing priority_queue as the baseline
+    *************************************************************/
+   template <class T>
+   void bench_binary(const std::string & name, size_t numKeys)
+   {
+      seed = 32;
+      custom::priority_queue<T> q;
+      double ns = measure(numKeys, [&]()
+      {
+         for (size_t i = 0; i < numKeys; i++)
+            q.push((T)random());
+         while (!q.empty())
+         {
+            consume(q.top());
+            q.pop();
+         }
+      });
+      record(name + " push+pop", numKeys, ns);
+   }
+
+   /*************************************************************
+    * BOTH
+    * The same d-ary heap with the scalar and the AVX2 kernel
+    *************************************************************/
+   template <class T, size_t D>
+   void bench_both(const std::string & name, size_t numKeys)
+   {
+      bool saved = custom::simd::useAvx2();
+      custom::simd::useAvx2() = false;
+      bench_dary<T, D>(name + " scalar", numKeys);
+      custom::simd::useAvx2() = saved;
+      if (saved)
+         bench_dary<T, D>(name + " avx2", numKeys);
+   }
+
+   template <class T, size_t D>
+   void bench_dary(const std::string & name, size_t numKeys)
+   {
+      seed = 32;
+      custom::dary_heap<T, D> q;
+      double ns = measure(numKeys, [&]()
+      {
+         for (size_t i = 0; i < numKeys; i++)
+            q.push((T)random());
+         while (!q.empty())
+         {
+            consume(q.top());
+            q.pop();
+         }
+      });
+      record(name, numKeys, ns);
+   }
+};
@@ -0,0 +1,77 @@
+/***********************************************************************
+ * Header:
+ *    BENCH EXTERNAL PRIORITY QUEUE
+ * Summary:
+ *    Push N uint64_t keys, then pop them all: priority_queue holding
+ *    every key in memory against the external queue with buffers of
+ *    2^14 and 2^17 keys, the rest in sorted runs on disk.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "benchmark.h"
+#include "external_priority_queue.h"
+#include "priority_queue.h"
+
+#include <string>    // for std::to_string
+
+class BenchExternalPQueue : public Benchmark
+{
+public:
+   void run()
+   {
+      size_t numKeys = maxSize();
+      bench_memory(numKeys);
+      bench_external(numKeys, (size_t)1 << 14);
+      bench_external(numKeys, (size_t)1 << 17);
+      report("ExternalPQueue");
+   }
+
+   /*************************************************************
+    * MEMORY
+    * Every key in one heap
+    *************************************************************/
+   void bench_memory(size_t numKeys)
+   {
+      seed = 43;
+      double ns = measure(numKeys, [&]()
+      {
+         custom::priority_queue<uint64_t> q;
+         for (size_t i = 0; i < numKeys; i++)
+            q.push(random());
+         while (!q.empty())
+         {
+            consume(q.top());
+            q.pop();
+         }
+      });
+      record("priority_queue push+pop", numKeys, ns);
+   }
+
+   /*************************************************************
+    * EXTERNAL
+    * BUFFER keys in memory, runs for the rest
+    *************************************************************/
+   void bench_external(size_t numKeys, size_t buffer)
+   {
+      seed = 43;
+      double ns = measure(numKeys, [&]()
+      {
+         custom::external_priority_queue<uint64_t> q(buffer);
+         for (size_t i = 0; i < numKeys; i++)
+            q.push(random());
+         while (!q.empty())
+         {
+            consume(q.top());
+            q.pop();
+         }
+      });
+      record("external, buffer " + std::to_string(buffer) + " push+pop", numKeys, ns);
+   }
+};
+
+#endif // __unix__ || __APPLE__
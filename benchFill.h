@@ -0,0 +1,81 @@
+/***********************************************************************
+ * Header:
+ *    BENCH FILL
+ * Summary:
+ *    Filling the backing store of a priority_queue<uint64_t> with N
+ *    decoded keys before heapifying it: push_back one at a time,
+ *    resize (which zeroes) then overwrite, resize_default_init then
+ *    overwrite, and append_uninitialized with one memcpy.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "priority_queue.h"
+#include "vector.h"
+
+#include <cstring>   // for std::memcpy
+#include <string>    // for std::string
+
+class BenchFill : public Benchmark
+{
+public:
+   void run()
+   {
+      size_t numKeys = maxSize();
+      seed = 46;
+      custom::vector<uint64_t> decoded;
+      decoded.reserve(numKeys);
+      for (size_t i = 0; i < numKeys; i++)
+         decoded.push_back(random());
+
+      bench_fill("push_back", decoded, [](custom::vector<uint64_t> & v, const custom::vector<uint64_t> & src)
+      {
+         v.reserve(src.size());
+         for (size_t i = 0; i < src.size(); i++)
+            v.push_back(src[i]);
+      });
+      bench_fill("resize + write", decoded, [](custom::vector<uint64_t> & v, const custom::vector<uint64_t> & src)
+      {
+         v.resize(src.size());
+         for (size_t i = 0; i < src.size(); i++)
+            v[i] = src[i];
+      });
+      bench_fill("resize_default_init + write", decoded, [](custom::vector<uint64_t> & v, const custom::vector<uint64_t> & src)
+      {
+         v.resize_default_init(src.size());
+         for (size_t i = 0; i < src.size(); i++)
+            v[i] = src[i];
+      });
+      bench_fill("append_uninitialized + memcpy", decoded, [](custom::vector<uint64_t> & v, const custom::vector<uint64_t> & src)
+      {
+         std::memcpy(v.append_uninitialized(src.size()), &src[0], src.size() * sizeof(uint64_t));
+      });
+      report("Fill");
+   }
+
+private:
+   /*************************************************************
+    * FILL
+    * One way of copying the keys in, timed on its own and
+    * then with the heapify that follows
+    *************************************************************/
+   template <class Function>
+   void bench_fill(const std::string & name, const custom::vector<uint64_t> & src, Function fill)
+   {
+      custom::vector<uint64_t> v;
+      double ns = measure(src.size(), [&]() { fill(v, src); });
+      record(name, src.size(), ns);
+
+      custom::vector<uint64_t> w;
+      ns = measure(src.size(), [&]()
+      {
+         fill(w, src);
+         custom::priority_queue<uint64_t> q(std::less<uint64_t>(), std::move(w));
+         consume(q.top());
+      });
+      record(name + " + heapify", src.size(), ns);
+   }
+};
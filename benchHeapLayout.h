@@ -0,0 +1,63 @@
+/***********************************************************************
+ * Header:
+ *    BENCH HEAP LAYOUT
+ * Summary:
+ *    The hold model on priority_queue<uint64_t>: build a heap of N
+ *    random keys, then time 10^6 rounds of pop-the-top, push-a-new-key.
+ *    The breadth-first layout against blocks of about two cache lines
+ *    (3 levels) and of a page (8 levels). 10^8 keys is 800MB, past
+ *    the last-level cache of most machines.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "priority_queue.h"
+#include "heap_layout.h"
+
+#include <string>   // for std::string
+
+class BenchHeapLayout : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t size : { (size_t)1000000, (size_t)100000000 })
+      {
+         bench_hold<custom::implicit_layout>("implicit_layout", size);
+         bench_hold<custom::blocked_layout<3>>("blocked_layout<3>", size);
+         bench_hold<custom::blocked_layout<8>>("blocked_layout<8>", size);
+      }
+      report("HeapLayout");
+   }
+
+   /*************************************************************
+    * HOLD
+    * Pop and push against a heap of a steady size
+    *************************************************************/
+   template <class Layout>
+   void bench_hold(const std::string & name, size_t size)
+   {
+      const size_t numOps = 1000000;
+      seed = 34;
+      custom::vector<uint64_t> keys;
+      keys.reserve(size);
+      for (size_t i = 0; i < size; i++)
+         keys.push_back(random());
+      custom::priority_queue<uint64_t, custom::vector<uint64_t>, std::less<uint64_t>, Layout>
+         q(std::less<uint64_t>(), std::move(keys));
+
+      double ns = measure(numOps, [&]()
+      {
+         for (size_t i = 0; i < numOps; i++)
+         {
+            consume(q.top());
+            q.pop();
+            q.push(random());
+         }
+      });
+      record(name + " pop+push", size, ns);
+   }
+};
@@ -0,0 +1,67 @@
+/***********************************************************************
+ * Header:
+ *    BENCH HUGE PAGES
+ * Summary:
+ *    Pop every key from a priority_queue<uint64_t> of N random keys,
+ *    its vector on std::allocator against huge_page_allocator. Below a
+ *    few megabytes the dTLB covers either; past it, each level of a
+ *    sift-down on 4 KB pages is a page walk.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "benchmark.h"
+#include "huge_page_allocator.h"
+#include "priority_queue.h"
+#include "vector.h"
+
+#include <string>    // for std::string
+
+class BenchHugePages : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t size = (size_t)1 << 16; size < maxSize(); size *= 16)
+         bench_both(size);
+      bench_both(maxSize());
+      report("HugePages");
+   }
+
+private:
+   void bench_both(size_t numKeys)
+   {
+      bench_pop<custom::vector<uint64_t>>("pop, std::allocator", numKeys);
+      bench_pop<custom::vector<uint64_t, custom::huge_page_allocator<uint64_t>>>("pop, huge_page_allocator", numKeys);
+   }
+
+   /*************************************************************
+    * POP
+    * Build the heap untimed, then time draining it. The
+    * shrink policy is off so both pop from the same array.
+    *************************************************************/
+   template <class Container>
+   void bench_pop(const std::string & name, size_t numKeys)
+   {
+      seed = 50;
+      custom::priority_queue<uint64_t, Container> q;
+      q.set_shrink_policy(0);
+      for (size_t i = 0; i < numKeys; i++)
+         q.push(random());
+      double ns = measure(numKeys, [&]()
+      {
+         while (!q.empty())
+         {
+            consume(q.top());
+            q.pop();
+         }
+      });
+      record(name, numKeys, ns);
+   }
+};
+
+#endif // __unix__ || __APPLE__
@@ -0,0 +1,63 @@
+/***********************************************************************
+ * Header:
+ *    BENCH PREFETCH
+ * Summary:
+ *    The hold model (pop the top, push a new key) on heaps of 10^3 to
+ *    10^8 uint64_t keys, with the grandchildren prefetch forced on and
+ *    forced off, to find where it starts to pay. The default thresholds,
+ *    PREFETCH_BYTES in each heap, come from this crossover.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "priority_queue.h"
+#include "dary_heap.h"
+
+#include <string>   // for std::string
+
+class BenchPrefetch : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t size = 1000; size <= 100000000; size *= 10)
+      {
+         bench_hold<custom::priority_queue<uint64_t>>("priority_queue", size, false);
+         bench_hold<custom::priority_queue<uint64_t>>("priority_queue", size, true);
+         bench_hold<custom::dary_heap<uint64_t, 4>>("dary_heap<4>", size, false);
+         bench_hold<custom::dary_heap<uint64_t, 4>>("dary_heap<4>", size, true);
+      }
+      report("Prefetch");
+   }
+
+   /*************************************************************
+    * HOLD
+    * Pop and push against a heap of a steady size
+    *************************************************************/
+   template <class Heap>
+   void bench_hold(const std::string & name, size_t size, bool prefetching)
+   {
+      const size_t numOps = 1000000;
+      seed = 35;
+      custom::vector<uint64_t> keys;
+      keys.reserve(size);
+      for (size_t i = 0; i < size; i++)
+         keys.push_back(random());
+      Heap q(std::less<uint64_t>(), std::move(keys));
+      q.set_prefetch_threshold(prefetching ? 0 : (size_t)-1);
+
+      double ns = measure(numOps, [&]()
+      {
+         for (size_t i = 0; i < numOps; i++)
+         {
+            consume(q.top());
+            q.pop();
+            q.push(random());
+         }
+      });
+      record(name + (prefetching ? " prefetch" : " no prefetch"), size, ns);
+   }
+};
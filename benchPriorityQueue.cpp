@@ -0,0 +1,198 @@
+/***********************************************************************
+ * Program:
+ *    Benchmark
+ * Summary:
+ *    Driver to time the priority queue family of containers
+ *
+ *        pq_bench [--json FILE] [--max-size N] [--trace FILE] [SUITE ...]
+ *
+ *    With no SUITE every benchmark runs; an unknown SUITE is an
+ *    error. --max-size caps the size sweeps (default 10^6, up to
+ *    10^8). --json writes every result to FILE for regression
+ *    tracking. --trace gives Replay a captured heap trace instead of
+ *    its synthetic one.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#include "benchCore.h"         // for the priority_queue and vector benchmarks
+#include "benchTimerWheel.h"    // for the timer wheel benchmarks
+#include "benchRadixHeap.h"     // for the radix heap benchmarks
+#include "benchBucketQueue.h"   // for the bucket queue benchmarks
+#include "benchStablePriorityQueue.h" // for the stable priority queue benchmarks
+#include "benchBoundedPriorityQueue.h" // for the bounded priority queue benchmarks
+#include "benchDaryHeap.h"      // for the d-ary heap benchmarks
+#include "benchSplitPriorityQueue.h" // for the split priority queue benchmarks
+#include "benchHeapLayout.h"    // for the heap layout benchmarks
+#include "benchPrefetch.h"      // for the prefetch benchmarks
+#include "benchBranchless.h"    // for the branchless sift benchmarks
+#include "benchReplay.h"        // for replaying heap traces
+#include "benchConcurrentSpy.h" // for the cost of counting across threads
+#include "benchAllocation.h"    // for the memory the queues cost
+#include "benchExternalPriorityQueue.h" // for the queue with runs on disk
+#include "benchSerialize.h"     // for restoring a saved queue
+#include "benchFill.h"          // for filling a backing store in bulk
+#include "benchHugePages.h"     // for heaps on 2 MB pages
+
+#include <cstddef>   // for std::max_align_t
+#include <cstdlib>   // for std::malloc, posix_memalign, std::strtoull
+#include <cstring>   // for std::strcmp
+#include <fstream>   // for std::ofstream
+#include <functional> // for std::function
+#include <iostream>  // for std::cerr
+#include <new>       // for std::bad_alloc, std::nothrow_t, std::align_val_t
+#include <utility>   // for std::pair
+
+int Spy::counters[] = {};
+
+/**********************************************************************
+ * OPERATOR NEW AND DELETE
+ * Count every allocation for the allocations/op column. Every form is
+ * replaced, so each new is paired with its own delete. None of them
+ * is inlined, so the compiler never sees a free() of memory that came
+ * from new.
+ ***********************************************************************/
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+   // malloc, or an aligned block for the over-aligned forms; nullptr when out of memory
+   BENCH_NOINLINE void * allocate(size_t size, size_t alignment) noexcept
+   {
+      Benchmark::allocations()++;
+      if (size == 0)
+         size = 1;
+      if (alignment <= alignof(std::max_align_t))
+         return std::malloc(size);
+#if defined(_MSC_VER)
+      return _aligned_malloc(size, alignment);
+#else
+      void * p = nullptr;
+      return posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+#endif
+   }
+   BENCH_NOINLINE void release(void * p, size_t alignment) noexcept
+   {
+#if defined(_MSC_VER)
+      if (alignment > alignof(std::max_align_t))
+      {
+         _aligned_free(p);
+         return;
+      }
+#else
+      (void)alignment;
+#endif
+      std::free(p);
+   }
+   void * allocateOrThrow(size_t size, size_t alignment)
+   {
+      void * p = allocate(size, alignment);
+      if (!p)
+         throw std::bad_alloc();
+      return p;
+   }
+}
+
+BENCH_NOINLINE void * operator new  (size_t size) { return allocateOrThrow(size, 0); }
+BENCH_NOINLINE void * operator new[](size_t size) { return allocateOrThrow(size, 0); }
+BENCH_NOINLINE void * operator new  (size_t size, const std::nothrow_t &) noexcept { return allocate(size, 0); }
+BENCH_NOINLINE void * operator new[](size_t size, const std::nothrow_t &) noexcept { return allocate(size, 0); }
+BENCH_NOINLINE void operator delete  (void * p) noexcept         { release(p, 0); }
+BENCH_NOINLINE void operator delete[](void * p) noexcept         { release(p, 0); }
+BENCH_NOINLINE void operator delete  (void * p, size_t) noexcept { release(p, 0); }
+BENCH_NOINLINE void operator delete[](void * p, size_t) noexcept { release(p, 0); }
+BENCH_NOINLINE void operator delete  (void * p, const std::nothrow_t &) noexcept { release(p, 0); }
+BENCH_NOINLINE void operator delete[](void * p, const std::nothrow_t &) noexcept { release(p, 0); }
+
+BENCH_NOINLINE void * operator new  (size_t size, std::align_val_t a) { return allocateOrThrow(size, (size_t)a); }
+BENCH_NOINLINE void * operator new[](size_t size, std::align_val_t a) { return allocateOrThrow(size, (size_t)a); }
+BENCH_NOINLINE void * operator new  (size_t size, std::align_val_t a, const std::nothrow_t &) noexcept { return allocate(size, (size_t)a); }
+BENCH_NOINLINE void * operator new[](size_t size, std::align_val_t a, const std::nothrow_t &) noexcept { return allocate(size, (size_t)a); }
+BENCH_NOINLINE void operator delete  (void * p, std::align_val_t a) noexcept         { release(p, (size_t)a); }
+BENCH_NOINLINE void operator delete[](void * p, std::align_val_t a) noexcept         { release(p, (size_t)a); }
+BENCH_NOINLINE void operator delete  (void * p, size_t, std::align_val_t a) noexcept { release(p, (size_t)a); }
+BENCH_NOINLINE void operator delete[](void * p, size_t, std::align_val_t a) noexcept { release(p, (size_t)a); }
+BENCH_NOINLINE void operator delete  (void * p, std::align_val_t a, const std::nothrow_t &) noexcept { release(p, (size_t)a); }
+BENCH_NOINLINE void operator delete[](void * p, std::align_val_t a, const std::nothrow_t &) noexcept { release(p, (size_t)a); }
+
+/**********************************************************************
+ * MAIN
+ * Run the benchmarks named on the command line, or all of them,
+ * and print the results
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   const std::pair<const char *, std::function<void()>> suites[] =
+   {
+      { "Core",          []() { BenchCore().run();          } },
+      { "TimerWheel",    []() { BenchTimerWheel().run();    } },
+      { "RadixHeap",     []() { BenchRadixHeap().run();     } },
+      { "BucketQueue",   []() { BenchBucketQueue().run();   } },
+      { "StablePQueue",  []() { BenchStablePQueue().run();  } },
+      { "BoundedPQueue", []() { BenchBoundedPQueue().run(); } },
+      { "DaryHeap",      []() { BenchDaryHeap().run();      } },
+      { "SplitPQueue",   []() { BenchSplitPQueue().run();   } },
+      { "HeapLayout",    []() { BenchHeapLayout().run();    } },
+      { "Prefetch",      []() { BenchPrefetch().run();      } },
+      { "Branchless",    []() { BenchBranchless().run();    } },
+      { "Replay",        []() { BenchReplay().run();        } },
+      { "ConcurrentSpy", []() { BenchConcurrentSpy().run(); } },
+      { "Allocation",    []() { BenchAllocation().run();    } },
+      { "Serialize",     []() { BenchSerialize().run();     } },
+      { "Fill",          []() { BenchFill().run();          } },
+#if defined(__unix__) || defined(__APPLE__)
+      { "ExternalPQueue", []() { BenchExternalPQueue().run(); } },
+      { "HugePages",     []() { BenchHugePages().run();     } },
+#endif
+   };
+
+   const char * jsonFile = nullptr;
+   std::vector<const char *> chosen;
+   for (int i = 1; i < argc; i++)
+   {
+      if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+         jsonFile = argv[++i];
+      else if (std::strcmp(argv[i], "--max-size") == 0 && i + 1 < argc)
+         Benchmark::maxSize() = (size_t)std::strtoull(argv[++i], nullptr, 10);
+      else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+         BenchReplay::traceFile() = argv[++i];
+      else
+         chosen.push_back(argv[i]);
+   }
+
+   for (const char * name : chosen)
+   {
+      bool known = false;
+      for (auto & suite : suites)
+         known = known || std::strcmp(name, suite.first) == 0;
+      if (!known)
+      {
+         std::cerr << "pq_bench: unknown suite " << name << "; the suites are:";
+         for (auto & suite : suites)
+            std::cerr << " " << suite.first;
+         std::cerr << "\n";
+         return 1;
+      }
+   }
+
+   for (auto & suite : suites)
+   {
+      bool run = chosen.empty();
+      for (const char * name : chosen)
+         run = run || std::strcmp(name, suite.first) == 0;
+      if (run)
+         suite.second();
+   }
+
+   if (jsonFile)
+   {
+      std::ofstream out(jsonFile);
+      Benchmark::writeJson(out);
+   }
+
+   return 0;
+}
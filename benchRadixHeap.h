@@ -0,0 +1,62 @@
+/***********************************************************************
+ * Header:
+ *    BENCH RADIX HEAP
+ * Summary:
+ *    Radix heap against a binary heap on a monotone workload: pop the
+ *    smallest key and push a replacement a random distance beyond it,
+ *    as Dijkstra and event simulation do.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "radix_heap.h"
+#include "priority_queue.h"
+
+#include <functional>   // for std::greater
+
+class BenchRadixHeap : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t numKeys : { (size_t)1000, (size_t)100000, (size_t)1000000 })
+      {
+         bench_monotone<custom::radix_heap<uint32_t>>("radix_heap", numKeys);
+         bench_monotone<custom::priority_queue<uint32_t, custom::vector<uint32_t>,
+                                               std::greater<uint32_t>>>("priority_queue (binary heap)", numKeys);
+      }
+      report("RadixHeap");
+   }
+
+   /*************************************************************
+    * MONOTONE
+    * Hold numKeys keys and run 10^7 operations (a pop and a push
+    * per step), each new key a random distance past the last pop.
+    *************************************************************/
+   template <class Queue>
+   void bench_monotone(const char * name, size_t numKeys)
+   {
+      const uint32_t maxWeight = 1000;
+      const size_t numOps = 10000000;
+
+      seed = 7;
+      Queue q;
+      for (size_t i = 0; i < numKeys; i++)
+         q.push((uint32_t)(random() % maxWeight));
+
+      double ns = measure(numOps, [&]()
+      {
+         for (size_t i = 0; i < numOps / 2; i++)
+         {
+            uint32_t k = q.top();
+            q.pop();
+            q.push(k + 1 + (uint32_t)(random() % maxWeight));
+         }
+      });
+      consume(q.top());
+      record(name, numKeys, ns);
+   }
+};
@@ -0,0 +1,206 @@
+/***********************************************************************
+ * Header:
+ *    BENCH REPLAY
+ * Summary:
+ *    Replay a heap trace (see heap_trace.h) against the heaps in the
+ *    project, so backends can be compared on the same captured
+ *    workload. The trace is decoded before the clock starts. Give one
+ *    with pq_bench --trace FILE; without one a synthetic, timer-like
+ *    trace is recorded through recording_priority_queue: bursts of
+ *    deadlines a little past "now", drained in bursts.
+ *
+ *    The min-first queues (timer_wheel, radix_heap) see each key as
+ *    UINT64_MAX - key, so they pop in the trace's order. radix_heap is
+ *    run only when the trace is monotone for it: no key pushed above
+ *    the last one seen by top or pop. split_priority_queue carries the
+ *    key as its own payload.
+ *
+ *    Out of scope: bucket_queue, whose priorities are a small range
+ *    and not 64-bit keys; bounded_priority_queue, which drops all but
+ *    its best K and so would not serve the trace's pops;
+ *    packed_stable_priority_queue, which cannot hold a 64-bit key; and
+ *    the external and mmap-backed queues, which measure the disk.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "heap_trace.h"
+#include "priority_queue.h"
+#include "dary_heap.h"
+#include "minmax_heap.h"
+#include "radix_heap.h"
+#include "split_priority_queue.h"
+#include "stable_priority_queue.h"
+#include "timer_wheel.h"
+
+#include <fstream>   // for std::ifstream
+#include <iostream>  // for std::cerr
+#include <queue>     // for std::priority_queue
+#include <sstream>   // for std::stringstream
+#include <string>    // for std::string
+
+class BenchReplay : public Benchmark
+{
+public:
+   // the trace to replay; empty for the synthetic one
+   static std::string & traceFile()
+   {
+      static std::string file;
+      return file;
+   }
+
+   void run()
+   {
+      custom::vector<Record> trace;
+      if (traceFile().empty())
+      {
+         std::stringstream stream;
+         synthesize(stream, 1000000);
+         decode(stream, trace);
+      }
+      else
+      {
+         std::ifstream file(traceFile(), std::ios::binary);
+         if (!file)
+         {
+            std::cerr << "BenchReplay: cannot open " << traceFile() << "\n";
+            return;
+         }
+         decode(file, trace);
+      }
+
+      bench_replay<custom::priority_queue<uint64_t>>("priority_queue", trace);
+      bench_replay<custom::priority_queue<uint64_t, custom::vector<uint64_t>, std::less<uint64_t>,
+                                          custom::blocked_layout<3>>>("priority_queue blocked<3>", trace);
+      bench_replay<custom::dary_heap<uint64_t, 4>>("dary_heap<4>", trace);
+      bench_replay<custom::dary_heap<uint64_t, 8>>("dary_heap<8>", trace);
+      bench_replay<custom::minmax_heap<uint64_t>>("minmax_heap", trace);
+      bench_replay<custom::stable_priority_queue<uint64_t>>("stable_priority_queue", trace);
+      bench_replay<SplitHeap>("split_priority_queue", trace);
+      bench_replay<custom::timer_wheel<uint64_t, Inverted>>("timer_wheel", trace);
+      if (monotone(trace))
+         bench_replay<custom::radix_heap<uint64_t, Inverted>>("radix_heap", trace);
+      bench_replay<std::priority_queue<uint64_t>>("std::priority_queue", trace);
+      report("Replay");
+   }
+
+private:
+   struct Record
+   {
+      custom::trace_op op;
+      uint64_t key;
+   };
+
+   // the largest key first, for the queues that put the smallest on top
+   struct Inverted
+   {
+      uint64_t operator () (uint64_t key) const { return UINT64_MAX - key; }
+   };
+
+   // split_priority_queue with the key as the payload
+   struct SplitHeap
+   {
+      custom::split_priority_queue<uint64_t, uint64_t> q;
+      const uint64_t & top() const     { return q.top(); }
+      void push(uint64_t key)          { q.push(key, key); }
+      void pop()                       { q.pop(); }
+      bool empty() const               { return q.empty(); }
+   };
+
+   /*************************************************************
+    * DECODE
+    * The whole trace into memory
+    *************************************************************/
+   static void decode(std::istream & in, custom::vector<Record> & trace)
+   {
+      custom::trace_reader reader(in);
+      Record record = { custom::trace_op::POP, 0 };
+      while (reader.next(record.op, record.key))
+         trace.push_back(record);
+   }
+
+   /*************************************************************
+    * SYNTHESIZE
+    * About NUM_OPS operations of a timer-like workload
+    *************************************************************/
+   void synthesize(std::ostream & out, size_t numOps)
+   {
+      seed = 38;
+      custom::trace_writer writer(out);
+      custom::recording_priority_queue<uint64_t> pq(writer);
+      uint64_t now = 0;
+      for (size_t ops = 0; ops < numOps; )
+      {
+         size_t burst = 1 + random() % 64;
+         bool pushing = pq.size() < 1000 || (pq.size() < 100000 && random() % 2);
+         for (size_t i = 0; i < burst; i++, ops++)
+         {
+            if (pushing)
+               pq.push(UINT64_MAX - (now + random() % 100000));
+            else
+            {
+               now = UINT64_MAX - pq.top();
+               pq.pop();
+            }
+         }
+      }
+   }
+
+   /*************************************************************
+    * MONOTONE
+    * Does every push stay at or below the last key seen
+    * by top or pop, as radix_heap requires?
+    *************************************************************/
+   static bool monotone(const custom::vector<Record> & trace)
+   {
+      custom::priority_queue<uint64_t> q;
+      uint64_t ceiling = UINT64_MAX;
+      for (size_t i = 0; i < trace.size(); i++)
+      {
+         const Record & record = trace[i];
+         if (record.op == custom::trace_op::PUSH)
+         {
+            if (record.key > ceiling)
+               return false;
+            q.push(record.key);
+         }
+         else if (!q.empty())
+         {
+            ceiling = q.top();
+            if (record.op == custom::trace_op::POP)
+               q.pop();
+         }
+      }
+      return true;
+   }
+
+   /*************************************************************
+    * REPLAY
+    * Every operation of the trace; pop and top on an empty
+    * heap are skipped, as the recorder would not log them
+    *************************************************************/
+   template <class Heap>
+   void bench_replay(const std::string & name, const custom::vector<Record> & trace)
+   {
+      Heap q;
+      double ns = measure(trace.size(), [&]()
+      {
+         for (size_t i = 0; i < trace.size(); i++)
+         {
+            const Record & record = trace[i];
+            if (record.op == custom::trace_op::PUSH)
+               q.push(record.key);
+            else if (!q.empty())
+            {
+               consume(q.top());
+               if (record.op == custom::trace_op::POP)
+                  q.pop();
+            }
+         }
+      });
+      record(name, trace.size(), ns);
+   }
+};
@@ -0,0 +1,123 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SERIALIZE
+ * Summary:
+ *    Getting a priority_queue of N uint64_t keys back after a restart:
+ *    pushing every key again, heapifying them, and deserializing the
+ *    saved heap from memory and from a file. Saving is timed too.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "priority_queue.h"
+#include "serialize.h"
+#include "vector.h"
+
+#include <cstdio>    // for std::tmpfile
+#include <sstream>   // for std::stringstream
+
+class BenchSerialize : public Benchmark
+{
+public:
+   void run()
+   {
+      size_t numKeys = maxSize();
+      seed = 44;
+      custom::vector<uint64_t> keys;
+      for (size_t i = 0; i < numKeys; i++)
+         keys.push_back(random());
+      custom::priority_queue<uint64_t> saved{ std::less<uint64_t>(), custom::vector<uint64_t>(keys) };
+
+      bench_push(keys);
+      bench_heapify(keys);
+      bench_stream(saved);
+#if defined(__unix__) || defined(__APPLE__)
+      bench_fd(saved);
+#endif
+      report("Serialize");
+   }
+
+private:
+   /*************************************************************
+    * PUSH
+    * What a restart does today
+    *************************************************************/
+   void bench_push(const custom::vector<uint64_t> & keys)
+   {
+      double ns = measure(keys.size(), [&]()
+      {
+         custom::priority_queue<uint64_t> q;
+         for (size_t i = 0; i < keys.size(); i++)
+            q.push(keys[i]);
+         consume(q.top());
+      });
+      record("restore by push", keys.size(), ns);
+   }
+
+   /*************************************************************
+    * HEAPIFY
+    * The keys are there, in no order
+    *************************************************************/
+   void bench_heapify(const custom::vector<uint64_t> & keys)
+   {
+      double ns = measure(keys.size(), [&]()
+      {
+         custom::vector<uint64_t> copy(keys);
+         custom::priority_queue<uint64_t> q(std::less<uint64_t>(), std::move(copy));
+         consume(q.top());
+      });
+      record("restore by heapify", keys.size(), ns);
+   }
+
+   /*************************************************************
+    * STREAM
+    * Save to and load from memory
+    *************************************************************/
+   void bench_stream(const custom::priority_queue<uint64_t> & saved)
+   {
+      std::stringstream stream;
+      double ns = measure(saved.size(), [&]()
+      {
+         custom::serialize(stream, saved);
+      });
+      record("serialize to stringstream", saved.size(), ns);
+
+      ns = measure(saved.size(), [&]()
+      {
+         custom::priority_queue<uint64_t> q;
+         custom::deserialize(stream, q);
+         consume(q.top());
+      });
+      record("deserialize from stringstream", saved.size(), ns);
+   }
+
+#if defined(__unix__) || defined(__APPLE__)
+   /*************************************************************
+    * FD
+    * Save to and load from a file (in the page cache)
+    *************************************************************/
+   void bench_fd(const custom::priority_queue<uint64_t> & saved)
+   {
+      std::FILE * file = std::tmpfile();
+      int fd = fileno(file);
+      double ns = measure(saved.size(), [&]()
+      {
+         custom::serialize(fd, saved);
+      });
+      record("serialize to file", saved.size(), ns);
+
+      lseek(fd, 0, SEEK_SET);
+      ns = measure(saved.size(), [&]()
+      {
+         custom::priority_queue<uint64_t> q;
+         custom::deserialize(fd, q);
+         consume(q.top());
+      });
+      record("deserialize from file", saved.size(), ns);
+      std::fclose(file);
+   }
+#endif
+};
@@ -0,0 +1,95 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SPLIT PRIORITY QUEUE
+ * Summary:
+ *    Push N records of a uint64_t key and a 120-byte payload, then pop
+ *    them all: priority_queue of whole records against the split queue
+ *    that keeps the payloads out of the heap.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "split_priority_queue.h"
+#include "priority_queue.h"
+
+class BenchSplitPQueue : public Benchmark
+{
+   // the payload carried by every record
+   struct Payload
+   {
+      uint64_t words[15];
+   };
+
+   // key and payload together, as priority_queue has to hold them
+   struct Record
+   {
+      uint64_t key;
+      Payload  payload;
+      bool operator < (const Record & rhs) const { return key < rhs.key; }
+   };
+
+public:
+   void run()
+   {
+      for (size_t numRecords : { (size_t)10000, (size_t)1000000, (size_t)4000000 })
+      {
+         bench_whole(numRecords);
+         bench_split(numRecords);
+      }
+      report("SplitPQueue");
+   }
+
+   /*************************************************************
+    * WHOLE
+    * Every sift moves 128-byte records
+    *************************************************************/
+   void bench_whole(size_t numRecords)
+   {
+      seed = 33;
+      custom::priority_queue<Record> q;
+      double ns = measure(numRecords, [&]()
+      {
+         for (size_t i = 0; i < numRecords; i++)
+         {
+            Record r;
+            r.key = random();
+            r.payload.words[0] = i;
+            q.push(r);
+         }
+         while (!q.empty())
+         {
+            consume(q.top().payload.words[0]);
+            q.pop();
+         }
+      });
+      record("priority_queue<Record> push+pop", numRecords, ns);
+   }
+
+   /*************************************************************
+    * SPLIT
+    * Every sift moves a key and a slot
+    *************************************************************/
+   void bench_split(size_t numRecords)
+   {
+      seed = 33;
+      custom::split_priority_queue<uint64_t, Payload> q;
+      double ns = measure(numRecords, [&]()
+      {
+         for (size_t i = 0; i < numRecords; i++)
+         {
+            Payload p;
+            p.words[0] = i;
+            q.push(random(), p);
+         }
+         while (!q.empty())
+         {
+            consume(q.top().words[0]);
+            q.pop();
+         }
+      });
+      record("split_priority_queue push+pop", numRecords, ns);
+   }
+};
@@ -0,0 +1,94 @@
+/***********************************************************************
+ * Header:
+ *    BENCH STABLE PRIORITY QUEUE
+ * Summary:
+ *    Three ways to get FIFO among equal priorities: the caller wrapping
+ *    each key in {priority, sequence}, stable_priority_queue, and
+ *    packed_stable_priority_queue. 256 distinct priorities, so ties
+ *    are common.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "stable_priority_queue.h"
+
+class BenchStablePQueue : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t numKeys : { (size_t)1000, (size_t)1000000 })
+      {
+         bench_wrapper(numKeys);
+         bench_stable<custom::stable_priority_queue<uint32_t>>("stable_priority_queue", numKeys);
+         bench_stable<custom::packed_stable_priority_queue<uint32_t>>("packed_stable_priority_queue", numKeys);
+      }
+      report("StablePQueue");
+   }
+
+   // what callers do today: 16 bytes per entry, two compares per step
+   struct Wrapped
+   {
+      uint32_t priority;
+      uint64_t sequence;
+      bool operator < (const Wrapped & rhs) const
+      {
+         if (priority != rhs.priority)
+            return priority < rhs.priority;
+         return sequence > rhs.sequence;
+      }
+   };
+
+   /*************************************************************
+    * WRAPPER
+    * priority_queue of {priority, sequence}
+    *************************************************************/
+   void bench_wrapper(size_t numKeys)
+   {
+      const size_t numOps = numKeys * 4;
+      uint64_t sequence = 0;
+      seed = 11;
+      custom::priority_queue<Wrapped> q;
+      for (size_t i = 0; i < numKeys; i++)
+         q.push(Wrapped{ (uint32_t)(random() % 256), sequence++ });
+
+      double ns = measure(numOps, [&]()
+      {
+         for (size_t i = 0; i < numOps; i++)
+         {
+            consume(q.top().priority);
+            q.pop();
+            q.push(Wrapped{ (uint32_t)(random() % 256), sequence++ });
+         }
+      });
+      record("priority_queue of {priority, sequence}", numKeys, ns);
+   }
+
+   /*************************************************************
+    * STABLE
+    * The same workload through one of the stable queues
+    *************************************************************/
+   template <class Queue>
+   void bench_stable(const char * name, size_t numKeys)
+   {
+      const size_t numOps = numKeys * 4;
+      seed = 11;
+      Queue q;
+      for (size_t i = 0; i < numKeys; i++)
+         q.push((uint32_t)(random() % 256));
+
+      double ns = measure(numOps, [&]()
+      {
+         for (size_t i = 0; i < numOps; i++)
+         {
+            consume(q.top());
+            q.pop();
+            q.push((uint32_t)(random() % 256));
+         }
+      });
+      record(name, numKeys, ns);
+   }
+};
@@ -0,0 +1,98 @@
+/***********************************************************************
+ * Header:
+ *    BENCH TIMER WHEEL
+ * Summary:
+ *    Timer wheel against a binary heap on a timer workload: a fixed
+ *    population of timers where each expiry schedules a new one a
+ *    random delay after the current time. Then the same with most
+ *    delays short among a few long ones, so new deadlines keep landing
+ *    before the wheel's cursor.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "timer_wheel.h"
+#include "priority_queue.h"
+
+#include <functional>   // for std::greater
+
+class BenchTimerWheel : public Benchmark
+{
+public:
+   void run()
+   {
+      for (size_t numTimers : { (size_t)1000, (size_t)1000000 })
+      {
+         bench_steadyState<custom::timer_wheel<uint64_t>>("timer_wheel", numTimers);
+         bench_steadyState<custom::priority_queue<uint64_t, custom::vector<uint64_t>,
+                                                  std::greater<uint64_t>>>("priority_queue (binary heap)", numTimers);
+         bench_mixedDelays<custom::timer_wheel<uint64_t>>("timer_wheel, mixed delays", numTimers);
+         bench_mixedDelays<custom::priority_queue<uint64_t, custom::vector<uint64_t>,
+                                                  std::greater<uint64_t>>>("priority_queue, mixed delays", numTimers);
+      }
+      report("TimerWheel");
+   }
+
+   /*************************************************************
+    * STEADY STATE
+    * Load numTimers timers, then expire the earliest and schedule
+    * a replacement numTimers times over.
+    *************************************************************/
+   template <class Queue>
+   void bench_steadyState(const char * name, size_t numTimers)
+   {
+      const uint64_t maxDelay = 1 << 20;
+      const size_t numOps = numTimers * 4;
+
+      seed = 1;
+      Queue q;
+      for (size_t i = 0; i < numTimers; i++)
+         q.push(1 + random() % maxDelay);
+
+      double ns = measure(numOps, [&]()
+      {
+         for (size_t i = 0; i < numOps; i++)
+         {
+            uint64_t now = q.top();
+            q.pop();
+            q.push(now + 1 + random() % maxDelay);
+         }
+      });
+      consume(q.top());
+      record(name, numTimers, ns);
+   }
+
+   /*************************************************************
+    * MIXED DELAYS
+    * Load numTimers long timers, then push a timer per tick of
+    * the clock, seven in eight of them short, and expire
+    * whatever is due.
+    *************************************************************/
+   template <class Queue>
+   void bench_mixedDelays(const char * name, size_t numTimers)
+   {
+      const uint64_t longDelay = 1 << 24;
+      const size_t numOps = numTimers * 4;
+
+      seed = 1;
+      Queue q;
+      for (size_t i = 0; i < numTimers; i++)
+         q.push(longDelay + random() % longDelay);
+
+      double ns = measure(numOps, [&]()
+      {
+         for (uint64_t now = 0; now < numOps; now++)
+         {
+            uint64_t r = random();
+            q.push(now + 1 + ((r & 7) ? r % 64 : r % longDelay));
+            while (q.top() <= now)
+               q.pop();
+         }
+      });
+      consume(q.top());
+      record(name, numTimers, ns);
+   }
+};
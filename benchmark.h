@@ -0,0 +1,182 @@
+/***********************************************************************
+ * Header:
+ *    BENCHMARK
+ * Summary:
+ *    The base class to all the benchmark classes. Times a workload,
+ *    collects the results, and prints them as a table. Every result
+ *    reported is also kept for the whole run so the driver can write
+ *    them all out as JSON for regression tracking.
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstdint>   // for uint64_t
+#include <iostream>  // for std::cout
+#include <iomanip>   // for std::setw
+#include <ostream>   // for std::ostream
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+class Benchmark
+{
+public:
+   Benchmark() : seed(0x9E3779B97F4A7C15ULL), sink(0) { }
+
+   /*************************************************************
+    * ALLOCATIONS
+    * Calls to the global operator new so far. The driver
+    * replaces operator new to count them.
+    *************************************************************/
+   static uint64_t & allocations()
+   {
+      static uint64_t count = 0;
+      return count;
+   }
+
+   /*************************************************************
+    * MAX SIZE
+    * The largest container a sweep over sizes should build
+    *************************************************************/
+   static size_t & maxSize()
+   {
+      static size_t size = 1000000;
+      return size;
+   }
+
+   /*************************************************************
+    * WRITE JSON
+    * Every result reported so far, by every benchmark
+    *************************************************************/
+   static void writeJson(std::ostream & out)
+   {
+      out << "{\n  \"benchmarks\": [";
+      const char * separator = "\n";
+      for (auto & result : history())
+      {
+         out << separator
+             << "    { \"suite\": \"" << escape(result.suite)
+             << "\", \"name\": \"" << escape(result.name)
+             << "\", \"size\": " << result.size
+             << ", \"ns_per_op\": " << result.nsPerOp;
+         if (result.comparisonsPerOp >= 0.0)
+            out << ", \"comparisons_per_op\": " << result.comparisonsPerOp;
+         if (result.allocationsPerOp >= 0.0)
+            out << ", \"allocations_per_op\": " << result.allocationsPerOp;
+         out << " }";
+         separator = ",\n";
+      }
+      out << "\n  ]\n}\n";
+   }
+
+private:
+   // one row of the report. A negative count was not measured.
+   struct Result
+   {
+      std::string suite;
+      std::string name;
+      size_t      size;
+      double      nsPerOp;
+      double      comparisonsPerOp;
+      double      allocationsPerOp;
+   };
+
+   std::vector<Result> results;
+
+   // every result of the run, for the JSON
+   static std::vector<Result> & history()
+   {
+      static std::vector<Result> all;
+      return all;
+   }
+
+   static std::string escape(const std::string & text)
+   {
+      std::string escaped;
+      for (char c : text)
+      {
+         if (c == '"' || c == '\\')
+            escaped += '\\';
+         escaped += c;
+      }
+      return escaped;
+   }
+
+protected:
+   /*************************************************************
+    * MEASURE
+    * Run the workload once and return nanoseconds per operation
+    *************************************************************/
+   template <class Function>
+   double measure(size_t numOps, Function f)
+   {
+      auto begin = std::chrono::steady_clock::now();
+      f();
+      auto end = std::chrono::steady_clock::now();
+      double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+      return numOps == 0 ? ns : ns / (double)numOps;
+   }
+
+   /*************************************************************
+    * RECORD
+    * Remember a result for the report
+    *************************************************************/
+   void record(const std::string & name, size_t size, double nsPerOp,
+               double comparisonsPerOp = -1.0, double allocationsPerOp = -1.0)
+   {
+      results.push_back(Result{std::string(), name, size, nsPerOp,
+                               comparisonsPerOp, allocationsPerOp});
+   }
+
+   /*************************************************************
+    * REPORT
+    * Print every result collected so far
+    *************************************************************/
+   void report(const char * name)
+   {
+      std::cout << name << ":\n";
+      std::cout.setf(std::ios::fixed | std::ios::showpoint);
+      std::cout.precision(2);
+      for (auto & result : results)
+      {
+         std::cout << "\t" << std::left << std::setw(40) << result.name
+                   << std::right << std::setw(12) << result.size
+                   << std::setw(12) << result.nsPerOp << " ns/op";
+         if (result.comparisonsPerOp >= 0.0)
+            std::cout << std::setw(10) << result.comparisonsPerOp << " cmp/op";
+         if (result.allocationsPerOp >= 0.0)
+            std::cout << std::setw(10) << result.allocationsPerOp << " alloc/op";
+         std::cout << "\n";
+         result.suite = name;
+         history().push_back(result);
+      }
+      results.clear();
+   }
+
+   /*************************************************************
+    * RANDOM
+    * A fast, repeatable pseudo-random number (splitmix64)
+    *************************************************************/
+   uint64_t random()
+   {
+      uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+   }
+
+   /*************************************************************
+    * CONSUME
+    * Fold a value into the sink so the optimizer keeps the work
+    *************************************************************/
+   template <class T>
+   void consume(const T & t)
+   {
+      sink = sink + (uint64_t)t;
+   }
+
+   uint64_t seed;            // state for random()
+   volatile uint64_t sink;   // results nobody reads
+};
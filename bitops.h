@@ -0,0 +1,73 @@
+/***********************************************************************
+ * Header:
+ *    BIT OPERATIONS
+ * Summary:
+ *    Portable find-first-set / find-last-set helpers used by the
+ *    integer-keyed queues (timer wheel, radix heap, bucket queue).
+ *
+ *    This will contain the definitions of:
+ *        countTrailingZeros     : index of the lowest set bit
+ *        countLeadingZeros      : number of zero bits above the highest set bit
+ *        highestBit             : index of the highest set bit
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace custom
+{
+namespace bits
+{
+
+/*****************************************
+ * COUNT TRAILING ZEROS
+ * Index of the lowest set bit. The value must not be zero.
+ ****************************************/
+inline int countTrailingZeros(uint64_t value)
+{
+   assert(value != 0);
+#ifdef _MSC_VER
+   unsigned long index;
+   _BitScanForward64(&index, value);
+   return (int)index;
+#else
+   return __builtin_ctzll(value);
+#endif
+}
+
+/*****************************************
+ * COUNT LEADING ZEROS
+ * Number of zero bits above the highest set bit. The value
+ * must not be zero.
+ ****************************************/
+inline int countLeadingZeros(uint64_t value)
+{
+   assert(value != 0);
+#ifdef _MSC_VER
+   unsigned long index;
+   _BitScanReverse64(&index, value);
+   return 63 - (int)index;
+#else
+   return __builtin_clzll(value);
+#endif
+}
+
+/*****************************************
+ * HIGHEST BIT
+ * Index of the highest set bit. The value must not be zero.
+ ****************************************/
+inline int highestBit(uint64_t value)
+{
+   return 63 - countLeadingZeros(value);
+}
+
+} // namespace bits
+} // namespace custom
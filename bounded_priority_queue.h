@@ -0,0 +1,237 @@
+/***********************************************************************
+ * Header:
+ *    BOUNDED PRIORITY QUEUE
+ * Summary:
+ *    Keep the best K elements of a stream. The K slots are reserved
+ *    up front and never reallocated. The retained elements are kept
+ *    in a heap with the worst of them on top, so once the queue is
+ *    full, offer() costs one comparison for an element that does not
+ *    make the cut and one replace-top for one that does.
+ *
+ *    "Best" follows priority_queue: with std::less the largest
+ *    elements are kept.
+ *
+ *    This will contain the class definition of:
+ *        bounded_priority_queue : A class that represents a top-K heap
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <functional>   // std::less
+#include <stdexcept>    // std::out_of_range
+#include <utility>      // std::swap, std::move
+#include "vector.h"     // for the fixed-capacity storage
+
+class TestBoundedPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * BOUNDED PRIORITY QUEUE
+ * The best K offered elements. top() is the worst of
+ * them: the one the next better offer will evict.
+ *************************************************/
+template <class T, class Compare = std::less<T>>
+class bounded_priority_queue
+{
+   friend class ::TestBoundedPQueue; // give the unit test class access to the privates
+   template <class TT, class CCompare>
+   friend void swap(bounded_priority_queue<TT, CCompare>& lhs, bounded_priority_queue<TT, CCompare>& rhs);
+
+public:
+
+   //
+   // construct
+   //
+   bounded_priority_queue(size_t k, const Compare & c = Compare()) : numCapacity(k), compare(c)
+   {
+      container.reserve(numCapacity);
+   }
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   bool offer(const T & t);
+   bool offer(T && t);
+
+   //
+   // Remove
+   //
+   void pop();
+   custom::vector<T> drain_sorted();
+
+   //
+   // Status
+   //
+   size_t size()     const { return container.size(); }
+   size_t capacity() const { return numCapacity;      }
+   bool   empty()    const { return size() == 0;      }
+   bool   full()     const { return size() == numCapacity; }
+
+private:
+
+   bool better(const T & lhs, const T & rhs) const { return compare(rhs, lhs); }
+   void percolateUp(size_t index);              // fix the heap after an append
+   void percolateDown(size_t index, size_t n);  // fix the heap below index, first n slots
+
+   custom::vector<T> container;   // heap of the kept elements, worst on top
+   size_t    numCapacity;         // K
+   Compare   compare;             // comparision operator
+};
+
+/************************************************
+ * BOUNDED PRIORITY QUEUE :: TOP
+ * Get the worst of the retained elements.
+ ***********************************************/
+template <class T, class Compare>
+const T & bounded_priority_queue <T, Compare> :: top() const
+{
+   if (!container.empty())
+      return container.front();
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/*****************************************
+ * BOUNDED PRIORITY QUEUE :: OFFER
+ * Keep the element if there is room or if it beats the
+ * worst one kept. Return TRUE if it was kept.
+ ****************************************/
+template <class T, class Compare>
+bool bounded_priority_queue <T, Compare> :: offer(const T & t)
+{
+   if (!full())
+   {
+      container.push_back(t);
+      percolateUp(size() - 1);
+      return true;
+   }
+   if (numCapacity == 0 || !better(t, container[0]))
+      return false;
+   container[0] = t;
+   percolateDown(0, size());
+   return true;
+}
+template <class T, class Compare>
+bool bounded_priority_queue <T, Compare> :: offer(T && t)
+{
+   if (!full())
+   {
+      container.push_back(std::move(t));
+      percolateUp(size() - 1);
+      return true;
+   }
+   if (numCapacity == 0 || !better(t, container[0]))
+      return false;
+   container[0] = std::move(t);
+   percolateDown(0, size());
+   return true;
+}
+
+/**********************************************
+ * BOUNDED PRIORITY QUEUE :: POP
+ * Delete the worst of the retained elements.
+ **********************************************/
+template <class T, class Compare>
+void bounded_priority_queue <T, Compare> :: pop()
+{
+   using std::swap;
+   if (empty())
+      return;
+   swap(container[0], container[size() - 1]);
+   container.pop_back();
+   percolateDown(0, size());
+}
+
+/**********************************************
+ * BOUNDED PRIORITY QUEUE :: DRAIN SORTED
+ * Hand back the retained elements best first and leave
+ * the queue empty, with its K slots reserved again.
+ * This is an in-place heap sort: the worst goes to the
+ * back, then the next worst, and so on.
+ **********************************************/
+template <class T, class Compare>
+custom::vector<T> bounded_priority_queue <T, Compare> :: drain_sorted()
+{
+   using std::swap;
+   for (size_t n = size(); n > 1; n--)
+   {
+      swap(container[0], container[n - 1]);
+      percolateDown(0, n - 1);
+   }
+
+   custom::vector<T> sorted(std::move(container));
+   container.reserve(numCapacity);
+   return sorted;
+}
+
+/************************************************
+ * BOUNDED PRIORITY QUEUE :: PERCOLATE UP
+ * Move a new element toward the root while it is worse
+ * than its parent.
+ ************************************************/
+template <class T, class Compare>
+void bounded_priority_queue <T, Compare> :: percolateUp(size_t index)
+{
+   using std::swap;
+   while (index > 0)
+   {
+      size_t indexParent = (index - 1) / 2;
+      if (!better(container[indexParent], container[index]))
+         return;
+      swap(container[indexParent], container[index]);
+      index = indexParent;
+   }
+}
+
+/************************************************
+ * BOUNDED PRIORITY QUEUE :: PERCOLATE DOWN
+ * Move the element at index away from the root while a
+ * child is worse than it. Only the first n slots count.
+ ************************************************/
+template <class T, class Compare>
+void bounded_priority_queue <T, Compare> :: percolateDown(size_t index, size_t n)
+{
+   using std::swap;
+   for (;;)
+   {
+      size_t indexLeft  = 2 * index + 1;
+      size_t indexRight = indexLeft + 1;
+      if (indexLeft >= n)
+         return;
+
+      size_t indexWorse = indexLeft;
+      if (indexRight < n && better(container[indexLeft], container[indexRight]))
+         indexWorse = indexRight;
+
+      if (!better(container[index], container[indexWorse]))
+         return;
+      swap(container[index], container[indexWorse]);
+      index = indexWorse;
+   }
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two bounded priority queues
+ ************************************************/
+template <class T, class Compare>
+inline void swap(custom::bounded_priority_queue <T, Compare> & lhs,
+                 custom::bounded_priority_queue <T, Compare> & rhs)
+{
+   using std::swap;
+   lhs.container.swap(rhs.container);
+   swap(lhs.numCapacity, rhs.numCapacity);
+   swap(lhs.compare, rhs.compare);
+}
+
+} // namespace custom
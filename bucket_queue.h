@@ -0,0 +1,259 @@
+/***********************************************************************
+ * Header:
+ *    BUCKET QUEUE
+ * Summary:
+ *    A priority queue for a small, fixed range of integer priorities
+ *    (QoS levels and the like). There is one FIFO per priority and a
+ *    bitmap of the non-empty ones, so push and pop are O(1) and
+ *    elements of equal priority come out in the order they went in.
+ *
+ *    Like priority_queue with std::less, the highest priority is at
+ *    the top. A two-level bitmap (one summary word over up to 64 words)
+ *    finds it with two find-last-set instructions.
+ *
+ *    This will contain the class definition of:
+ *        priority_of            : Default priority extractor (T is the priority)
+ *        bucket_queue           : A class that represents a Bucket Queue
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>   // std::out_of_range
+#include <utility>     // std::swap
+#include "vector.h"    // for the buckets
+#include "bitops.h"    // for find-last-set
+
+class TestBucketQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * PRIORITY OF
+ * Fetch the priority from an element. The default
+ * treats the element itself as the priority.
+ *************************************************/
+template <class T>
+struct priority_of
+{
+   size_t operator () (const T & t) const { return static_cast<size_t>(t); }
+};
+
+/*************************************************
+ * BUCKET QUEUE
+ * Priorities 0 .. NumPriorities-1, highest first, FIFO
+ * within a priority. T must be default constructible.
+ *************************************************/
+template <class T, size_t NumPriorities = 256, class Priority = custom::priority_of<T>>
+class bucket_queue
+{
+   static_assert(NumPriorities > 0 && NumPriorities <= 64 * 64,
+                 "bucket_queue supports at most 4096 priorities");
+
+   friend class ::TestBucketQueue; // give the unit test class access to the privates
+   template <class TT, size_t NN, class PPriority>
+   friend void swap(bucket_queue<TT, NN, PPriority>& lhs, bucket_queue<TT, NN, PPriority>& rhs);
+
+public:
+
+   //
+   // construct
+   //
+   bucket_queue(const Priority & p = Priority()) :
+      buckets(NumPriorities, Fifo()), summary(0), numElements(0), priority(p)
+   {
+      for (size_t w = 0; w < NUM_WORDS; w++)
+         words[w] = 0;
+   }
+   template <class Iterator>
+   bucket_queue(Iterator first, Iterator last, const Priority & p = Priority()) : bucket_queue(p)
+   {
+      for (auto it = first; it != last; ++it)
+         push(*it);
+   }
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   void  push(const T & t);
+   void  push(T && t);
+
+   //
+   // Remove
+   //
+   void  pop();
+
+   //
+   // Status
+   //
+   size_t size()  const { return numElements; }
+   bool empty()   const { return size() == size_t(0); }
+
+private:
+
+   static const size_t NUM_WORDS = (NumPriorities + 63) / 64;
+
+   /*************************************************
+    * FIFO
+    * A growable ring buffer: one bucket of the queue. The
+    * capacity is always a power of two so wrapping is a mask.
+    *************************************************/
+   struct Fifo
+   {
+      Fifo() : head(0), count(0) { }
+
+      bool empty() const      { return count == 0; }
+      const T & front() const { return ring[head]; }
+
+      // make room at the back and return the slot to fill
+      T & append()
+      {
+         if (count == ring.size())
+            grow();
+         return ring[(head + count++) & (ring.size() - 1)];
+      }
+
+      void pop_front()
+      {
+         ring[head] = T();   // release whatever the element owned
+         head = (head + 1) & (ring.size() - 1);
+         count--;
+      }
+
+      void grow()
+      {
+         custom::vector<T> ringNew(ring.size() == 0 ? 4 : ring.size() * 2);
+         for (size_t i = 0; i < count; i++)
+            ringNew[i] = std::move(ring[(head + i) & (ring.size() - 1)]);
+         ring.swap(ringNew);
+         head = 0;
+      }
+
+      custom::vector<T> ring;   // storage, every slot constructed
+      size_t head;              // index of the oldest element
+      size_t count;             // number of elements in the ring
+   };
+
+   size_t checkedPriority(const T & t) const
+   {
+      size_t p = priority(t);
+      if (p >= NumPriorities)
+         throw std::out_of_range("std:out_of_range");
+      return p;
+   }
+   void   mark(size_t p);        // bucket p became non-empty
+   void   unmark(size_t p);      // bucket p became empty
+   size_t topPriority() const
+   {
+      size_t w = bits::highestBit(summary);
+      return w * 64 + bits::highestBit(words[w]);
+   }
+
+   custom::vector<Fifo> buckets;   // one FIFO per priority
+   uint64_t words[NUM_WORDS];      // bit p%64 of word p/64 set when bucket p is non-empty
+   uint64_t summary;               // bit w set when words[w] is non-zero
+   size_t   numElements;           // number of elements in all buckets
+   Priority priority;              // priority extractor
+};
+
+/************************************************
+ * BUCKET QUEUE :: TOP
+ * Get the oldest element of the highest priority.
+ ***********************************************/
+template <class T, size_t NumPriorities, class Priority>
+const T & bucket_queue <T, NumPriorities, Priority> :: top() const
+{
+   if (!empty())
+      return buckets[topPriority()].front();
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/*****************************************
+ * BUCKET QUEUE :: PUSH
+ * Add a new element behind the others of the same
+ * priority. Throws if the priority is out of range.
+ ****************************************/
+template <class T, size_t NumPriorities, class Priority>
+void bucket_queue <T, NumPriorities, Priority> :: push(const T & t)
+{
+   size_t p = checkedPriority(t);
+   buckets[p].append() = t;
+   mark(p);
+   numElements++;
+}
+template <class T, size_t NumPriorities, class Priority>
+void bucket_queue <T, NumPriorities, Priority> :: push(T && t)
+{
+   size_t p = checkedPriority(t);
+   buckets[p].append() = std::move(t);
+   mark(p);
+   numElements++;
+}
+
+/**********************************************
+ * BUCKET QUEUE :: POP
+ * Delete the oldest element of the highest priority.
+ **********************************************/
+template <class T, size_t NumPriorities, class Priority>
+void bucket_queue <T, NumPriorities, Priority> :: pop()
+{
+   if (empty())
+      return;
+
+   size_t p = topPriority();
+   buckets[p].pop_front();
+   if (buckets[p].empty())
+      unmark(p);
+   numElements--;
+}
+
+/************************************************
+ * BUCKET QUEUE :: MARK
+ * Note that bucket p has something in it.
+ ************************************************/
+template <class T, size_t NumPriorities, class Priority>
+void bucket_queue <T, NumPriorities, Priority> :: mark(size_t p)
+{
+   words[p / 64] |= (uint64_t)1 << (p % 64);
+   summary |= (uint64_t)1 << (p / 64);
+}
+
+/************************************************
+ * BUCKET QUEUE :: UNMARK
+ * Note that bucket p is empty.
+ ************************************************/
+template <class T, size_t NumPriorities, class Priority>
+void bucket_queue <T, NumPriorities, Priority> :: unmark(size_t p)
+{
+   words[p / 64] &= ~((uint64_t)1 << (p % 64));
+   if (words[p / 64] == 0)
+      summary &= ~((uint64_t)1 << (p / 64));
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two bucket queues
+ ************************************************/
+template <class T, size_t NumPriorities, class Priority>
+inline void swap(custom::bucket_queue <T, NumPriorities, Priority> & lhs,
+                 custom::bucket_queue <T, NumPriorities, Priority> & rhs)
+{
+   lhs.buckets.swap(rhs.buckets);
+   for (size_t w = 0; w < bucket_queue<T, NumPriorities, Priority>::NUM_WORDS; w++)
+      std::swap(lhs.words[w], rhs.words[w]);
+   std::swap(lhs.summary, rhs.summary);
+   std::swap(lhs.numElements, rhs.numElements);
+   std::swap(lhs.priority, rhs.priority);
+}
+
+} // namespace custom
@@ -0,0 +1,256 @@
+/***********************************************************************
+ * Header:
+ *    CHILD SELECT
+ * Summary:
+ *    Pick the best of a d-ary heap node's D contiguous children. This
+ *    is the inner loop of percolateDown.
+ *
+ *    The generic version is a chain of scalar compares. For 4 or 8
+ *    children of type uint32_t, float, or double, or 8 of uint64_t,
+ *    ordered by std::less or std::greater, an AVX2 kernel does it with
+ *    one vertical max/min, a log2(D) horizontal reduction, a
+ *    compare-equal, and a movemask. Both pick the first child holding
+ *    the best value, so the heap comes out identical either way.
+ *
+ *    The AVX2 code is compiled with a target attribute and used only
+ *    when the CPU reports AVX2 at run time, so the build itself stays
+ *    baseline x86-64. On other compilers and architectures only the
+ *    scalar path exists. NaN keys are not supported by the kernels.
+ *
+ *    This will contain the definitions of:
+ *        simd::useAvx2          : Run-time switch, initialized from CPUID
+ *        child_select           : Best-of-D selection, scalar or vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>    // std::less, std::greater
+#include <type_traits>   // std::is_same
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CUSTOM_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace custom
+{
+namespace simd
+{
+
+/*************************************************
+ * USE AVX2
+ * TRUE when the AVX2 kernels may run. Set from CPUID on
+ * first use; benchmarks and tests may turn it off to
+ * compare against the scalar path.
+ *************************************************/
+inline bool & useAvx2()
+{
+#ifdef CUSTOM_SIMD_AVX2
+   static bool use = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+#else
+   static bool use = false;
+#endif
+   return use;
+}
+
+#ifdef CUSTOM_SIMD_AVX2
+#define CUSTOM_TARGET_AVX2 __attribute__((target("avx2")))
+
+/*************************************************
+ * AVX2 KERNELS
+ * Each returns the index of the first of N values equal
+ * to their max (IsMax) or min. The reduction leaves the
+ * best value in every lane, so one compare-equal and a
+ * movemask find where it came from.
+ *************************************************/
+
+// 4 x float in one SSE register
+template <bool IsMax>
+CUSTOM_TARGET_AVX2 inline size_t best4(const float * p)
+{
+   __m128 v = _mm_loadu_ps(p);
+   __m128 m = IsMax ? _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)))
+                    : _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+   m = IsMax ? _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)))
+             : _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+   return __builtin_ctz(_mm_movemask_ps(_mm_cmpeq_ps(v, m)));
+}
+
+// 4 x uint32_t in one SSE register
+template <bool IsMax>
+CUSTOM_TARGET_AVX2 inline size_t best4(const uint32_t * p)
+{
+   __m128i v = _mm_loadu_si128((const __m128i *)p);
+   __m128i m = IsMax ? _mm_max_epu32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)))
+                     : _mm_min_epu32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+   m = IsMax ? _mm_max_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)))
+             : _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+   return __builtin_ctz(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, m))));
+}
+
+// 8 x float in one AVX register
+template <bool IsMax>
+CUSTOM_TARGET_AVX2 inline size_t best8(const float * p)
+{
+   __m256 v = _mm256_loadu_ps(p);
+   __m256 m = IsMax ? _mm256_max_ps(v, _mm256_permute2f128_ps(v, v, 1))
+                    : _mm256_min_ps(v, _mm256_permute2f128_ps(v, v, 1));
+   m = IsMax ? _mm256_max_ps(m, _mm256_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)))
+             : _mm256_min_ps(m, _mm256_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+   m = IsMax ? _mm256_max_ps(m, _mm256_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)))
+             : _mm256_min_ps(m, _mm256_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+   return __builtin_ctz(_mm256_movemask_ps(_mm256_cmp_ps(v, m, _CMP_EQ_OQ)));
+}
+
+// 8 x uint32_t in one AVX register
+template <bool IsMax>
+CUSTOM_TARGET_AVX2 inline size_t best8(const uint32_t * p)
+{
+   __m256i v = _mm256_loadu_si256((const __m256i *)p);
+   __m256i m = IsMax ? _mm256_max_epu32(v, _mm256_permute2x128_si256(v, v, 1))
+                     : _mm256_min_epu32(v, _mm256_permute2x128_si256(v, v, 1));
+   m = IsMax ? _mm256_max_epu32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)))
+             : _mm256_min_epu32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+   m = IsMax ? _mm256_max_epu32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)))
+             : _mm256_min_epu32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+   return __builtin_ctz(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, m))));
+}
+
+// lane-wise max/min of 4 x double
+template <bool IsMax>
+CUSTOM_TARGET_AVX2 inline __m256d best(__m256d a, __m256d b)
+{
+   return IsMax ? _mm256_max_pd(a, b) : _mm256_min_pd(a, b);
+}
+
+// lane-wise max/min of 4 x uint64_t: AVX2 has only a signed 64-bit
+// compare, so flip the sign bits first
+template <bool IsMax>
+CUSTOM_TARGET_AVX2 inline __m256i best(__m256i a, __m256i b)
+{
+   const __m256i sign = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+   __m256i aGreater = _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+   return IsMax ? _mm256_blendv_epi8(b, a, aGreater) : _mm256_blendv_epi8(a, b, aGreater);
+}
+
+// every lane gets the best of the 4 x double
+template <bool IsMax>
+CUSTOM_TARGET_AVX2 inline __m256d reduce(__m256d m)
+{
+   m = best<IsMax>(m, _mm256_permute2f128_pd(m, m, 1));
+   return best<IsMax>(m, _mm256_shuffle_pd(m, m, 0x5));
+}
+
+// every lane gets the best of the 4 x uint64_t
+template <bool IsMax>
+CUSTOM_TARGET_AVX2 inline __m256i reduce(__m256i m)
+{
+   m = best<IsMax>(m, _mm256_permute2x128_si256(m, m, 1));
+   return best<IsMax>(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+CUSTOM_TARGET_AVX2 inline int equalMask(__m256d v, __m256d m)
+{
+   return _mm256_movemask_pd(_mm256_cmp_pd(v, m, _CMP_EQ_OQ));
+}
+CUSTOM_TARGET_AVX2 inline int equalMask(__m256i v, __m256i m)
+{
+   return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, m)));
+}
+CUSTOM_TARGET_AVX2 inline __m256d load4(const double * p)   { return _mm256_loadu_pd(p); }
+CUSTOM_TARGET_AVX2 inline __m256i load4(const uint64_t * p) { return _mm256_loadu_si256((const __m256i *)p); }
+
+// 4 x 64-bit in one AVX register
+template <bool IsMax, class T>
+CUSTOM_TARGET_AVX2 inline size_t best4(const T * p)
+{
+   auto v = load4(p);
+   return __builtin_ctz(equalMask(v, reduce<IsMax>(v)));
+}
+
+// 8 x 64-bit in two AVX registers
+template <bool IsMax, class T>
+CUSTOM_TARGET_AVX2 inline size_t best8(const T * p)
+{
+   auto lo = load4(p);
+   auto hi = load4(p + 4);
+   auto m = reduce<IsMax>(best<IsMax>(lo, hi));
+   return __builtin_ctz(equalMask(lo, m) | (equalMask(hi, m) << 4));
+}
+
+#undef CUSTOM_TARGET_AVX2
+#endif // CUSTOM_SIMD_AVX2
+
+} // namespace simd
+
+/*************************************************
+ * CHILD SELECT
+ * Index (0 .. D-1) of the best of D contiguous children.
+ * The generic version calls the comparator; the first
+ * child wins a tie. Vector = false forces it.
+ *************************************************/
+template <class T, size_t D, class Compare, bool Vector = true>
+struct child_select
+{
+   static size_t best(const T * children, const Compare & compare)
+   {
+      size_t indexBest = 0;
+      for (size_t i = 1; i < D; i++)
+         if (compare(children[indexBest], children[i]))
+            indexBest = i;
+      return indexBest;
+   }
+};
+
+#ifdef CUSTOM_SIMD_AVX2
+
+// the key types and fan-outs with a kernel. Four uint64_t children are
+// left to the scalar chain: without a native unsigned 64-bit max the
+// kernel measured slower than the compares it replaces
+template <class T, size_t D>
+struct has_child_kernel
+{
+   static const bool value = (D == 4 || D == 8) &&
+      (std::is_same<T, uint32_t>::value || std::is_same<T, float>::value ||
+       std::is_same<T, double>::value   || (std::is_same<T, uint64_t>::value && D == 8));
+};
+
+/*************************************************
+ * CHILD SELECT VECTOR
+ * The AVX2 kernel when the CPU has it, the scalar chain
+ * when it does not. IsMax for std::less, !IsMax for
+ * std::greater.
+ *************************************************/
+template <class T, size_t D, class Compare, bool IsMax, bool HasKernel = has_child_kernel<T, D>::value>
+struct child_select_vector : child_select<T, D, Compare, false>
+{
+};
+
+template <class T, size_t D, class Compare, bool IsMax>
+struct child_select_vector<T, D, Compare, IsMax, true>
+{
+   static size_t best(const T * children, const Compare & compare)
+   {
+      if (simd::useAvx2())
+         return D == 4 ? simd::best4<IsMax>(children) : simd::best8<IsMax>(children);
+      return child_select<T, D, Compare, false>::best(children, compare);
+   }
+};
+
+template <class T, size_t D>
+struct child_select<T, D, std::less<T>, true> : child_select_vector<T, D, std::less<T>, true>
+{
+};
+
+template <class T, size_t D>
+struct child_select<T, D, std::greater<T>, true> : child_select_vector<T, D, std::greater<T>, false>
+{
+};
+
+#endif // CUSTOM_SIMD_AVX2
+
+} // namespace custom
@@ -0,0 +1,185 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT SPY
+ * Summary:
+ *    A Spy for benchmarks with several threads. Spy keeps one shared
+ *    array of int counters: it overflows past 2^31 and races as soon
+ *    as two threads touch Spies. ConcurrentSpy counts the same events
+ *    (the markers of spy.h) into 64-bit counters of the thread doing
+ *    the work, each thread's block on its own cache lines, and sums
+ *    the blocks when asked. A count is a relaxed load and store to a
+ *    line no other thread writes, so it costs about what Spy's does.
+ *
+ *    It holds its value inline rather than through new, so ALLOC and
+ *    DELETE are always zero, and it does not perturb the allocator it
+ *    is being used to measure.
+ *
+ *    A thread gets a block the first time it counts and gives it back
+ *    when it exits; the next new thread takes it over, counts and all.
+ *    Totals therefore include threads that have finished, and there
+ *    are never more blocks than threads that were alive at once.
+ *
+ *    This will contain the class definition of:
+ *        ConcurrentSpy          : A mock element safe to use from many threads
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>     // for std::atomic
+#include <cstdint>    // for uint64_t
+#include "prefetch.h" // for custom::CACHE_LINE
+#include "spy.h"      // for the markers: COPY, LESSTHAN, ...
+
+class TestConcurrentSpy;    // forward declaration for unit test class
+
+/*************************************************************
+ * CONCURRENT SPY
+ * A mock class that records how it was used, thread by thread
+ *************************************************************/
+class ConcurrentSpy
+{
+   friend class ::TestConcurrentSpy; // give the unit test class access to the privates
+public:
+   ConcurrentSpy()                             : value(0)         { count(DEFAULT);    }
+   ConcurrentSpy(uint64_t value)               : value(value)     { count(NONDEFAULT); }
+   ConcurrentSpy(const ConcurrentSpy & rhs)    : value(rhs.value) { count(COPY);       }
+   ConcurrentSpy(ConcurrentSpy && rhs) noexcept : value(rhs.value) { count(COPY_MOVE);  }
+   ~ConcurrentSpy()                                               { count(DESTRUCTOR); }
+
+   ConcurrentSpy & operator = (const ConcurrentSpy & rhs)
+   {
+      value = rhs.value;
+      count(ASSIGN);
+      return *this;
+   }
+   ConcurrentSpy & operator = (ConcurrentSpy && rhs) noexcept
+   {
+      value = rhs.value;
+      count(ASSIGN_MOVE);
+      return *this;
+   }
+   void swap(ConcurrentSpy & rhs) noexcept
+   {
+      uint64_t temp = rhs.value;
+      rhs.value = value;
+      value = temp;
+      count(SWAP);
+   }
+
+   bool operator == (const ConcurrentSpy & rhs) const { count(EQUALS);   return value == rhs.value; }
+   bool operator <  (const ConcurrentSpy & rhs) const { count(LESSTHAN); return value <  rhs.value; }
+
+   uint64_t get() const { return value; }
+
+   // totals over every thread
+   static uint64_t total(int marker);
+   static void reset();
+
+   static uint64_t numAlloc()       { return total(ALLOC);       }
+   static uint64_t numDelete()      { return total(DELETE);      }
+   static uint64_t numDefault()     { return total(DEFAULT);     }
+   static uint64_t numNondefault()  { return total(NONDEFAULT);  }
+   static uint64_t numCopy()        { return total(COPY);        }
+   static uint64_t numCopyMove()    { return total(COPY_MOVE);   }
+   static uint64_t numDestructor()  { return total(DESTRUCTOR);  }
+   static uint64_t numAssign()      { return total(ASSIGN);      }
+   static uint64_t numAssignMove()  { return total(ASSIGN_MOVE); }
+   static uint64_t numEquals()      { return total(EQUALS);      }
+   static uint64_t numLessthan()    { return total(LESSTHAN);    }
+   static uint64_t numSwap()        { return total(SWAP);        }
+
+private:
+   // one thread's counters, alone on their cache lines
+   struct alignas(custom::CACHE_LINE) Block
+   {
+      std::atomic<uint64_t> counters[NUM_MARKERS] = {};
+      std::atomic<bool>     inUse { true };
+      Block *               next = nullptr;   // never changes once published
+   };
+
+   // gives the block back when its thread exits
+   struct Lease
+   {
+      Block * block;
+      Lease() : block(acquire()) { }
+      ~Lease() { block->inUse.store(false, std::memory_order_release); }
+   };
+
+   static void count(int marker)
+   {
+      thread_local Lease lease;
+      std::atomic<uint64_t> & counter = lease.block->counters[marker];
+      counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+   }
+
+   static std::atomic<Block *> & blocks()
+   {
+      static std::atomic<Block *> head { nullptr };
+      return head;
+   }
+
+   static Block * acquire();
+
+   uint64_t value;
+};
+
+inline void swap(ConcurrentSpy & lhs, ConcurrentSpy & rhs) { lhs.swap(rhs); }
+
+/*****************************************
+ * CONCURRENT SPY :: ACQUIRE
+ * Take over a block a finished thread left,
+ * or add a new one to the front of the list
+ ****************************************/
+inline ConcurrentSpy::Block * ConcurrentSpy::acquire()
+{
+   for (Block * block = blocks().load(std::memory_order_acquire); block; block = block->next)
+   {
+      bool idle = false;
+      if (!block->inUse.load(std::memory_order_relaxed) &&
+          block->inUse.compare_exchange_strong(idle, true, std::memory_order_acquire))
+         return block;
+   }
+
+   Block * block = new Block;
+   Block * head = blocks().load(std::memory_order_relaxed);
+   do
+      block->next = head;
+   while (!blocks().compare_exchange_weak(head, block, std::memory_order_release,
+                                          std::memory_order_relaxed));
+   return block;
+}
+
+/*****************************************
+ * CONCURRENT SPY :: TOTAL
+ * Sum one marker over every block
+ ****************************************/
+inline uint64_t ConcurrentSpy::total(int marker)
+{
+   uint64_t sum = 0;
+   for (Block * block = blocks().load(std::memory_order_acquire); block; block = block->next)
+      sum += block->counters[marker].load(std::memory_order_relaxed);
+   return sum;
+}
+
+/*****************************************
+ * CONCURRENT SPY :: RESET
+ * Zero every block. Counts made while this
+ * runs may or may not survive it.
+ ****************************************/
+inline void ConcurrentSpy::reset()
+{
+   for (Block * block = blocks().load(std::memory_order_acquire); block; block = block->next)
+      for (int i = 0; i < NUM_MARKERS; i++)
+         block->counters[i].store(0, std::memory_order_relaxed);
+}
+
+/*************************************************************
+ * CONCURRENT SPY is trivially relocatable, like Spy: it is
+ * only its value, so it sifts through a heap the same way
+ *************************************************************/
+namespace custom
+{
+template <> struct is_trivially_relocatable<ConcurrentSpy> : std::true_type { };
+}
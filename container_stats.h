@@ -0,0 +1,213 @@
+/***********************************************************************
+ * Header:
+ *    CONTAINER STATS
+ * Summary:
+ *    Stats policies for priority_queue and vector. The container calls
+ *    the policy's hooks as it works; no_stats, the default, has empty
+ *    hooks and no data, so it compiles away and fits in the padding
+ *    beside the allocator or comparator. op_stats counts pushes, pops,
+ *    the largest size, levels sifted, comparisons and reallocations,
+ *    and keeps latency histograms of push and pop.
+ *
+ *    The histograms are log-linear, as in HDR histograms: values below
+ *    64 each have a bucket, and above that every power of two is split
+ *    into 32 buckets, so any value is known to within about 3% in
+ *    under 2000 counters.
+ *
+ *    This will contain the class definitions of:
+ *        latency_histogram      : Log-linear counts of nanoseconds
+ *        stats_snapshot         : A copy of the numbers for an exporter
+ *        no_stats               : The policy that does nothing
+ *        op_stats               : The policy that counts everything
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <chrono>     // for std::chrono::steady_clock
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include "bitops.h"   // for bits::highestBit
+
+class TestContainerStats;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * LATENCY HISTOGRAM
+ * How many samples fell in each bucket
+ *************************************************/
+class latency_histogram
+{
+   friend class ::TestContainerStats; // give the unit test class access to the privates
+public:
+   static const int    SUB_BITS = 6;
+   static const size_t SUB      = (size_t)1 << SUB_BITS;   // exact below this
+   static const size_t HALF     = SUB / 2;                  // buckets per power of two above
+   static const size_t BUCKETS  = (64 - SUB_BITS + 2) * HALF;
+
+   latency_histogram() : counts(), numSamples(0) { }
+
+   void record(uint64_t value)
+   {
+      counts[bucketOf(value)]++;
+      numSamples++;
+   }
+
+   uint64_t count() const { return numSamples; }
+
+   // the smallest value at least FRACTION of the samples are at or under
+   uint64_t percentile(double fraction) const;
+
+private:
+   static size_t bucketOf(uint64_t value)
+   {
+      if (value < SUB)
+         return (size_t)value;
+      int shift = bits::highestBit(value) - (SUB_BITS - 1);
+      return (size_t)shift * HALF + (size_t)(value >> shift);
+   }
+
+   // the largest value that lands in BUCKET
+   static uint64_t highestIn(size_t bucket)
+   {
+      if (bucket < SUB)
+         return bucket;
+      size_t shift = bucket / HALF - 1;
+      uint64_t mantissa = bucket - shift * HALF;
+      return ((mantissa + 1) << shift) - 1;
+   }
+
+   uint64_t counts[BUCKETS];
+   uint64_t numSamples;
+};
+
+/*************************************************
+ * STATS SNAPSHOT
+ * Everything a stats policy knows, by value. The
+ * latencies are in nanoseconds; all zero when the
+ * policy does not time.
+ *************************************************/
+struct stats_snapshot
+{
+   uint64_t pushes        = 0;
+   uint64_t pops          = 0;
+   uint64_t maxSize       = 0;
+   uint64_t siftLevels    = 0;
+   uint64_t comparisons   = 0;
+   uint64_t reallocations = 0;
+   uint64_t pushP50 = 0, pushP99 = 0, pushP999 = 0;
+   uint64_t popP50  = 0, popP99  = 0, popP999  = 0;
+};
+
+/*************************************************
+ * NO STATS
+ * Every hook is empty
+ *************************************************/
+struct no_stats
+{
+   typedef int time_point;
+
+   void onPush()                 { }
+   void onPop()                  { }
+   void onSize(size_t)           { }
+   void onSift(size_t)           { }
+   void onCompare(size_t)        { }
+   void onRealloc()              { }
+   time_point start() const      { return 0; }
+   void pushTook(time_point)     { }
+   void popTook(time_point)      { }
+
+   stats_snapshot snapshot() const { return stats_snapshot(); }
+};
+
+/*************************************************
+ * OP STATS
+ * Counts every operation and times pushes and pops.
+ * Not thread-safe, like the container it sits in.
+ *************************************************/
+class op_stats
+{
+   friend class ::TestContainerStats; // give the unit test class access to the privates
+public:
+   typedef std::chrono::steady_clock::time_point time_point;
+
+   void onPush()                 { numPushes++; }
+   void onPop()                  { numPops++; }
+   void onSize(size_t size)      { if (size > numMaxSize) numMaxSize = size; }
+   void onSift(size_t levels)    { numSiftLevels += levels; }
+   void onCompare(size_t n)      { numComparisons += n; }
+   void onRealloc()              { numReallocations++; }
+   time_point start() const      { return std::chrono::steady_clock::now(); }
+   void pushTook(time_point begin) { pushLatency.record(since(begin)); }
+   void popTook(time_point begin)  { popLatency.record(since(begin)); }
+
+   stats_snapshot snapshot() const;
+
+   const latency_histogram & push_latency() const { return pushLatency; }
+   const latency_histogram & pop_latency()  const { return popLatency;  }
+
+private:
+   static uint64_t since(time_point begin)
+   {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now() - begin).count();
+   }
+
+   uint64_t numPushes = 0;
+   uint64_t numPops = 0;
+   uint64_t numMaxSize = 0;
+   uint64_t numSiftLevels = 0;
+   uint64_t numComparisons = 0;
+   uint64_t numReallocations = 0;
+   latency_histogram pushLatency;
+   latency_histogram popLatency;
+};
+
+/*****************************************
+ * LATENCY HISTOGRAM :: PERCENTILE
+ * Walk the buckets until enough samples are covered
+ ****************************************/
+inline uint64_t latency_histogram::percentile(double fraction) const
+{
+   if (numSamples == 0)
+      return 0;
+   double exact = fraction * (double)numSamples;
+   uint64_t wanted = (uint64_t)exact;
+   if (wanted < exact || wanted == 0)
+      wanted++;
+   uint64_t seen = 0;
+   for (size_t bucket = 0; bucket < BUCKETS; bucket++)
+   {
+      seen += counts[bucket];
+      if (seen >= wanted)
+         return highestIn(bucket);
+   }
+   return highestIn(BUCKETS - 1);
+}
+
+/*****************************************
+ * OP STATS :: SNAPSHOT
+ * Copy out the counts and the percentiles
+ ****************************************/
+inline stats_snapshot op_stats::snapshot() const
+{
+   stats_snapshot s;
+   s.pushes        = numPushes;
+   s.pops          = numPops;
+   s.maxSize       = numMaxSize;
+   s.siftLevels    = numSiftLevels;
+   s.comparisons   = numComparisons;
+   s.reallocations = numReallocations;
+   s.pushP50  = pushLatency.percentile(0.50);
+   s.pushP99  = pushLatency.percentile(0.99);
+   s.pushP999 = pushLatency.percentile(0.999);
+   s.popP50   = popLatency.percentile(0.50);
+   s.popP99   = popLatency.percentile(0.99);
+   s.popP999  = popLatency.percentile(0.999);
+   return s;
+}
+
+} // namespace custom
@@ -0,0 +1,255 @@
+/***********************************************************************
+ * Header:
+ *    D-ARY HEAP
+ * Summary:
+ *    A priority queue on an implicit tree with D children per node.
+ *    A wider node makes the heap shallower, so pop touches fewer
+ *    levels, but each level has to pick the best of D children.
+ *    The D children of a node are contiguous, so for arithmetic keys
+ *    child_select does that pick with a few vector instructions.
+ *
+ *    Ordering follows priority_queue: with std::less the largest
+ *    element is on top.
+ *
+ *    This will contain the class definition of:
+ *        dary_heap              : A class that represents a D-ary Heap
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <functional>     // std::less
+#include <stdexcept>      // std::out_of_range
+#include <utility>        // std::swap, std::move
+#include "vector.h"       // for default underlying container
+#include "child_select.h" // for picking the best child
+#include "prefetch.h"     // for prefetching the next level of a sift
+
+class TestDaryHeap;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * D-ARY HEAP
+ * A priority queue with D children per node. The
+ * Container must store its elements contiguously.
+ *************************************************/
+template<class T, size_t D = 4, class Container = custom::vector<T>, class Compare = std::less<T>>
+class dary_heap
+{
+   static_assert(D >= 2, "a d-ary heap needs at least two children per node");
+
+   friend class ::TestDaryHeap; // give the unit test class access to the privates
+   template <class TT, size_t DD, class CContainer, class CCompare>
+   friend void swap(dary_heap<TT, DD, CContainer, CCompare>& lhs, dary_heap<TT, DD, CContainer, CCompare>& rhs);
+
+public:
+
+   //
+   // construct
+   //
+   dary_heap(const Compare & c = Compare()) : compare(c) { }
+   template <class Iterator>
+   dary_heap(Iterator first, Iterator last, const Compare & c = Compare()) : compare(c)
+   {
+      container.reserve(last - first);
+      for (auto it = first; it != last; ++it)
+         container.push_back(*it);
+      heapify();
+   }
+   explicit dary_heap(const Compare & c, Container && rhs) : container(std::move(rhs)), compare(c) { heapify(); }
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   void push(const T & t);
+   void push(T && t);
+
+   //
+   // Remove
+   //
+   void pop();
+
+   //
+   // Status
+   //
+   size_t size()  const { return container.size(); }
+   bool empty()   const { return size() == size_t(0); }
+
+   //
+   // Tuning
+   //
+   void set_prefetch_threshold(size_t numElements) { prefetchThreshold = numElements; }
+
+private:
+
+   // Where prefetching the grandchildren starts to pay, from BenchPrefetch.
+   // Each level compares D children, so the hint pays off sooner than in
+   // the binary priority_queue.
+   static const size_t PREFETCH_BYTES = (size_t)512 << 10;
+
+   // zero-based index arithmetic
+   static size_t parent(size_t i)     { return (i - 1) / D; }
+   static size_t firstChild(size_t i) { return D * i + 1; }
+
+   void   percolateUp(size_t index);    // fix the heap after a push
+   void   percolateDown(size_t index);  // fix the heap below index
+   void   heapify();                    // convert the container in to a heap
+   size_t bestChild(size_t index) const;
+
+   Container container;       // underlying container (probably a vector)
+   Compare   compare;         // comparision operator
+   size_t    prefetchThreshold = PREFETCH_BYTES / sizeof(T); // prefetch when the heap is bigger
+};
+
+/************************************************
+ * D-ARY HEAP :: TOP
+ * Get the maximum item from the heap: the top item.
+ ***********************************************/
+template <class T, size_t D, class Container, class Compare>
+const T & dary_heap <T, D, Container, Compare> :: top() const
+{
+   if (!container.empty())
+      return container.front();
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/*****************************************
+ * D-ARY HEAP :: PUSH
+ * Add a new element to the heap, reallocating as necessary
+ ****************************************/
+template <class T, size_t D, class Container, class Compare>
+void dary_heap <T, D, Container, Compare> :: push(const T & t)
+{
+   container.push_back(t);
+   percolateUp(size() - 1);
+}
+template <class T, size_t D, class Container, class Compare>
+void dary_heap <T, D, Container, Compare> :: push(T && t)
+{
+   container.push_back(std::move(t));
+   percolateUp(size() - 1);
+}
+
+/**********************************************
+ * D-ARY HEAP :: POP
+ * Delete the top item from the heap.
+ **********************************************/
+template <class T, size_t D, class Container, class Compare>
+void dary_heap <T, D, Container, Compare> :: pop()
+{
+   if (empty())
+      return;
+
+   if (size() > 1)
+      container[0] = std::move(container[size() - 1]);
+   container.pop_back();
+   if (!empty())
+      percolateDown(0);
+}
+
+/************************************************
+ * D-ARY HEAP :: BEST CHILD
+ * The child of INDEX that belongs highest. A full set of
+ * D children goes through child_select; the last parent
+ * may have fewer.
+ ************************************************/
+template <class T, size_t D, class Container, class Compare>
+size_t dary_heap <T, D, Container, Compare> :: bestChild(size_t index) const
+{
+   size_t indexFirst = firstChild(index);
+   if (indexFirst + D <= size())
+      return indexFirst + child_select<T, D, Compare>::best(&container[indexFirst], compare);
+
+   size_t indexBest = indexFirst;
+   for (size_t i = indexFirst + 1; i < size(); i++)
+      if (compare(container[indexBest], container[i]))
+         indexBest = i;
+   return indexBest;
+}
+
+/************************************************
+ * D-ARY HEAP :: PERCOLATE UP
+ * Move the element at INDEX toward the root while it
+ * belongs above its parent. The element is held aside and
+ * the parents slide down into the hole.
+ ************************************************/
+template <class T, size_t D, class Container, class Compare>
+void dary_heap <T, D, Container, Compare> :: percolateUp(size_t index)
+{
+   T value = std::move(container[index]);
+   while (index > 0)
+   {
+      size_t indexParent = parent(index);
+      if (!compare(container[indexParent], value))
+         break;
+      container[index] = std::move(container[indexParent]);
+      index = indexParent;
+   }
+   container[index] = std::move(value);
+}
+
+/************************************************
+ * D-ARY HEAP :: PERCOLATE DOWN
+ * Move the element at INDEX away from the root while its
+ * best child belongs above it.
+ ************************************************/
+template <class T, size_t D, class Container, class Compare>
+void dary_heap <T, D, Container, Compare> :: percolateDown(size_t index)
+{
+   T value = std::move(container[index]);
+   bool prefetching = size() > prefetchThreshold;
+   while (firstChild(index) < size())
+   {
+      // the children of all D children are one contiguous run: whichever
+      // child wins, its children are in there
+      size_t indexGrandchild = firstChild(firstChild(index));
+      if (prefetching && indexGrandchild < size())
+         prefetchRange(&container[indexGrandchild], D * D * sizeof(T));
+
+      size_t indexBest = bestChild(index);
+      if (!compare(value, container[indexBest]))
+         break;
+      container[index] = std::move(container[indexBest]);
+      index = indexBest;
+   }
+   container[index] = std::move(value);
+}
+
+/************************************************
+ * D-ARY HEAP :: HEAPIFY
+ * Turn the container into a heap, bottom up.
+ ************************************************/
+template <class T, size_t D, class Container, class Compare>
+void dary_heap <T, D, Container, Compare> :: heapify()
+{
+   if (size() < 2)
+      return;
+   for (size_t i = parent(size() - 1) + 1; i-- > 0; )
+      percolateDown(i);
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two d-ary heaps
+ ************************************************/
+template <class T, size_t D, class Container, class Compare>
+inline void swap(custom::dary_heap <T, D, Container, Compare> & lhs,
+                 custom::dary_heap <T, D, Container, Compare> & rhs)
+{
+   using std::swap;
+   swap(lhs.container, rhs.container);
+   swap(lhs.compare, rhs.compare);
+   swap(lhs.prefetchThreshold, rhs.prefetchThreshold);
+}
+
+} // namespace custom
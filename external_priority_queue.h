@@ -0,0 +1,513 @@
+/***********************************************************************
+ * Header:
+ *    EXTERNAL PRIORITY QUEUE
+ * Summary:
+ *    A priority queue for more elements than memory holds. New
+ *    elements go to an in-memory priority_queue, the buffer. When the
+ *    buffer is full it is drained, best first, into a run: a sorted
+ *    temporary file. Each run is read back from the front one element
+ *    at a time, and its next element (its head) sits in a small merge
+ *    heap. The top is the better of the buffer's top and the merge
+ *    heap's top.
+ *
+ *    Runs are only ever written front to back and read front to back,
+ *    through stdio buffers of blockBytes each, so the disk sees long
+ *    sequential transfers and never a seek. Memory is the buffer plus
+ *    one block per live run.
+ *
+ *    Runs are merged level by level, as in an LSM tree. A spill makes
+ *    a run of level 0; once fanIn runs share a level they are merged,
+ *    in one sequential pass, into a single run of the next level. So
+ *    at most fanIn - 1 runs live at each level, and each element is
+ *    rewritten about log_fanIn(N / buffer) times, not once per merge.
+ *
+ *    T must be trivially copyable: runs hold its bytes. Ordering
+ *    follows priority_queue: with std::less the largest is on top.
+ *    Run files are created in a directory ($TMPDIR by default, or /tmp
+ *    without it; batch hosts often keep /tmp on a small tmpfs, so point
+ *    TMPDIR or the constructor at real disk) and unlinked at once, so nothing is left
+ *    behind however the process ends. If writing a run fails (a full
+ *    disk, say), the error is thrown and the queue is as it was before
+ *    the spill or merge. POSIX only.
+ *
+ *    This will contain the class definition of:
+ *        external_priority_queue : Buffer in memory, sorted runs on disk
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>          // for errno
+#include <algorithm>       // for std::sort
+#include <cstdint>         // for uint32_t, uint64_t
+#include <cstdio>          // for std::FILE, fread, fwrite, fflush, setvbuf
+#include <cstdlib>         // for mkstemp, getenv
+#include <functional>      // for std::less
+#include <stdexcept>       // for std::out_of_range
+#include <string>          // for std::string
+#include <system_error>    // for std::system_error
+#include <type_traits>     // for std::is_trivially_copyable
+#include <unistd.h>        // for unlink, close
+#include "priority_queue.h" // for the buffer and the merge heap
+#include "vector.h"        // for the runs
+
+class TestExternalPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * EXTERNAL PRIORITY QUEUE
+ * An in-memory heap in front of sorted runs on disk
+ *************************************************/
+template <class T, class Compare = std::less<T>>
+class external_priority_queue
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "external_priority_queue writes its elements to disk as raw bytes");
+   friend class ::TestExternalPQueue; // give the unit test class access to the privates
+
+public:
+
+   //
+   // construct
+   //
+   explicit external_priority_queue(size_t bufferElements = (size_t)1 << 20,
+                                    const std::string & directory = temporaryDirectory(),
+                                    const Compare & c = Compare());
+   external_priority_queue(const external_priority_queue &) = delete;
+   external_priority_queue & operator = (const external_priority_queue &) = delete;
+   ~external_priority_queue();
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   void push(const T & t);
+
+   //
+   // Remove
+   //
+   void pop();
+
+   //
+   // Status
+   //
+   size_t size()  const { return buffer.size() + (size_t)numOnDisk; }
+   bool   empty() const { return size() == 0; }
+   size_t runs()  const { return merge.size(); }
+
+   //
+   // Tuning
+   //
+   size_t blockBytes = (size_t)1 << 16;   // stdio buffer for each run
+   size_t fanIn      = 64;                // runs of one level that are merged
+
+private:
+
+   // a sorted file, read from the front
+   struct Run
+   {
+      std::FILE * file;
+      uint64_t    remaining;   // elements after the head
+      size_t      level;       // 0 for a spill, one more than the runs merged into it
+   };
+
+   // the next element of a run, in the merge heap
+   struct Head
+   {
+      T        key;
+      uint32_t run;
+   };
+   struct HeadCompare
+   {
+      HeadCompare(const Compare & c = Compare()) : compare(c) { }
+      bool operator()(const Head & lhs, const Head & rhs) const { return compare(lhs.key, rhs.key); }
+      Compare compare;
+   };
+
+   static std::string temporaryDirectory();           // $TMPDIR, or /tmp
+   bool        bestOnDisk() const;                    // is the top in a run?
+   void        spill();                               // drain the buffer into a run
+   void        mergeLevel(size_t level);              // replace a level's runs with one
+   void        add(std::FILE * file, uint64_t count, size_t level); // a new live run
+   std::FILE * create();                              // an open, unlinked file
+   void        write(std::FILE * file, const T & t);  // append one element
+   void        finish(std::FILE * file);              // flush a written run, back to its front
+   bool        read(uint32_t index, T & t);           // the next element of a run, if any
+   void        advance(uint32_t index);               // next head of a run
+   void        close(Run & run);                      // done with a run
+   static custom::vector<T> reserved(size_t n)        // room for the buffer, up front
+   {
+      custom::vector<T> v;
+      v.reserve(n);
+      return v;
+   }
+
+   custom::priority_queue<T, custom::vector<T>, Compare> buffer;   // the newest elements
+   custom::priority_queue<Head, custom::vector<Head>, HeadCompare> merge; // one head per live run
+   custom::vector<Run> files;                         // every run, live or done
+   custom::vector<size_t> levels;                     // live runs at each level
+   Compare             compare;                       // comparison operator
+   std::string         directory;                     // where runs are made
+   size_t              bufferElements;                // spill when the buffer holds this many
+   uint64_t            numOnDisk;                     // elements in runs, heads included
+   uint64_t            numWritten;                    // elements written to runs, merges included
+};
+
+/*****************************************
+ * EXTERNAL PRIORITY QUEUE :: CONSTRUCTOR
+ ****************************************/
+template <class T, class Compare>
+external_priority_queue <T, Compare> ::external_priority_queue(size_t bufferElements,
+                                                               const std::string & directory,
+                                                               const Compare & c)
+   : buffer(c, reserved(bufferElements)), merge(HeadCompare(c)), compare(c), directory(directory),
+     bufferElements(bufferElements ? bufferElements : 1), numOnDisk(0), numWritten(0)
+{
+   buffer.set_shrink_policy(0);   // a spill empties it, and it fills right back up
+   merge.set_shrink_policy(0);    // a merge takes its heads out and puts most back
+}
+
+/*****************************************
+ * EXTERNAL PRIORITY QUEUE :: DESTRUCTOR
+ * Closing a run deletes it: it was unlinked when made
+ ****************************************/
+template <class T, class Compare>
+external_priority_queue <T, Compare> :: ~external_priority_queue()
+{
+   for (size_t i = 0; i < files.size(); i++)
+      close(files[i]);
+}
+
+/*****************************************
+ * EXTERNAL PRIORITY QUEUE :: TEMPORARY DIRECTORY
+ * Where runs go unless told otherwise
+ ****************************************/
+template <class T, class Compare>
+std::string external_priority_queue <T, Compare> :: temporaryDirectory()
+{
+   const char * tmpdir = std::getenv("TMPDIR");
+   return tmpdir && *tmpdir ? std::string(tmpdir) : std::string("/tmp");
+}
+
+/************************************************
+ * EXTERNAL PRIORITY QUEUE :: TOP
+ * The better of the buffer's best and the runs' best
+ ***********************************************/
+template <class T, class Compare>
+const T & external_priority_queue <T, Compare> :: top() const
+{
+   if (empty())
+      throw std::out_of_range("std:out_of_range");
+   return bestOnDisk() ? merge.top().key : buffer.top();
+}
+
+/*****************************************
+ * EXTERNAL PRIORITY QUEUE :: PUSH
+ * Into the buffer, spilling it first if it is full
+ ****************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: push(const T & t)
+{
+   if (buffer.size() >= bufferElements)
+      spill();
+   buffer.push(t);
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: POP
+ * Take the top from wherever it is; a run then
+ * offers its next element
+ **********************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: pop()
+{
+   if (empty())
+      return;
+   if (bestOnDisk())
+   {
+      uint32_t index = merge.top().run;
+      merge.pop();
+      numOnDisk--;
+      advance(index);
+   }
+   else
+      buffer.pop();
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: BEST ON DISK
+ * Is the top a run's head rather than in the buffer?
+ **********************************************/
+template <class T, class Compare>
+bool external_priority_queue <T, Compare> :: bestOnDisk() const
+{
+   if (merge.empty())
+      return false;
+   if (buffer.empty())
+      return true;
+   return compare(buffer.top(), merge.top().key);
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: SPILL
+ * Write the whole buffer, best first, into a new run
+ * of level 0, then merge every level that is full.
+ * The buffer is sorted in place, best first, which
+ * is still a heap: it is only emptied once the run
+ * is safely written.
+ **********************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: spill()
+{
+   if (buffer.empty())
+      return;
+   if (merge.empty())
+   {
+      files.clear();          // every run is done with
+      levels.clear();
+   }
+   files.reserve(files.size() + 1);
+   levels.reserve(1);
+
+   custom::vector<T> & heap = buffer.container;
+   std::sort(&heap[0], &heap[0] + heap.size(),
+             [this](const T & lhs, const T & rhs) { return compare(rhs, lhs); });
+
+   std::FILE * file = create();
+   try
+   {
+      for (size_t i = 0; i < heap.size(); i++)
+         write(file, heap[i]);
+      finish(file);
+   }
+   catch (...)
+   {
+      std::fclose(file);
+      throw;
+   }
+
+   uint64_t count = heap.size();
+   heap.clear();
+   numOnDisk += count;
+   add(file, count, 0);
+
+   size_t width = fanIn < 2 ? 2 : fanIn;
+   for (size_t level = 0; level < levels.size() && levels[level] >= width; level++)
+      mergeLevel(level);
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: MERGE LEVEL
+ * Stream the live runs of one level through a heap
+ * of their own into one run of the next level. The
+ * other runs are not touched. If the merge fails,
+ * each run of the level is wound back to where it
+ * stood and its head returned to the merge heap.
+ **********************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: mergeLevel(size_t level)
+{
+   // where a run of the level stood before the merge
+   struct Mark
+   {
+      Head        head;
+      uint64_t    remaining;
+      std::fpos_t position;
+   };
+
+   std::FILE * file = create();
+   custom::vector<Mark> marks;
+   custom::vector<Head> others;
+   HeadCompare headCompare(compare);
+   custom::priority_queue<Head, custom::vector<Head>, HeadCompare> pending(headCompare);
+   try
+   {
+      files.reserve(files.size() + 1);
+      levels.reserve(level + 2);
+      marks.reserve(merge.size());
+      others.reserve(merge.size());
+   }
+   catch (...)
+   {
+      std::fclose(file);
+      throw;
+   }
+
+   // take this level's heads out of the merge heap
+   while (!merge.empty())
+   {
+      const Head & head = merge.top();
+      Run & run = files[head.run];
+      if (run.level == level)
+      {
+         marks.push_back(Mark{ head, run.remaining, std::fpos_t() });
+         std::fgetpos(run.file, &marks.back().position);
+      }
+      else
+         others.push_back(head);
+      merge.pop();
+   }
+   for (size_t i = 0; i < others.size(); i++)
+      merge.push(others[i]);
+
+   uint64_t count = 0;
+   try
+   {
+      for (size_t i = 0; i < marks.size(); i++)
+         pending.push(marks[i].head);
+      while (!pending.empty())
+      {
+         Head head = pending.top();
+         pending.pop();
+         write(file, head.key);
+         count++;
+         if (read(head.run, head.key))
+            pending.push(head);
+      }
+      finish(file);
+   }
+   catch (...)
+   {
+      std::fclose(file);
+      for (size_t i = 0; i < marks.size(); i++)
+      {
+         Run & run = files[marks[i].head.run];
+         std::fsetpos(run.file, &marks[i].position);
+         run.remaining = marks[i].remaining;
+         merge.push(marks[i].head);
+      }
+      throw;
+   }
+
+   for (size_t i = 0; i < marks.size(); i++)
+      close(files[marks[i].head.run]);
+   add(file, count, level + 1);
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: ADD
+ * Make a rewound file a live run, with its first
+ * element in the merge heap
+ **********************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: add(std::FILE * file, uint64_t count, size_t level)
+{
+   if (levels.size() <= level)
+      levels.resize(level + 1);
+   levels[level]++;
+   files.push_back(Run{ file, count, level });
+   advance((uint32_t)(files.size() - 1));
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: CREATE
+ * A temporary file nobody else can see, with a
+ * stdio buffer of blockBytes
+ **********************************************/
+template <class T, class Compare>
+std::FILE * external_priority_queue <T, Compare> :: create()
+{
+   std::string path = directory + "/pq_run_XXXXXX";
+   int fd = ::mkstemp(&path[0]);
+   if (fd < 0)
+      throw std::system_error(errno, std::generic_category(), "external_priority_queue: mkstemp");
+   ::unlink(path.c_str());
+
+   std::FILE * file = ::fdopen(fd, "w+b");
+   if (file == nullptr)
+   {
+      int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), "external_priority_queue: fdopen");
+   }
+   std::setvbuf(file, nullptr, _IOFBF, blockBytes);
+   return file;
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: WRITE
+ **********************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: write(std::FILE * file, const T & t)
+{
+   if (std::fwrite(&t, sizeof(T), 1, file) != 1)
+      throw std::system_error(errno, std::generic_category(), "external_priority_queue: write");
+   numWritten++;
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: FINISH
+ * Push the last block to the disk, so an error
+ * writing it (ENOSPC) is thrown here and not found
+ * later as a short read, then rewind for reading
+ **********************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: finish(std::FILE * file)
+{
+   if (std::fflush(file) != 0)
+      throw std::system_error(errno, std::generic_category(), "external_priority_queue: flush");
+   std::rewind(file);
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: READ
+ * The next element of run INDEX; false if it has
+ * none left
+ **********************************************/
+template <class T, class Compare>
+bool external_priority_queue <T, Compare> :: read(uint32_t index, T & t)
+{
+   Run & run = files[index];
+   if (run.remaining == 0)
+      return false;
+   if (std::fread(&t, sizeof(T), 1, run.file) != 1)
+      throw std::system_error(errno ? errno : EIO, std::generic_category(), "external_priority_queue: read");
+   run.remaining--;
+   return true;
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: ADVANCE
+ * Read the next element of run INDEX into the merge
+ * heap, or close the run if it has none
+ **********************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: advance(uint32_t index)
+{
+   Head head;
+   if (!read(index, head.key))
+   {
+      close(files[index]);
+      return;
+   }
+   head.run = index;
+   merge.push(head);
+}
+
+/**********************************************
+ * EXTERNAL PRIORITY QUEUE :: CLOSE
+ **********************************************/
+template <class T, class Compare>
+void external_priority_queue <T, Compare> :: close(Run & run)
+{
+   if (run.file)
+   {
+      std::fclose(run.file);
+      levels[run.level]--;
+   }
+   run.file = nullptr;
+   run.remaining = 0;
+}
+
+} // namespace custom
+
+#endif // __unix__ || __APPLE__
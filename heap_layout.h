@@ -0,0 +1,178 @@
+/***********************************************************************
+ * Header:
+ *    HEAP LAYOUT
+ * Summary:
+ *    Where the nodes of a binary heap live in its container. The
+ *    percolate routines of priority_queue ask the layout for a node's
+ *    parent and children instead of doing the arithmetic themselves.
+ *
+ *    Positions are 1-based heap indices, as in priority_queue. Every
+ *    layout fills positions 1..n in order and every node comes after
+ *    its parent, so push appends and heapify can work backwards.
+ *
+ *    implicit_layout is the usual breadth-first array: a node's children
+ *    are at 2i and 2i+1. Past the cache, each level of a sift is a miss.
+ *
+ *    blocked_layout<Height> cuts the tree below the root into blocks,
+ *    each a pair of sibling subtrees of Height levels, stored
+ *    contiguously. A sift compares both children at every level, so
+ *    keeping siblings together matters as much as keeping a path
+ *    together: here the two children of any node are adjacent, and a
+ *    sift walks Height levels inside one block before it moves to the
+ *    next. A block sized to a cache line or a page costs about one miss
+ *    (or one TLB miss) per Height levels instead of one per level. Each
+ *    leaf of a block has one child block holding both its children.
+ *    The blocks are numbered breadth-first in the tree of blocks and
+ *    filled in that order, so the tree is no more than Height levels
+ *    deeper than a breadth-first heap of the same size.
+ *    blocked_layout<1> is implicit_layout.
+ *
+ *    This will contain the definitions of:
+ *        implicit_layout        : Breadth-first, children at 2i and 2i+1
+ *        blocked_layout         : Sibling subtrees of Height levels stored together
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+namespace custom
+{
+
+/*************************************************
+ * IMPLICIT LAYOUT
+ * The breadth-first array every textbook heap uses.
+ *************************************************/
+struct implicit_layout
+{
+   static size_t left(size_t i)   { return 2 * i;     }
+   static size_t right(size_t i)  { return 2 * i + 1; }
+   static size_t parent(size_t i) { return i / 2;     }   // 0 for the root
+
+   // no node past this one, of the first n, has a child
+   static size_t lastParent(size_t n) { return n / 2; }
+
+   // a walk from a node down to a leaf
+   class cursor
+   {
+   public:
+      explicit cursor(size_t i) : index(i) { }
+      size_t position() const { return index; }
+      size_t left() const     { return 2 * index; }
+      void   down(size_t child) { index = child; }
+   private:
+      size_t index;
+   };
+};
+
+/*************************************************
+ * BLOCKED LAYOUT
+ * Pairs of sibling subtrees of Height levels stored
+ * together. Height 2 puts 6 eight-byte keys in a cache
+ * line; Height 8 puts 510 of them in a 4K page.
+ *************************************************/
+template <int Height>
+struct blocked_layout
+{
+   static_assert(Height >= 1 && Height < 32, "blocked_layout needs a height from 1 to 31");
+
+   static const size_t LEAVES   = (size_t)1 << Height;   // leaves in a block, and child blocks
+   static const size_t BLOCK    = 2 * (LEAVES - 1);      // nodes in a block
+   static const size_t INTERNAL = BLOCK - LEAVES;        // nodes in a block with children there
+
+   // Positions 2 and up are in blocks; within a block, local 0 and 1 are
+   // the two roots and the children of local j are 2j+2 and 2j+3.
+   static size_t left(size_t i)
+   {
+      if (i == 1)
+         return 2;
+      size_t block = (i - 2) / BLOCK;
+      size_t local = (i - 2) - block * BLOCK;
+      if (local < INTERNAL)
+         return i + local + 2;
+      size_t blockChild = block * LEAVES + 1 + (local - INTERNAL);
+      return 2 + blockChild * BLOCK;
+   }
+
+   // siblings are always side by side
+   static size_t right(size_t i) { return left(i) + 1; }
+
+   static size_t parent(size_t i)
+   {
+      if (i <= 3)
+         return i / 2;   // 0 for the root, 1 for its children
+      size_t block = (i - 2) / BLOCK;
+      size_t local = (i - 2) - block * BLOCK;
+      if (local >= 2)
+         return i - local + local / 2 - 1;
+
+      // a root of a block: its parent is a leaf of the parent block
+      size_t blockParent = (block - 1) / LEAVES;
+      size_t leaf = (block - 1) % LEAVES;
+      return 2 + blockParent * BLOCK + INTERNAL + leaf;
+   }
+
+   // parent() of the last node is the largest unless the last node is
+   // a root of a new block; then the last node of the block before it
+   // may have the larger parent
+   static size_t lastParent(size_t n)
+   {
+      if (n < 2)
+         return 0;
+      size_t local = (n - 2) % BLOCK;
+      size_t p = parent(n);
+      if (local >= 2)
+         return p;
+      size_t q = parent(n - local - 1);
+      return p > q ? p : q;
+   }
+
+   // A walk from a node down to a leaf. It carries the block and the
+   // local index along, so each step is a few adds instead of the
+   // divide left() needs. The root acts as the last leaf of a block
+   // numbered -1, whose child block is block 0.
+   class cursor
+   {
+   public:
+      explicit cursor(size_t i) : index(i)
+      {
+         if (i == 1)
+         {
+            block = (size_t)-1;
+            local = BLOCK - 1;
+         }
+         else
+         {
+            block = (i - 2) / BLOCK;
+            local = (i - 2) - block * BLOCK;
+         }
+      }
+      size_t position() const { return index; }
+      size_t left() const
+      {
+         if (local < INTERNAL)
+            return index + local + 2;
+         return 2 + (block * LEAVES + 1 + (local - INTERNAL)) * BLOCK;
+      }
+      void down(size_t child)
+      {
+         size_t right = child - left();   // 0 for the left child, 1 for the right
+         if (local < INTERNAL)
+            local = 2 * local + 2 + right;
+         else
+         {
+            block = block * LEAVES + 1 + (local - INTERNAL);
+            local = right;
+         }
+         index = child;
+      }
+   private:
+      size_t index;   // position in the heap
+      size_t block;   // which block it is in
+      size_t local;   // where in the block
+   };
+};
+
+} // namespace custom
@@ -0,0 +1,265 @@
+/***********************************************************************
+ * Header:
+ *    HEAP TRACE
+ * Summary:
+ *    A compact binary log of the push(key), pop and top calls made on
+ *    a heap, so a workload captured in production can be replayed
+ *    against every heap in the project on identical input.
+ *
+ *    The stream starts with the four bytes "PQTR" and a version byte.
+ *    Each record then starts with a tag byte: the operation in the low
+ *    two bits and, for pop and top, the length of a run of them less
+ *    one in the upper six bits, so a burst of 64 pops is one byte. A
+ *    push is followed by the difference from the previous pushed key,
+ *    zigzag encoded as a LEB128 varint: keys that arrive in roughly
+ *    ascending order, as deadlines and timestamps do, take a byte or two.
+ *
+ *    Keys are logged as uint64_t; the recorder converts with a cast.
+ *
+ *    This will contain the class definitions of:
+ *        trace_writer             : Encodes operations onto a stream
+ *        trace_reader             : Decodes them back, one at a time
+ *        recording_priority_queue : A priority_queue that logs its use
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>      // for uint8_t, uint64_t
+#include <istream>      // for std::istream
+#include <ostream>      // for std::ostream
+#include <stdexcept>    // for std::invalid_argument
+#include "priority_queue.h"
+
+class TestHeapTrace;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * TRACE OP
+ * What a record did to the heap
+ *************************************************/
+enum class trace_op : uint8_t { PUSH = 0, POP = 1, TOP = 2 };
+
+/*************************************************
+ * TRACE WRITER
+ * Appends operations to a stream. Runs of pop or
+ * top are held back until something else arrives,
+ * so call flush() (or let the writer go out of
+ * scope) before reading the stream.
+ *************************************************/
+class trace_writer
+{
+   friend class ::TestHeapTrace; // give the unit test class access to the privates
+public:
+   explicit trace_writer(std::ostream & out) : out(out), lastKey(0), numRun(0), runOp(trace_op::POP)
+   {
+      out.write(MAGIC, 4);
+      out.put((char)VERSION);
+   }
+   ~trace_writer() { flush(); }
+
+   void push(uint64_t key);
+   void pop() { run(trace_op::POP); }
+   void top() { run(trace_op::TOP); }
+   void flush();
+
+   static constexpr const char * MAGIC = "PQTR";
+   static const uint8_t VERSION = 1;
+   static const size_t MAX_RUN = 64;   // longest run one tag can hold
+
+private:
+   void run(trace_op op);
+   void flushRun();
+
+   std::ostream & out;
+   uint64_t lastKey;       // the deltas are from here
+   size_t   numRun;        // pops or tops held back
+   trace_op runOp;         // which of the two they are
+};
+
+/*************************************************
+ * TRACE READER
+ * Reads the operations back in order
+ *************************************************/
+class trace_reader
+{
+   friend class ::TestHeapTrace; // give the unit test class access to the privates
+public:
+   explicit trace_reader(std::istream & in);
+
+   // the next operation, with its key for a push; false at the end
+   bool next(trace_op & op, uint64_t & key);
+
+private:
+   std::istream & in;
+   uint64_t lastKey;       // the deltas are from here
+   size_t   numRun;        // repeats of runOp still to hand out
+   trace_op runOp;
+};
+
+/*************************************************
+ * RECORDING PRIORITY QUEUE
+ * A priority_queue that writes every push, pop and
+ * top to a trace as it serves it. Calls that fail
+ * (top or pop on an empty queue) are not logged.
+ * The parameters are priority_queue's, so the queue
+ * being recorded keeps its layout and stats.
+ *************************************************/
+template <class T, class Container = custom::vector<T>, class Compare = std::less<T>,
+          class Layout = custom::implicit_layout, class Stats = custom::no_stats>
+class recording_priority_queue
+{
+public:
+   recording_priority_queue(trace_writer & trace, const Compare & c = Compare()) : pq(c), trace(&trace) { }
+
+   const T & top() const
+   {
+      const T & t = pq.top();
+      trace->top();
+      return t;
+   }
+   void push(const T & t)
+   {
+      trace->push((uint64_t)t);
+      pq.push(t);
+   }
+   void push(T && t)
+   {
+      trace->push((uint64_t)t);
+      pq.push(std::move(t));
+   }
+   void pop()
+   {
+      if (pq.empty())
+         return;
+      trace->pop();
+      pq.pop();
+   }
+
+   size_t size()  const { return pq.size();  }
+   bool   empty() const { return pq.empty(); }
+
+   stats_snapshot snapshot() const { return pq.snapshot(); }
+
+private:
+   priority_queue<T, Container, Compare, Layout, Stats> pq;
+   trace_writer * trace;
+};
+
+/*****************************************
+ * TRACE WRITER :: PUSH
+ * A tag, then the zigzag delta from the last key
+ ****************************************/
+inline void trace_writer::push(uint64_t key)
+{
+   flushRun();
+   out.put((char)trace_op::PUSH);
+
+   // zigzag: small negative deltas are small numbers too
+   int64_t delta = (int64_t)(key - lastKey);
+   uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+   while (zigzag >= 0x80)
+   {
+      out.put((char)(0x80 | (zigzag & 0x7F)));
+      zigzag >>= 7;
+   }
+   out.put((char)zigzag);
+   lastKey = key;
+}
+
+/*****************************************
+ * TRACE WRITER :: RUN
+ * Add a pop or top to the run held back
+ ****************************************/
+inline void trace_writer::run(trace_op op)
+{
+   if (numRun > 0 && (op != runOp || numRun == MAX_RUN))
+      flushRun();
+   runOp = op;
+   numRun++;
+}
+
+/*****************************************
+ * TRACE WRITER :: FLUSH RUN
+ * Write the run held back as one tag
+ ****************************************/
+inline void trace_writer::flushRun()
+{
+   if (numRun == 0)
+      return;
+   out.put((char)((uint8_t)runOp | (uint8_t)((numRun - 1) << 2)));
+   numRun = 0;
+}
+
+/*****************************************
+ * TRACE WRITER :: FLUSH
+ * Everything so far onto the stream
+ ****************************************/
+inline void trace_writer::flush()
+{
+   flushRun();
+   out.flush();
+}
+
+/*****************************************
+ * TRACE READER :: CONSTRUCTOR
+ * Check the header
+ ****************************************/
+inline trace_reader::trace_reader(std::istream & in) : in(in), lastKey(0), numRun(0), runOp(trace_op::POP)
+{
+   char magic[4] = {};
+   in.read(magic, 4);
+   int version = in.get();
+   if (!in || magic[0] != 'P' || magic[1] != 'Q' || magic[2] != 'T' || magic[3] != 'R')
+      throw std::invalid_argument("trace_reader: not a heap trace");
+   if (version != trace_writer::VERSION)
+      throw std::invalid_argument("trace_reader: unknown trace version");
+}
+
+/*****************************************
+ * TRACE READER :: NEXT
+ * Hand out the rest of a run, or decode a tag
+ ****************************************/
+inline bool trace_reader::next(trace_op & op, uint64_t & key)
+{
+   if (numRun > 0)
+   {
+      numRun--;
+      op = runOp;
+      return true;
+   }
+
+   int tag = in.get();
+   if (tag == std::char_traits<char>::eof())
+      return false;
+
+   op = (trace_op)(tag & 0x3);
+   if (op == trace_op::POP || op == trace_op::TOP)
+   {
+      runOp = op;
+      numRun = (size_t)(tag >> 2);
+      return true;
+   }
+   if (op != trace_op::PUSH || (tag >> 2) != 0)
+      throw std::invalid_argument("trace_reader: bad record");
+
+   uint64_t zigzag = 0;
+   for (int shift = 0; ; shift += 7)
+   {
+      int byte = in.get();
+      if (byte == std::char_traits<char>::eof() || shift > 63)
+         throw std::invalid_argument("trace_reader: truncated push");
+      zigzag |= (uint64_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+         break;
+   }
+   int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+   key = lastKey + (uint64_t)delta;
+   lastKey = key;
+   return true;
+}
+
+} // namespace custom
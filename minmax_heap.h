@@ -0,0 +1,334 @@
+/***********************************************************************
+ * Header:
+ *    MIN-MAX HEAP
+ * Summary:
+ *    A double-ended priority queue: both the largest and the smallest
+ *    element are available in O(1) and either can be removed in
+ *    O(log n). This is for bounded admission, where the queue
+ *    dispatches from the top and evicts from the bottom.
+ *
+ *    Levels of the implicit tree alternate: the root and every even
+ *    level are min levels (each node no larger than its descendants),
+ *    odd levels are max levels (no smaller than its descendants).
+ *    The smallest element is the root; the largest is one of its two
+ *    children.
+ *
+ *    This will contain the class definition of:
+ *        minmax_heap            : A class that represents a Min-Max Heap
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <functional>   // std::less
+#include <stdexcept>    // std::out_of_range
+#include <utility>      // std::swap
+#include "vector.h"     // for default underlying container
+#include "bitops.h"     // for the level of a node
+
+class TestMinMaxHeap;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * MIN-MAX HEAP
+ * top_max/pop_max at one end, top_min/pop_min at the
+ * other. top() and pop() are the max end, as in
+ * priority_queue.
+ *************************************************/
+template<class T, class Container = custom::vector<T>, class Compare = std::less<T>>
+class minmax_heap
+{
+   friend class ::TestMinMaxHeap; // give the unit test class access to the privates
+   template <class TT, class CContainer, class CCompare>
+   friend void swap(minmax_heap<TT, CContainer, CCompare>& lhs, minmax_heap<TT, CContainer, CCompare>& rhs);
+
+public:
+
+   //
+   // construct
+   //
+   minmax_heap(const Compare & c = Compare()) : compare(c) { }
+   template <class Iterator>
+   minmax_heap(Iterator first, Iterator last, const Compare & c = Compare()) : compare(c)
+   {
+      container.reserve(last - first);
+      for (auto it = first; it != last; ++it)
+         container.push_back(*it);
+      heapify();
+   }
+   explicit minmax_heap(const Compare & c, Container && rhs) : container(std::move(rhs)), compare(c) { heapify(); }
+
+   //
+   // Access
+   //
+   const T & top_max() const;
+   const T & top_min() const;
+   const T & top() const { return top_max(); }
+
+   //
+   // Insert
+   //
+   void push(const T & t);
+   void push(T && t);
+
+   //
+   // Remove
+   //
+   void pop_max();
+   void pop_min();
+   void pop() { pop_max(); }
+
+   //
+   // Status
+   //
+   size_t size()  const { return container.size(); }
+   bool empty()   const { return size() == size_t(0); }
+
+private:
+
+   // zero-based index arithmetic
+   static size_t parent(size_t i)     { return (i - 1) / 2; }
+   static size_t firstChild(size_t i) { return 2 * i + 1; }
+   static bool   isMinLevel(size_t i) { return bits::highestBit(i + 1) % 2 == 0; }
+
+   size_t indexMax() const;                   // where the largest element lives
+   void   bubbleUp(size_t index);             // fix the heap after a push
+   template <bool IsMin>
+   void   bubbleUpLevel(size_t index);        // climb by grandparents
+   template <bool IsMin>
+   void   trickleDown(size_t index);          // fix the heap below a hole
+   void   heapify();                          // convert the container in to a heap
+
+   // order as seen from a min level (IsMin) or a max level
+   template <bool IsMin>
+   bool   before(const T & lhs, const T & rhs) const
+   {
+      return IsMin ? compare(lhs, rhs) : compare(rhs, lhs);
+   }
+
+   Container container;       // underlying container (probably a vector)
+   Compare   compare;         // comparision operator
+};
+
+/************************************************
+ * MIN-MAX HEAP :: TOP MAX
+ * Get the largest element.
+ ***********************************************/
+template <class T, class Container, class Compare>
+const T & minmax_heap <T, Container, Compare> :: top_max() const
+{
+   if (!container.empty())
+      return container[indexMax()];
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/************************************************
+ * MIN-MAX HEAP :: TOP MIN
+ * Get the smallest element: the root.
+ ***********************************************/
+template <class T, class Container, class Compare>
+const T & minmax_heap <T, Container, Compare> :: top_min() const
+{
+   if (!container.empty())
+      return container.front();
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/*****************************************
+ * MIN-MAX HEAP :: PUSH
+ * Add a new element, reallocating as necessary
+ ****************************************/
+template <class T, class Container, class Compare>
+void minmax_heap <T, Container, Compare> :: push(const T & t)
+{
+   container.push_back(t);
+   bubbleUp(size() - 1);
+}
+template <class T, class Container, class Compare>
+void minmax_heap <T, Container, Compare> :: push(T && t)
+{
+   container.push_back(std::move(t));
+   bubbleUp(size() - 1);
+}
+
+/**********************************************
+ * MIN-MAX HEAP :: POP MAX
+ * Delete the largest element.
+ **********************************************/
+template <class T, class Container, class Compare>
+void minmax_heap <T, Container, Compare> :: pop_max()
+{
+   using std::swap;
+   if (empty())
+      return;
+
+   size_t index = indexMax();
+   swap(container[index], container[size() - 1]);
+   container.pop_back();
+   if (index < size())
+      trickleDown<false>(index);
+}
+
+/**********************************************
+ * MIN-MAX HEAP :: POP MIN
+ * Delete the smallest element.
+ **********************************************/
+template <class T, class Container, class Compare>
+void minmax_heap <T, Container, Compare> :: pop_min()
+{
+   using std::swap;
+   if (empty())
+      return;
+
+   swap(container[0], container[size() - 1]);
+   container.pop_back();
+   if (!empty())
+      trickleDown<true>(0);
+}
+
+/************************************************
+ * MIN-MAX HEAP :: INDEX MAX
+ * The largest element is the root or the larger of
+ * the root's children.
+ ************************************************/
+template <class T, class Container, class Compare>
+size_t minmax_heap <T, Container, Compare> :: indexMax() const
+{
+   if (size() <= 2)
+      return size() - 1;
+   return compare(container[1], container[2]) ? 2 : 1;
+}
+
+/************************************************
+ * MIN-MAX HEAP :: BUBBLE UP
+ * A new element at INDEX may be out of order with its
+ * parent. Settle which kind of level it belongs on, then
+ * climb through the grandparents of that kind.
+ ************************************************/
+template <class T, class Container, class Compare>
+void minmax_heap <T, Container, Compare> :: bubbleUp(size_t index)
+{
+   using std::swap;
+   if (index == 0)
+      return;
+
+   size_t indexParent = parent(index);
+   if (isMinLevel(index))
+   {
+      if (compare(container[indexParent], container[index]))
+      {
+         swap(container[index], container[indexParent]);
+         bubbleUpLevel<false>(indexParent);
+      }
+      else
+         bubbleUpLevel<true>(index);
+   }
+   else
+   {
+      if (compare(container[index], container[indexParent]))
+      {
+         swap(container[index], container[indexParent]);
+         bubbleUpLevel<true>(indexParent);
+      }
+      else
+         bubbleUpLevel<false>(index);
+   }
+}
+
+/************************************************
+ * MIN-MAX HEAP :: BUBBLE UP LEVEL
+ * Swap with the grandparent while out of order.
+ ************************************************/
+template <class T, class Container, class Compare>
+template <bool IsMin>
+void minmax_heap <T, Container, Compare> :: bubbleUpLevel(size_t index)
+{
+   using std::swap;
+   while (index > 2)
+   {
+      size_t indexGrandparent = parent(parent(index));
+      if (!before<IsMin>(container[index], container[indexGrandparent]))
+         break;
+      swap(container[index], container[indexGrandparent]);
+      index = indexGrandparent;
+   }
+}
+
+/************************************************
+ * MIN-MAX HEAP :: TRICKLE DOWN
+ * The element at INDEX, on a min level (IsMin) or a max
+ * level, may be out of order with its descendants. Move
+ * it down by grandchildren, fixing its parent on the way.
+ ************************************************/
+template <class T, class Container, class Compare>
+template <bool IsMin>
+void minmax_heap <T, Container, Compare> :: trickleDown(size_t index)
+{
+   using std::swap;
+   for (;;)
+   {
+      size_t indexChild = firstChild(index);
+      if (indexChild >= size())
+         return;
+
+      // find the best of the (up to) two children and four grandchildren
+      size_t indexBest = indexChild;
+      if (indexChild + 1 < size() && before<IsMin>(container[indexChild + 1], container[indexBest]))
+         indexBest = indexChild + 1;
+      size_t indexGrandchild = firstChild(indexChild);
+      for (size_t i = indexGrandchild; i < indexGrandchild + 4 && i < size(); i++)
+         if (before<IsMin>(container[i], container[indexBest]))
+            indexBest = i;
+
+      if (!before<IsMin>(container[indexBest], container[index]))
+         return;
+      swap(container[indexBest], container[index]);
+
+      // a child is a leaf of the other kind of level: done
+      if (indexBest <= indexChild + 1)
+         return;
+
+      // a grandchild may now be out of order with its parent
+      size_t indexParent = parent(indexBest);
+      if (before<IsMin>(container[indexParent], container[indexBest]))
+         swap(container[indexParent], container[indexBest]);
+      index = indexBest;
+   }
+}
+
+/************************************************
+ * MIN-MAX HEAP :: HEAPIFY
+ * Turn the container into a min-max heap, bottom up.
+ ************************************************/
+template <class T, class Container, class Compare>
+void minmax_heap <T, Container, Compare> :: heapify()
+{
+   for (size_t i = size() / 2; i-- > 0; )
+   {
+      if (isMinLevel(i))
+         trickleDown<true>(i);
+      else
+         trickleDown<false>(i);
+   }
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two min-max heaps
+ ************************************************/
+template <class T, class Container, class Compare>
+inline void swap(custom::minmax_heap <T, Container, Compare> & lhs,
+                 custom::minmax_heap <T, Container, Compare> & rhs)
+{
+   using std::swap;
+   swap(lhs.container, rhs.container);
+   swap(lhs.compare, rhs.compare);
+}
+
+} // namespace custom
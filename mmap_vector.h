@@ -0,0 +1,405 @@
+/***********************************************************************
+ * Header:
+ *    MMAP VECTOR
+ * Summary:
+ *    A vector of trivially copyable T that lives in a memory-mapped
+ *    file, for heaps bigger than RAM: the kernel pages it in and out.
+ *    The file is grown sparse with ftruncate and the mapping follows
+ *    with mremap, so growing never copies the elements. The element
+ *    count is kept in a header page at the front of the file, so an
+ *    existing file reopens as it was left; a heap built in one can be
+ *    handed back to priority_queue with already_heap and no heapify.
+ *
+ *    Default-constructed, it maps anonymous memory instead of a file:
+ *    the same growth without the copy, but nothing kept.
+ *
+ *    The mapping is advised for how a heap reads it (see
+ *    access_pattern): sift-downs jump about, so read-ahead is turned
+ *    off, but the first levels are touched by every operation and are
+ *    asked for up front. A bulk load or a heapify wants the opposite;
+ *    call advise(access_pattern::sequential) around it.
+ *
+ *    POSIX only; mremap where the kernel has it.
+ *
+ *    This will contain the class definition of:
+ *        mmap_vector            : A file-backed vector
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>        // for errno
+#include <cstdint>       // for uint32_t, uint64_t
+#include <cstring>       // for std::memcpy
+#include <stdexcept>     // for std::invalid_argument
+#include <string>        // for std::string
+#include <system_error>  // for std::system_error
+#include <type_traits>   // for std::is_trivially_copyable
+#include <utility>       // for std::swap
+
+#include <fcntl.h>       // for open
+#include <sys/mman.h>    // for mmap, mremap, madvise
+#include <sys/stat.h>    // for fstat
+#include <unistd.h>      // for ftruncate, close
+
+class TestMmapVector;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * ACCESS PATTERN
+ * How the elements are about to be read
+ *************************************************/
+enum class access_pattern
+{
+   heap,         // scattered, but the front is hot
+   sequential,   // front to back: read ahead
+   random        // scattered everywhere
+};
+
+/*************************************************
+ * MMAP VECTOR
+ * The part of vector a heap needs, in a mapping
+ *************************************************/
+template <class T>
+class mmap_vector
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "mmap_vector holds its elements as raw bytes in a file");
+   friend class ::TestMmapVector; // give the unit test class access to the privates
+   template <class TT>
+   friend void swap(mmap_vector<TT> & lhs, mmap_vector<TT> & rhs);
+
+public:
+   //
+   // Construct
+   //
+   mmap_vector();
+   explicit mmap_vector(const std::string & path, access_pattern pattern = access_pattern::heap);
+   mmap_vector(mmap_vector && rhs);
+   mmap_vector(const mmap_vector &) = delete;
+   ~mmap_vector();
+
+   mmap_vector & operator = (mmap_vector && rhs);
+   mmap_vector & operator = (const mmap_vector &) = delete;
+
+   //
+   // Access
+   //
+         T & operator [] (size_t index)       { return begin()[index]; }
+   const T & operator [] (size_t index) const { return begin()[index]; }
+         T & front()       { return begin()[0]; }
+   const T & front() const { return begin()[0]; }
+         T & back()        { return begin()[size() - 1]; }
+   const T & back()  const { return begin()[size() - 1]; }
+         T * begin()       { return (T *)((char *)map + HEADER_BYTES); }
+   const T * begin() const { return (const T *)((const char *)map + HEADER_BYTES); }
+         T * end()         { return begin() + size(); }
+   const T * end()   const { return begin() + size(); }
+
+   //
+   // Insert
+   //
+   void push_back(const T & t);
+   void reserve(size_t newCapacity);
+
+   //
+   // Remove
+   //
+   void pop_back() { if (!empty()) header().numElements--; }
+   void clear()    { if (map) header().numElements = 0; }
+
+   //
+   // Status
+   //
+   size_t size()     const { return map ? (size_t)header().numElements : 0; }
+   size_t capacity() const { return numCapacity; }
+   bool   empty()    const { return size() == 0; }
+
+   //
+   // Tuning
+   //
+   void advise(access_pattern pattern);
+   void flush();
+
+   // bytes before the first element: one page, so elements are page aligned
+   static const size_t HEADER_BYTES = 4096;
+   // how much of the front advise(heap) asks for: the top 17 or so levels
+   static const size_t HOT_BYTES = (size_t)1 << 20;
+
+private:
+   // the first bytes of the file
+   struct Header
+   {
+      char     magic[4];
+      uint32_t version;
+      uint64_t elementSize;
+      uint64_t numElements;
+   };
+
+         Header & header()       { return *(Header *)map; }
+   const Header & header() const { return *(const Header *)map; }
+
+   void start(size_t newCapacity);            // a fresh mapping and header
+   void remap(size_t newCapacity);
+   static void fail(const char * what) { throw std::system_error(errno, std::generic_category(), what); }
+
+   int            fd;            // the file, or -1 for anonymous memory
+   void *         map;           // header, then the elements
+   size_t         mapBytes;      // length of the mapping
+   size_t         numCapacity;   // elements that fit in the mapping
+   access_pattern pattern;       // the last advice given
+};
+
+/*****************************************
+ * MMAP VECTOR :: DEFAULT CONSTRUCTOR
+ * Anonymous memory, grown the same way
+ ****************************************/
+template <class T>
+mmap_vector<T>::mmap_vector() : fd(-1), map(nullptr), mapBytes(0), numCapacity(0), pattern(access_pattern::heap)
+{
+   start(0);
+}
+
+/*****************************************
+ * MMAP VECTOR :: FILE CONSTRUCTOR
+ * Open PATH, creating it if it is not there.
+ * An existing file must hold elements of this size.
+ ****************************************/
+template <class T>
+mmap_vector<T>::mmap_vector(const std::string & path, access_pattern pattern)
+   : fd(-1), map(nullptr), mapBytes(0), numCapacity(0), pattern(pattern)
+{
+   fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+   if (fd < 0)
+      fail("mmap_vector: open");
+
+   struct stat info;
+   if (::fstat(fd, &info) != 0)
+   {
+      ::close(fd);
+      fail("mmap_vector: fstat");
+   }
+
+   size_t fileBytes = (size_t)info.st_size;
+   if (fileBytes == 0)
+   {
+      try
+      {
+         start(0);
+      }
+      catch (...)
+      {
+         ::close(fd);
+         throw;
+      }
+      return;
+   }
+
+   Header existing;
+   if (fileBytes < HEADER_BYTES || ::pread(fd, &existing, sizeof(existing), 0) != (ssize_t)sizeof(existing) ||
+       std::memcmp(existing.magic, "PQMM", 4) != 0 || existing.elementSize != sizeof(T) ||
+       existing.numElements > (fileBytes - HEADER_BYTES) / sizeof(T))
+   {
+      ::close(fd);
+      throw std::invalid_argument("mmap_vector: " + path + " does not hold elements of this type");
+   }
+   try
+   {
+      remap((fileBytes - HEADER_BYTES) / sizeof(T));
+   }
+   catch (...)
+   {
+      ::close(fd);
+      throw;
+   }
+}
+
+/*****************************************
+ * MMAP VECTOR :: MOVE CONSTRUCTOR
+ * Take the mapping. RHS is left with none: empty,
+ * and it maps anonymous memory if pushed to again.
+ ****************************************/
+template <class T>
+mmap_vector<T>::mmap_vector(mmap_vector && rhs)
+   : fd(rhs.fd), map(rhs.map), mapBytes(rhs.mapBytes), numCapacity(rhs.numCapacity), pattern(rhs.pattern)
+{
+   rhs.fd = -1;
+   rhs.map = nullptr;
+   rhs.mapBytes = 0;
+   rhs.numCapacity = 0;
+}
+
+/*****************************************
+ * MMAP VECTOR :: DESTRUCTOR
+ * Unmap and close. The kernel writes the
+ * dirty pages back in its own time.
+ ****************************************/
+template <class T>
+mmap_vector<T>::~mmap_vector()
+{
+   if (map)
+      ::munmap(map, mapBytes);
+   if (fd >= 0)
+      ::close(fd);
+}
+
+/*****************************************
+ * MMAP VECTOR :: MOVE ASSIGNMENT
+ ****************************************/
+template <class T>
+mmap_vector<T> & mmap_vector<T>::operator = (mmap_vector && rhs)
+{
+   if (this != &rhs)
+   {
+      mmap_vector moved(std::move(rhs));
+      swap(*this, moved);
+   }
+   return *this;
+}
+
+/*****************************************
+ * MMAP VECTOR :: PUSH BACK
+ * Double the capacity when full
+ ****************************************/
+template <class T>
+void mmap_vector<T>::push_back(const T & t)
+{
+   if (size() == capacity())
+      reserve(capacity() ? capacity() * 2 : HOT_BYTES / sizeof(T));
+   begin()[size()] = t;
+   header().numElements++;
+}
+
+/*****************************************
+ * MMAP VECTOR :: RESERVE
+ * Grow the file and the mapping; never shrinks
+ ****************************************/
+template <class T>
+void mmap_vector<T>::reserve(size_t newCapacity)
+{
+   if (map == nullptr)
+      start(newCapacity);
+   else if (newCapacity > numCapacity)
+      remap(newCapacity);
+}
+
+/*****************************************
+ * MMAP VECTOR :: START
+ * Map room for NEW CAPACITY elements behind a
+ * header that says there are none yet
+ ****************************************/
+template <class T>
+void mmap_vector<T>::start(size_t newCapacity)
+{
+   remap(newCapacity);
+   std::memcpy(header().magic, "PQMM", 4);
+   header().version = 1;
+   header().elementSize = sizeof(T);
+   header().numElements = 0;
+}
+
+/*****************************************
+ * MMAP VECTOR :: REMAP
+ * Size the file (sparse: no blocks until written)
+ * and the mapping for NEW CAPACITY elements
+ ****************************************/
+template <class T>
+void mmap_vector<T>::remap(size_t newCapacity)
+{
+   size_t newBytes = HEADER_BYTES + newCapacity * sizeof(T);
+   if (fd >= 0)
+   {
+      struct stat info;
+      if (::fstat(fd, &info) != 0)
+         fail("mmap_vector: fstat");
+      if ((size_t)info.st_size < newBytes && ::ftruncate(fd, (off_t)newBytes) != 0)
+         fail("mmap_vector: ftruncate");
+   }
+
+   int flags = fd >= 0 ? MAP_SHARED : MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+   void * newMap;
+   if (map == nullptr)
+      newMap = ::mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+   else
+   {
+#ifdef MREMAP_MAYMOVE
+      newMap = ::mremap(map, mapBytes, newBytes, MREMAP_MAYMOVE);
+#else
+      // no mremap: map the file again; anonymous memory must be copied
+      newMap = ::mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+      if (newMap != MAP_FAILED)
+      {
+         if (fd < 0)
+            std::memcpy(newMap, map, mapBytes);
+         ::munmap(map, mapBytes);
+      }
+#endif
+   }
+   if (newMap == MAP_FAILED)
+      fail("mmap_vector: mmap");
+
+   map = newMap;
+   mapBytes = newBytes;
+   numCapacity = newCapacity;
+   advise(pattern);
+}
+
+/*****************************************
+ * MMAP VECTOR :: ADVISE
+ * Tell the kernel how the elements will be read
+ ****************************************/
+template <class T>
+void mmap_vector<T>::advise(access_pattern newPattern)
+{
+   pattern = newPattern;
+   if (map == nullptr)
+      return;
+   switch (pattern)
+   {
+   case access_pattern::heap:
+      ::madvise(map, mapBytes, MADV_RANDOM);
+      ::madvise(map, mapBytes < HEADER_BYTES + HOT_BYTES ? mapBytes : HEADER_BYTES + HOT_BYTES,
+                MADV_WILLNEED);
+      break;
+   case access_pattern::sequential:
+      ::madvise(map, mapBytes, MADV_SEQUENTIAL);
+      break;
+   case access_pattern::random:
+      ::madvise(map, mapBytes, MADV_RANDOM);
+      break;
+   }
+}
+
+/*****************************************
+ * MMAP VECTOR :: FLUSH
+ * Write everything to the file now
+ ****************************************/
+template <class T>
+void mmap_vector<T>::flush()
+{
+   if (fd >= 0 && ::msync(map, mapBytes, MS_SYNC) != 0)
+      fail("mmap_vector: msync");
+}
+
+/*****************************************
+ * SWAP
+ * Exchange mappings
+ ****************************************/
+template <class T>
+inline void swap(mmap_vector<T> & lhs, mmap_vector<T> & rhs)
+{
+   std::swap(lhs.fd, rhs.fd);
+   std::swap(lhs.map, rhs.map);
+   std::swap(lhs.mapBytes, rhs.mapBytes);
+   std::swap(lhs.numCapacity, rhs.numCapacity);
+   std::swap(lhs.pattern, rhs.pattern);
+}
+
+} // namespace custom
+
+#endif // __unix__ || __APPLE__
@@ -0,0 +1,59 @@
+/***********************************************************************
+ * Header:
+ *    PREFETCH
+ * Summary:
+ *    Portable software prefetch hints. A sift down knows which
+ *    elements the next level will compare before it has finished
+ *    comparing this one, so it can start those loads early and
+ *    overlap them with the work at hand. A hint never faults and is
+ *    dropped on compilers that have no way to express it.
+ *
+ *    This will contain the definitions of:
+ *        prefetch               : Start loading the line holding an address
+ *        prefetchRange          : The same, for every line of a range
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace custom
+{
+
+static const size_t CACHE_LINE = 64;
+
+/*****************************************
+ * PREFETCH
+ * Bring the cache line holding P toward the core, for a read.
+ ****************************************/
+inline void prefetch(const void * p)
+{
+#if defined(__GNUC__)
+   __builtin_prefetch(p, 0 /*read*/, 3 /*keep in all levels*/);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+   _mm_prefetch((const char *)p, _MM_HINT_T0);
+#else
+   (void)p;
+#endif
+}
+
+/*****************************************
+ * PREFETCH RANGE
+ * Prefetch every cache line that [P, P + NUM_BYTES) touches.
+ ****************************************/
+inline void prefetchRange(const void * p, size_t numBytes)
+{
+   uintptr_t line = (uintptr_t)p & ~(uintptr_t)(CACHE_LINE - 1);
+   uintptr_t end  = (uintptr_t)p + numBytes;
+   for (; line < end; line += CACHE_LINE)
+      prefetch((const void *)line);
+}
+
+} // namespace custom
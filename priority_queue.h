@@ -20,23 +20,58 @@
 #pragma once
 
 #include <cassert>
+#include <type_traits>   // for std::is_trivially_copyable, std::void_t
+#include "relocate.h"    // for moving items by their bytes
 #include "vector.h" // for default underlying container
+#include "heap_layout.h" // for the default layout of the nodes
+#include "prefetch.h"    // for prefetching the next level of a sift
+#include "container_stats.h" // for the no_stats default
 
 class TestPQueue;    // forward declaration for unit test class
 
 namespace custom
 {
 
+template <class T, class Compare>
+class external_priority_queue;   // writes its buffer out in place (see external_priority_queue.h)
+
+/*************************************************
+ * ALREADY HEAP
+ * Tag for handing priority_queue a container that
+ * already holds a heap in the order Compare gives
+ * it, such as one reopened from a file: it is
+ * taken as it is, with no heapify.
+ *************************************************/
+struct already_heap_t { explicit already_heap_t() = default; };
+inline constexpr already_heap_t already_heap{};
+
+/*************************************************
+ * CAN SHRINK TO
+ * Whether a container gives back capacity with
+ * shrink_to(n), as custom::vector does. One that
+ * cannot, such as mmap_vector, is never shrunk.
+ *************************************************/
+template <class Container, class = void>
+struct can_shrink_to : std::false_type { };
+template <class Container>
+struct can_shrink_to<Container, std::void_t<decltype(std::declval<Container&>().shrink_to(size_t()))>> : std::true_type { };
+
 /*************************************************
  * P QUEUE
- * Create a priority queue.
+ * Create a priority queue. Layout decides where each
+ * node lives in the container (see heap_layout.h).
+ * Stats hears about every operation (see
+ * container_stats.h); the default ignores them.
  *************************************************/
-template<class T, class Container = custom::vector<T>, class Compare = std::less<T>>
+template<class T, class Container = custom::vector<T>, class Compare = std::less<T>, class Layout = custom::implicit_layout, class Stats = custom::no_stats>
 class priority_queue
 {
    friend class ::TestPQueue; // give the unit test class access to the privates
-   template <class TT, class CContainer, class CCompare>
-   friend void swap(priority_queue<TT, CContainer, CCompare>& lhs, priority_queue<TT, CContainer, CCompare>& rhs);
+   friend struct custom::serializer;
+   template <class TT, class CCompare>
+   friend class custom::external_priority_queue;
+   template <class TT, class CContainer, class CCompare, class LLayout, class SStats>
+   friend void swap(priority_queue<TT, CContainer, CCompare, LLayout, SStats>& lhs, priority_queue<TT, CContainer, CCompare, LLayout, SStats>& rhs);
 
 public:
 
@@ -44,18 +79,21 @@ public:
    // construct
    //
    priority_queue(const Compare& c = Compare()) : compare(c) { }
-   priority_queue(const priority_queue& rhs, const Compare& c = Compare()) : compare(c) { container = rhs.container; }
-   priority_queue(priority_queue&& rhs, const Compare& c = Compare()) : compare(c) { container = std::move(rhs.container); }
+   priority_queue(const priority_queue& rhs, const Compare& c = Compare()) : compare(c), prefetchThreshold(rhs.prefetchThreshold),
+      shrinkDivisor(rhs.shrinkDivisor), shrinkMinCapacity(rhs.shrinkMinCapacity) { container = rhs.container; }
+   priority_queue(priority_queue&& rhs, const Compare& c = Compare()) : compare(c), prefetchThreshold(rhs.prefetchThreshold),
+      shrinkDivisor(rhs.shrinkDivisor), shrinkMinCapacity(rhs.shrinkMinCapacity) { container = std::move(rhs.container); }
    template <class Iterator>
    priority_queue(Iterator first, Iterator last, const Compare& c = Compare()) : compare(c)
    {
       container.reserve(last - first);
       for (auto it = first; it != last; ++it)
-         push(*it);
+         container.push_back(*it);
       heapify();
    }
-   explicit priority_queue(const Compare& c, Container&& rhs) : compare(c), container(std::move(rhs)) { heapify(); }
-   explicit priority_queue(const Compare& c, Container& rhs) : compare(c), container(rhs) { heapify(); }
+   explicit priority_queue(const Compare& c, Container&& rhs) : container(std::move(rhs)), compare(c) { heapify(); }
+   explicit priority_queue(const Compare& c, Container& rhs) : container(rhs), compare(c) { heapify(); }
+   priority_queue(already_heap_t, const Compare& c, Container&& rhs) : container(std::move(rhs)), compare(c) { }
    ~priority_queue() { }
 
    //
@@ -79,22 +117,52 @@ public:
    //
    size_t size()  const { return container.size(); }
    bool empty()   const { return size() == size_t(0);}
+   stats_snapshot snapshot() const { return stats.snapshot(); }
+
+   //
+   // Tuning
+   //
+   void set_prefetch_threshold(size_t numElements) { prefetchThreshold = numElements; }
+   // On by default: pop() gives memory back once the queue falls under
+   // capacity / divisor, from minCapacity (1 MB of T) up. A queue that
+   // used to keep its largest capacity for good must pass 0 to keep it.
+   void set_shrink_policy(size_t divisor, size_t minCapacity = SHRINK_BYTES / sizeof(T))
+   {
+      shrinkDivisor = divisor;
+      shrinkMinCapacity = minCapacity;
+   }
 
 private:
 
+   // Where prefetching the grandchildren starts to pay, from BenchPrefetch.
+   // Below it the heap is mostly in cache and the hint is overhead.
+   static const size_t PREFETCH_BYTES = (size_t)8 << 20;
+
+   // Below this much capacity a pop never shrinks: the memory is not
+   // worth a reallocation, and the queue may well grow right back.
+   static const size_t SHRINK_BYTES = (size_t)1 << 20;
+
+   void shrinkIfSparse();                     // give back capacity after a burst
+
    void heapify();                            // convert the container in to a heap
    bool percolateDown(size_t indexHeap);      // fix heap from index down. This is a heap index!
+   bool percolateDownBranchless(size_t indexHeap); // the same, moving a hole instead of swapping
+   void prefetchGrandchildren(const typename Layout::cursor & node) const;
 
    Container container;       // underlying container (probably a vector)
    Compare   compare;         // comparision operator
+   Stats     stats;           // what has been done to this queue, if anyone asks
+   size_t    prefetchThreshold = PREFETCH_BYTES / sizeof(T); // prefetch when the heap is bigger
+   size_t    shrinkDivisor = 4;                               // shrink below capacity / this; 0 never
+   size_t    shrinkMinCapacity = SHRINK_BYTES / sizeof(T);    // and only from this much capacity
 };
 
 /************************************************
  * P QUEUE :: TOP
  * Get the maximum item from the heap: the top item.
  ***********************************************/
-template <class T, class Container, class Compare>
-const T & priority_queue <T, Container, Compare> :: top() const
+template <class T, class Container, class Compare, class Layout, class Stats>
+const T & priority_queue <T, Container, Compare, Layout, Stats> :: top() const
 {
    if (!container.empty()) // test to see if exeption needs thrown
       return container.front();
@@ -106,35 +174,78 @@ const T & priority_queue <T, Container, Compare> :: top() const
  * P QUEUE :: POP
  * Delete the top item from the heap.
  **********************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: pop()
+template <class T, class Container, class Compare, class Layout, class Stats>
+void priority_queue <T, Container, Compare, Layout, Stats> :: pop()
 {
    using std::swap;
-   if (!empty())
-      swap(container[0], container[size() - 1]);
+   if (empty())
+      return;
+   auto begin = stats.start();
+   swap(container[0], container[size() - 1]);
+   stats.onPop();
    container.pop_back();
    percolateDown(1);
+   shrinkIfSparse();
+   stats.popTook(begin);
+}
+
+/**********************************************
+ * P QUEUE :: SHRINK IF SPARSE
+ * A queue that spiked to millions and settled at
+ * thousands would otherwise keep the spike's memory
+ * for good. Once it is under a quarter full (see
+ * set_shrink_policy), cut the capacity to twice the
+ * size: it must halve again before the next shrink,
+ * or double before the next growth, so a queue
+ * hovering at one size does not reallocate back and
+ * forth.
+ **********************************************/
+template <class T, class Container, class Compare, class Layout, class Stats>
+void priority_queue <T, Container, Compare, Layout, Stats> :: shrinkIfSparse()
+{
+   if constexpr (can_shrink_to<Container>::value)
+   {
+      size_t capacity = container.capacity();
+      if (shrinkDivisor && capacity >= shrinkMinCapacity && size() < capacity / shrinkDivisor)
+      {
+         container.shrink_to(size() * 2);
+         if (size() > 0)      // shrinking to nothing only frees the buffer
+            stats.onRealloc();
+      }
+   }
 }
 
 /*****************************************
  * P QUEUE :: PUSH
  * Add a new element to the heap, reallocating as necessary
  ****************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: push(const T & t)
+template <class T, class Container, class Compare, class Layout, class Stats>
+void priority_queue <T, Container, Compare, Layout, Stats> :: push(const T & t)
 {
+   auto begin = stats.start();
+   if (container.size() == container.capacity())
+      stats.onRealloc();
    container.push_back(t);
-   size_t i = (container.size()+1) / 2;
+   size_t i = Layout::parent(container.size());
    while (i > 0 && percolateDown(i))
-      i /= 2;
+      i = Layout::parent(i);
+   stats.onPush();
+   stats.onSize(container.size());
+   stats.pushTook(begin);
 }
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: push(T && t)
+template <class T, class Container, class Compare, class Layout, class Stats>
+void priority_queue <T, Container, Compare, Layout, Stats> :: push(T && t)
 {
+   auto begin = stats.start();
+   if (container.size() == container.capacity())
+      stats.onRealloc();
    container.push_back(std::move(t));
-   size_t i = (container.size()+1) / 2;
+   size_t i = Layout::parent(container.size());
    while (i > 0 && percolateDown(i))
-      i /= 2;
+      i = Layout::parent(i);
+   stats.onPush();
+   stats.onSize(container.size());
+   stats.pushTook(begin);
 }
 
 /************************************************
@@ -143,50 +254,149 @@ void priority_queue <T, Container, Compare> :: push(T && t)
  * order. Take care of that little detail!
  * Return TRUE if anything changed.
  ************************************************/
-template <class T, class Container, class Compare>
-bool priority_queue <T, Container, Compare> :: percolateDown(size_t indexHeap)
+template <class T, class Container, class Compare, class Layout, class Stats>
+bool priority_queue <T, Container, Compare, Layout, Stats> :: percolateDown(size_t indexHeap)
 {
+   if constexpr (custom::is_trivially_relocatable<T>::value)
+      return percolateDownBranchless(indexHeap);
+
    using std::swap;
-   size_t indexLeft  = 2 * indexHeap;
-   size_t indexRight = indexLeft + 1;
-   size_t indexBigger = indexHeap;
+   bool changed = false;
+   bool prefetching = size() > prefetchThreshold;
+   for (typename Layout::cursor node(indexHeap); ; changed = true)
+   {
+      size_t indexLeft  = node.left();
+      size_t indexRight = indexLeft + 1;
+      size_t indexBigger;
 
-   if (indexRight <= size() && compare(container[indexLeft - 1], container[indexRight - 1]))
-      indexBigger = indexRight;
-   else
-      indexBigger = indexLeft;
+      if (prefetching && indexRight <= size())
+         prefetchGrandchildren(node);
+
+      if (indexRight <= size() && compare(container[indexLeft - 1], container[indexRight - 1]))
+         indexBigger = indexRight;
+      else
+         indexBigger = indexLeft;
+      stats.onCompare((indexRight <= size()) + (indexBigger <= size()));
+
+      if (indexBigger > size() || !compare(container[node.position() - 1], container[indexBigger - 1]))
+         return changed;
+      swap(container[node.position() - 1], container[indexBigger - 1]);
+      node.down(indexBigger);
+      stats.onSift(1);
+   }
+}
+
+/************************************************
+ * P QUEUE :: PERCOLATE DOWN BRANCHLESS
+ * For trivially relocatable items. Which child is
+ * bigger is a coin toss on random keys, so add the
+ * comparison to the index rather than branch on it;
+ * the compiler turns that into a setcc or cmov. The
+ * item being sifted is held aside and the bigger child
+ * moves up into the hole, one relocation per level
+ * instead of a three-move swap. The heap comes out the
+ * same as with percolateDown.
+ ************************************************/
+template <class T, class Container, class Compare, class Layout, class Stats>
+bool priority_queue <T, Container, Compare, Layout, Stats> :: percolateDownBranchless(size_t indexHeap)
+{
+   size_t num = size();
+   bool prefetching = num > prefetchThreshold;
+   typename Layout::cursor node(indexHeap);
+   if (node.left() > num)
+      return false;
 
-   if (indexBigger <= size() && compare(container[indexHeap - 1], container[indexBigger - 1]))
+   custom::held<T> hole(container[indexHeap - 1]);
+   const T & item = hole.get();
+   size_t indexLeft = node.left();
+
+   try
    {
-      swap(container[indexHeap - 1], container[indexBigger - 1]);
-      percolateDown(indexBigger);
-      return true;
+      // every node with two children
+      while (indexLeft < num)
+      {
+         if (prefetching)
+            prefetchGrandchildren(node);
+         size_t indexBigger = indexLeft +
+            (size_t)compare(container[indexLeft - 1], container[indexLeft]);
+         stats.onCompare(2);
+         if (!compare(item, container[indexBigger - 1]))
+            break;
+         custom::relocate_one(container[node.position() - 1], container[indexBigger - 1]);
+         node.down(indexBigger);
+         stats.onSift(1);
+         indexLeft = node.left();
+      }
+
+      // the last parent may have a left child only
+      if (indexLeft == num)
+      {
+         stats.onCompare(1);
+         if (compare(item, container[indexLeft - 1]))
+         {
+            custom::relocate_one(container[node.position() - 1], container[indexLeft - 1]);
+            node.down(indexLeft);
+            stats.onSift(1);
+         }
+      }
    }
-   return false;
+   catch (...)
+   {
+      // a throwing compare: fill the hole so every element has one home
+      hole.put(container[node.position() - 1]);
+      throw;
+   }
+
+   if (node.position() == indexHeap)
+      return false;
+   hole.put(container[node.position() - 1]);
+   return true;
+}
+
+/************************************************
+ * P QUEUE :: PREFETCH GRANDCHILDREN
+ * Whichever child of NODE wins, its children are
+ * compared next. Start both pairs loading now.
+ ************************************************/
+template <class T, class Container, class Compare, class Layout, class Stats>
+void priority_queue <T, Container, Compare, Layout, Stats> :: prefetchGrandchildren(const typename Layout::cursor & node) const
+{
+   size_t indexLeft = node.left();
+   typename Layout::cursor grandLeft(node);
+   typename Layout::cursor grandRight(node);
+   grandLeft.down(indexLeft);
+   grandRight.down(indexLeft + 1);
+   if (grandLeft.left() <= size())
+      prefetch(&container[grandLeft.left() - 1]);
+   if (grandRight.left() < size())
+      prefetch(&container[grandRight.left()]);
 }
 
 /************************************************
  * P QUEUE :: HEAPIFY
  * Turn the container into a heap.
  ************************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> ::heapify()
+template <class T, class Container, class Compare, class Layout, class Stats>
+void priority_queue <T, Container, Compare, Layout, Stats> ::heapify()
 {
-   for (int i = container.size() / 2; i >= 0; i--)
-      percolateDown(i + 1); // i is actual index, add 1 so it is a heap index
+   for (size_t i = Layout::lastParent(container.size()) + 1; i > 0; i--)
+      percolateDown(i); // i is a heap index
 }
 
 /************************************************
  * SWAP
  * Swap the contents of two priority queues
  ************************************************/
-template <class T, class Container, class Compare>
-inline void swap(custom::priority_queue <T, Container, Compare> & lhs,
-                 custom::priority_queue <T, Container, Compare> & rhs)
+template <class T, class Container, class Compare, class Layout, class Stats>
+inline void swap(custom::priority_queue <T, Container, Compare, Layout, Stats> & lhs,
+                 custom::priority_queue <T, Container, Compare, Layout, Stats> & rhs)
 {
    //using std::swap;
    swap(lhs.container, rhs.container);
    swap(lhs.compare, rhs.compare);
+   std::swap(lhs.prefetchThreshold, rhs.prefetchThreshold);
+   std::swap(lhs.shrinkDivisor, rhs.shrinkDivisor);
+   std::swap(lhs.shrinkMinCapacity, rhs.shrinkMinCapacity);
 }
 
 };
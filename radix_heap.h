@@ -0,0 +1,228 @@
+/***********************************************************************
+ * Header:
+ *    RADIX HEAP
+ * Summary:
+ *    A monotone priority queue for unsigned integer keys. The smallest
+ *    key is at the top and, once top() or pop() has reached it, no key
+ *    smaller than it may be pushed. That is the access pattern of
+ *    Dijkstra on integer weights and of discrete event simulation.
+ *
+ *    Bucket 0 holds keys equal to the last key popped; bucket i holds
+ *    keys whose highest bit differing from it is bit i-1. When bucket 0
+ *    runs dry the lowest non-empty bucket is redistributed around its
+ *    minimum, and every element in it drops to a lower bucket. Each
+ *    element therefore moves at most once per bit of key, and no
+ *    comparator is ever called.
+ *
+ *    This will contain the class definition of:
+ *        radix_key              : Default key extractor (T is the key)
+ *        radix_heap             : A class that represents a Radix Heap
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>   // std::out_of_range
+#include <utility>     // std::swap
+#include "vector.h"    // for the buckets
+#include "bitops.h"    // for find-first-set
+
+class TestRadixHeap;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * RADIX KEY
+ * Fetch the unsigned key from an element. The default
+ * treats the element itself as the key.
+ *************************************************/
+template <class T>
+struct radix_key
+{
+   uint64_t operator () (const T & t) const { return static_cast<uint64_t>(t); }
+};
+
+/*************************************************
+ * RADIX HEAP
+ * Smallest key first, with keys pushed never below
+ * the last key seen by top() or pop().
+ *************************************************/
+template <class T, class Key = custom::radix_key<T>>
+class radix_heap
+{
+   friend class ::TestRadixHeap; // give the unit test class access to the privates
+   template <class TT, class KKey>
+   friend void swap(radix_heap<TT, KKey>& lhs, radix_heap<TT, KKey>& rhs);
+
+public:
+
+   //
+   // construct
+   //
+   radix_heap(const Key & k = Key()) :
+      buckets(NUM_BUCKETS, custom::vector<T>()),
+      occupied(0), lastKey(0), numElements(0), key(k) { }
+   template <class Iterator>
+   radix_heap(Iterator first, Iterator last, const Key & k = Key()) : radix_heap(k)
+   {
+      for (auto it = first; it != last; ++it)
+         push(*it);
+   }
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   void  push(const T & t);
+   void  push(T && t);
+
+   //
+   // Remove
+   //
+   void  pop();
+
+   //
+   // Status
+   //
+   size_t size()  const { return numElements; }
+   bool empty()   const { return size() == size_t(0); }
+
+private:
+
+   static const int NUM_BUCKETS = 65;   // bucket 0 plus one per bit of key
+
+   // which bucket a key belongs in, relative to the last key popped
+   int bucketOf(uint64_t k) const
+   {
+      return (k == lastKey) ? 0 : 1 + bits::highestBit(k ^ lastKey);
+   }
+   void settle() const;                 // refill bucket 0 if it is empty
+
+   // settle() runs from top(), so the buckets are rearranged lazily
+   mutable custom::vector<custom::vector<T>> buckets;
+   mutable uint64_t occupied;           // bit i-1 set when bucket i is non-empty
+   mutable uint64_t lastKey;            // the last key popped (or about to be)
+   size_t numElements;                  // number of elements in all buckets
+   Key    key;                          // key extractor
+};
+
+/************************************************
+ * RADIX HEAP :: TOP
+ * Get the element with the smallest key.
+ ***********************************************/
+template <class T, class Key>
+const T & radix_heap <T, Key> :: top() const
+{
+   if (!empty())
+   {
+      settle();
+      return buckets[0].back();
+   }
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/*****************************************
+ * RADIX HEAP :: PUSH
+ * Add a new element. Its key may not be smaller
+ * than the last key seen by top() or pop().
+ ****************************************/
+template <class T, class Key>
+void radix_heap <T, Key> :: push(const T & t)
+{
+   uint64_t k = key(t);
+   assert(k >= lastKey);
+   int b = bucketOf(k);
+   buckets[b].push_back(t);
+   if (b > 0)
+      occupied |= (uint64_t)1 << (b - 1);
+   numElements++;
+}
+template <class T, class Key>
+void radix_heap <T, Key> :: push(T && t)
+{
+   uint64_t k = key(t);
+   assert(k >= lastKey);
+   int b = bucketOf(k);
+   buckets[b].push_back(std::move(t));
+   if (b > 0)
+      occupied |= (uint64_t)1 << (b - 1);
+   numElements++;
+}
+
+/**********************************************
+ * RADIX HEAP :: POP
+ * Delete the element with the smallest key.
+ **********************************************/
+template <class T, class Key>
+void radix_heap <T, Key> :: pop()
+{
+   if (empty())
+      return;
+
+   settle();
+   buckets[0].pop_back();
+   numElements--;
+}
+
+/************************************************
+ * RADIX HEAP :: SETTLE
+ * If bucket 0 is empty, raise lastKey to the smallest key in
+ * the lowest non-empty bucket and redistribute that bucket.
+ * Every element in it lands in a lower bucket, at least one
+ * of them in bucket 0.
+ ************************************************/
+template <class T, class Key>
+void radix_heap <T, Key> :: settle() const
+{
+   if (!buckets[0].empty() || numElements == 0)
+      return;
+
+   int b = 1 + bits::countTrailingZeros(occupied);
+   custom::vector<T> & bucket = buckets[b];
+
+   uint64_t smallest = key(bucket[0]);
+   for (size_t i = 1; i < bucket.size(); i++)
+   {
+      uint64_t k = key(bucket[i]);
+      if (k < smallest)
+         smallest = k;
+   }
+   lastKey = smallest;
+
+   for (size_t i = 0; i < bucket.size(); i++)
+   {
+      int bNew = bucketOf(key(bucket[i]));
+      assert(bNew < b);
+      buckets[bNew].push_back(std::move(bucket[i]));
+      if (bNew > 0)
+         occupied |= (uint64_t)1 << (bNew - 1);
+   }
+   bucket.clear();   // keep the capacity for the next time around
+   occupied &= ~((uint64_t)1 << (b - 1));
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two radix heaps
+ ************************************************/
+template <class T, class Key>
+inline void swap(custom::radix_heap <T, Key> & lhs,
+                 custom::radix_heap <T, Key> & rhs)
+{
+   lhs.buckets.swap(rhs.buckets);
+   std::swap(lhs.occupied, rhs.occupied);
+   std::swap(lhs.lastKey, rhs.lastKey);
+   std::swap(lhs.numElements, rhs.numElements);
+   std::swap(lhs.key, rhs.key);
+}
+
+} // namespace custom
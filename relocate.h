@@ -0,0 +1,115 @@
+/***********************************************************************
+ * Header:
+ *    RELOCATE
+ * Summary:
+ *    Moving an element to new memory and ending its life at the old
+ *    address is, for most types, the same as copying its bytes and
+ *    forgetting the old ones: nothing points back at the object. Such
+ *    a type is trivially relocatable. vector and priority_queue then
+ *    move it with memcpy or memmove instead of a move construct and a
+ *    destroy per element.
+ *
+ *    Every trivially copyable type qualifies. Others opt in with a
+ *    specialization, next to the type:
+ *        namespace custom {
+ *        template <> struct is_trivially_relocatable<Handle> : std::true_type { };
+ *        }
+ *    A type that keeps a pointer to itself, or registers its address
+ *    anywhere, must not.
+ *
+ *    This will contain the definitions of:
+ *        is_trivially_relocatable : The opt-in trait
+ *        relocate                 : Move bytes to memory that is free
+ *        relocate_overlapping     : Same, when the ranges overlap
+ *        relocate_one             : One element, from slot to slot
+ *        held                     : An element between slots
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>       // for size_t
+#include <cstring>       // for std::memcpy, std::memmove
+#include <new>           // for std::launder
+#include <type_traits>   // for std::is_trivially_copyable
+
+namespace custom
+{
+
+/*************************************************
+ * IS TRIVIALLY RELOCATABLE
+ * True for trivially copyable types; specialize to
+ * opt a type in
+ *************************************************/
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+/*************************************************
+ * RELOCATE
+ * The NUM elements at SRC now live at DEST, which
+ * held none. SRC is left as raw memory: neither
+ * destroy nor reuse what was there.
+ *************************************************/
+template <class T>
+inline void relocate(T * dest, const T * src, size_t num)
+{
+   static_assert(is_trivially_relocatable<T>::value, "relocate needs a trivially relocatable type");
+   std::memcpy((void *)dest, (const void *)src, num * sizeof(T));
+}
+
+/*************************************************
+ * RELOCATE OVERLAPPING
+ * relocate, for shifting elements within a buffer
+ *************************************************/
+template <class T>
+inline void relocate_overlapping(T * dest, const T * src, size_t num)
+{
+   static_assert(is_trivially_relocatable<T>::value, "relocate needs a trivially relocatable type");
+   std::memmove((void *)dest, (const void *)src, num * sizeof(T));
+}
+
+/*************************************************
+ * RELOCATE ONE
+ * relocate a single element. A trivially copyable
+ * one is assigned: the compiler keeps it in a
+ * register, where a memcpy through bytes would make
+ * it assume any pointer in sight had changed.
+ *************************************************/
+template <class T>
+inline void relocate_one(T & dest, const T & src)
+{
+   if constexpr (std::is_trivially_copyable<T>::value)
+      dest = src;
+   else
+      relocate(&dest, &src, 1);
+}
+
+/*************************************************
+ * HELD
+ * An element relocated out of its slot while others
+ * move through the hole it left, until put() gives
+ * it a slot again. Exactly one put() per held.
+ *************************************************/
+template <class T, bool = std::is_trivially_copyable<T>::value>
+class held
+{
+public:
+   explicit held(const T & from) : item(from) { }
+   const T & get() const { return item; }
+   void put(T & dest) const { dest = item; }
+private:
+   T item;
+};
+template <class T>
+class held <T, false>
+{
+public:
+   explicit held(const T & from) { relocate((T *)bytes, &from, 1); }
+   const T & get() const { return *std::launder((const T *)bytes); }
+   void put(T & dest) const { relocate(&dest, (const T *)bytes, 1); }
+private:
+   alignas(T) unsigned char bytes[sizeof(T)];
+};
+
+} // namespace custom
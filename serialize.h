@@ -0,0 +1,282 @@
+/***********************************************************************
+ * Header:
+ *    SERIALIZE
+ * Summary:
+ *    Save a vector or a priority_queue to a stream or a file
+ *    descriptor and load it back, so a restart reads its queue instead
+ *    of pushing every element again.
+ *
+ *    The format is a 32-byte header, then the elements exactly as they
+ *    sit in memory:
+ *        "PQSN"      4 bytes   magic
+ *        version     4 bytes   1
+ *        elementSize 8 bytes   sizeof(T)
+ *        count       8 bytes   number of elements
+ *        checksum    8 bytes   of the element bytes (see checksum())
+ *    all in the machine's own byte order. A priority_queue saves its
+ *    container, already in heap order, and loads it back the same way:
+ *    one write, one read, no heapify. It must be loaded into a queue
+ *    with the same Compare and Layout it was saved from.
+ *
+ *    Only trivially copyable T, whose bytes are the whole of its value.
+ *
+ *    This will contain the definitions of:
+ *        serialize              : Write a vector or priority_queue
+ *        deserialize            : Read one back
+ *        checksum               : What the header holds of the elements
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cerrno>        // for errno
+#include <cstdint>       // for uint32_t, uint64_t
+#include <algorithm>     // for std::min, std::max
+#include <cstring>       // for std::memcpy, std::memcmp
+#include <istream>       // for std::istream
+#include <ostream>       // for std::ostream
+#include <stdexcept>     // for std::invalid_argument, std::runtime_error
+#include <type_traits>   // for std::is_trivially_copyable
+#include "vector.h"
+#include "priority_queue.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <system_error>  // for std::system_error
+#include <sys/stat.h>    // for fstat
+#include <unistd.h>      // for read, write, lseek
+#endif
+
+namespace custom
+{
+
+/*************************************************
+ * CHECKSUM
+ * FNV-1a, eight bytes at a time, for speed: it
+ * catches a torn or corrupted file, not an attacker
+ *************************************************/
+inline uint64_t checksum(const void * p, size_t bytes)
+{
+   const unsigned char * b = (const unsigned char *)p;
+   uint64_t hash = 0xcbf29ce484222325ULL;
+   size_t i = 0;
+   for (; i + 8 <= bytes; i += 8)
+   {
+      uint64_t word;
+      std::memcpy(&word, b + i, 8);
+      hash = (hash ^ word) * 0x100000001b3ULL;
+   }
+   for (; i < bytes; i++)
+      hash = (hash ^ b[i]) * 0x100000001b3ULL;
+   return hash ^ (hash >> 32);
+}
+
+/*************************************************
+ * SERIALIZER
+ * Reaches into vector and priority_queue for the
+ * free functions below
+ *************************************************/
+struct serializer
+{
+   struct header
+   {
+      char     magic[4];
+      uint32_t version;
+      uint64_t elementSize;
+      uint64_t count;
+      uint64_t checksum;
+   };
+
+   // the header, then the elements, through PUT(pointer, bytes)
+   template <class T, class A, class S, class Put>
+   static void save(const custom::vector<T, A, S> & v, Put put)
+   {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "serialize writes the elements as raw bytes");
+      size_t bytes = v.numElements * sizeof(T);
+      header h;
+      std::memcpy(h.magic, "PQSN", 4);
+      h.version = 1;
+      h.elementSize = sizeof(T);
+      h.count = v.numElements;
+      h.checksum = checksum(v.data, bytes);
+      put(&h, sizeof(h));
+      if (bytes)
+         put(v.data, bytes);
+   }
+
+   // with no idea how much input is left, read at most this much before it shows it holds more
+   static const size_t CHUNK_BYTES = (size_t)16 << 20;
+   static const size_t UNKNOWN = (size_t)-1;
+
+   // read into V through GET(pointer, bytes), which says whether it got them all.
+   // AVAILABLE is how many bytes the input has left after the header, or UNKNOWN.
+   template <class T, class A, class S, class Get>
+   static void load(custom::vector<T, A, S> & v, Get get, size_t available)
+   {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "deserialize reads the elements as raw bytes");
+      v.clear();
+      header h;
+      if (!get(&h, sizeof(h)))
+         throw std::invalid_argument("deserialize: no header");
+      if (std::memcmp(h.magic, "PQSN", 4) != 0 || h.version != 1)
+         throw std::invalid_argument("deserialize: not a serialized container");
+      if (h.elementSize != sizeof(T))
+         throw std::invalid_argument("deserialize: elements of another size");
+      if (h.count > (uint64_t)((size_t)-1 / sizeof(T)) ||
+          (available != UNKNOWN && h.count * sizeof(T) > available))
+         throw std::invalid_argument("deserialize: truncated");
+
+      // the count is only a claim: unless the input is known to hold
+      // that much, grow as the elements actually arrive
+      size_t count = (size_t)h.count;
+      size_t chunk = available != UNKNOWN ? count : std::max(CHUNK_BYTES / sizeof(T), (size_t)1);
+      while (v.numElements < count)
+      {
+         size_t wanted = std::min(count - v.numElements, chunk);
+         if (v.numElements + wanted > v.numCapacity)
+            v.reserve(std::min(count, std::max(v.numElements + wanted, 2 * v.numCapacity)));
+         T * into = v.data + v.numElements;
+         v.constructDefaultInit(v.numElements, v.numElements + wanted);
+         v.numElements += wanted;
+         if (!get(into, wanted * sizeof(T)))
+         {
+            v.clear();
+            throw std::invalid_argument("deserialize: truncated");
+         }
+      }
+      if (checksum(v.data, count * sizeof(T)) != h.checksum)
+      {
+         v.clear();
+         throw std::invalid_argument("deserialize: checksum mismatch");
+      }
+   }
+
+   template <class T, class Container, class Compare, class Layout, class Stats>
+   static       Container & container(      custom::priority_queue<T, Container, Compare, Layout, Stats> & pq) { return pq.container; }
+   template <class T, class Container, class Compare, class Layout, class Stats>
+   static const Container & container(const custom::priority_queue<T, Container, Compare, Layout, Stats> & pq) { return pq.container; }
+
+   // whole blocks to and from a stream
+   static auto putTo(std::ostream & out)
+   {
+      return [&out](const void * p, size_t bytes)
+      {
+         if (!out.write((const char *)p, (std::streamsize)bytes))
+            throw std::runtime_error("serialize: write failed");
+      };
+   }
+   // bytes between where IN is and its end, if it can seek
+   static size_t remaining(std::istream & in)
+   {
+      std::istream::pos_type here = in.tellg();
+      if (here == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end))
+      {
+         in.clear();
+         return UNKNOWN;
+      }
+      std::istream::pos_type end = in.tellg();
+      in.seekg(here);
+      return end < here ? 0 : (size_t)(end - here);
+   }
+   static auto getFrom(std::istream & in)
+   {
+      return [&in](void * p, size_t bytes)
+      {
+         return (bool)in.read((char *)p, (std::streamsize)bytes);
+      };
+   }
+
+#if defined(__unix__) || defined(__APPLE__)
+   // whole blocks to and from a file descriptor, however the kernel splits them
+   static auto putTo(int fd)
+   {
+      return [fd](const void * p, size_t bytes)
+      {
+         const char * b = (const char *)p;
+         while (bytes)
+         {
+            ssize_t done = ::write(fd, b, bytes);
+            if (done < 0 && errno == EINTR)
+               continue;
+            if (done <= 0)
+               throw std::system_error(errno, std::generic_category(), "serialize: write");
+            b += done;
+            bytes -= (size_t)done;
+         }
+      };
+   }
+   // bytes between the offset of FD and the end, if it is a regular file
+   static size_t remaining(int fd)
+   {
+      struct stat info;
+      off_t here = ::lseek(fd, 0, SEEK_CUR);
+      if (here < 0 || ::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+         return UNKNOWN;
+      return info.st_size < here ? 0 : (size_t)(info.st_size - here);
+   }
+   static auto getFrom(int fd)
+   {
+      return [fd](void * p, size_t bytes)
+      {
+         char * b = (char *)p;
+         while (bytes)
+         {
+            ssize_t done = ::read(fd, b, bytes);
+            if (done < 0 && errno == EINTR)
+               continue;
+            if (done < 0)
+               throw std::system_error(errno, std::generic_category(), "deserialize: read");
+            if (done == 0)
+               return false;
+            b += done;
+            bytes -= (size_t)done;
+         }
+         return true;
+      };
+   }
+#endif // __unix__ || __APPLE__
+};
+
+/*****************************************
+ * SERIALIZE
+ * Write a vector, or the heap of a priority_queue,
+ * to OUT: a std::ostream or a file descriptor
+ ****************************************/
+template <class Out, class T, class A, class S>
+void serialize(Out && out, const custom::vector<T, A, S> & v)
+{
+   serializer::save(v, serializer::putTo(out));
+}
+template <class Out, class T, class Container, class Compare, class Layout, class Stats>
+void serialize(Out && out, const custom::priority_queue<T, Container, Compare, Layout, Stats> & pq)
+{
+   serializer::save(serializer::container(pq), serializer::putTo(out));
+}
+
+/*****************************************
+ * DESERIALIZE
+ * Replace a vector, or a priority_queue's heap,
+ * with what serialize wrote to IN. Throws
+ * std::invalid_argument if IN does not hold one
+ * of these of T, whole and unchanged; the
+ * container is then left empty. The count in the
+ * header is not trusted: memory is taken as the
+ * elements arrive, a chunk at a time.
+ ****************************************/
+template <class In, class T, class A, class S>
+void deserialize(In && in, custom::vector<T, A, S> & v)
+{
+   size_t available = serializer::remaining(in);
+   if (available != serializer::UNKNOWN)
+      available = available < sizeof(serializer::header) ? 0 : available - sizeof(serializer::header);
+   serializer::load(v, serializer::getFrom(in), available);
+}
+template <class In, class T, class Container, class Compare, class Layout, class Stats>
+void deserialize(In && in, custom::priority_queue<T, Container, Compare, Layout, Stats> & pq)
+{
+   deserialize(in, serializer::container(pq));
+}
+
+} // namespace custom
@@ -0,0 +1,311 @@
+/***********************************************************************
+ * Header:
+ *    SPLIT PRIORITY QUEUE
+ * Summary:
+ *    A priority queue for small keys carrying large payloads. The heap
+ *    itself holds only {key, slot} pairs; the payloads sit in a separate
+ *    slab and are addressed by a 4-byte slot number. Sifting a node up
+ *    or down moves a key and a slot, never a payload, so a heap of
+ *    128-byte records walks memory like a heap of 16-byte ones.
+ *
+ *    A payload is written once on push and is not touched again until
+ *    its slot is recycled. Freed slots are reused last-in, first-out,
+ *    so the slab never grows past the largest size the queue reached.
+ *
+ *    Ordering follows priority_queue: with std::less the largest key
+ *    is on top.
+ *
+ *    This will contain the class definition of:
+ *        split_priority_queue   : Keys in the heap, payloads to the side
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>   // std::less
+#include <stdexcept>    // std::out_of_range, std::length_error
+#include <utility>      // std::swap, std::move, std::forward
+#include "vector.h"     // for the heap, the slab, and the free list
+
+class TestSplitPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * SPLIT PRIORITY QUEUE
+ * A heap of keys, each with a payload kept out of the
+ * way. top() is the payload of the best key; top_key()
+ * is the key. Payload must be default constructible.
+ *************************************************/
+template <class Key, class Payload, class Compare = std::less<Key>>
+class split_priority_queue
+{
+   friend class ::TestSplitPQueue; // give the unit test class access to the privates
+   template <class KK, class PP, class CCompare>
+   friend void swap(split_priority_queue<KK, PP, CCompare>& lhs, split_priority_queue<KK, PP, CCompare>& rhs);
+
+public:
+
+   //
+   // construct
+   //
+   split_priority_queue(const Compare & c = Compare()) : compare(c) { }
+
+   //
+   // Access
+   //
+   const Key     & top_key() const;
+   const Payload & top() const;
+         Payload & top();
+
+   //
+   // Insert
+   //
+   void push(const Key & key, const Payload & payload);
+   void push(const Key & key, Payload && payload);
+   void reserve(size_t n);
+
+   //
+   // Remove
+   //
+   void pop();
+
+   //
+   // Status
+   //
+   size_t size()  const { return heap.size(); }
+   bool empty()   const { return size() == size_t(0); }
+
+private:
+
+   // one node of the heap: all percolate ever moves
+   struct Node
+   {
+      Key      key;
+      uint32_t slot;    // index of the payload in the slab
+   };
+
+   template <class P>
+   void     insert(const Key & key, P && payload); // what both pushes do
+   template <class P>
+   uint32_t store(P && payload);          // put a payload in the slab
+   void     unstore(uint32_t slot);       // take back a slot store() just gave
+   void     percolateUp(size_t index);    // fix the heap after a push
+   void     percolateDown(size_t index);  // fix the heap below index
+
+   custom::vector<Node>     heap;         // keys and slots, in heap order
+   custom::vector<Payload>  slab;         // payloads, in no particular order
+   custom::vector<uint32_t> freeSlots;    // slab slots not holding a payload
+   Compare                  compare;      // comparision operator on keys
+};
+
+/************************************************
+ * SPLIT PRIORITY QUEUE :: TOP KEY
+ * Get the best key.
+ ***********************************************/
+template <class Key, class Payload, class Compare>
+const Key & split_priority_queue <Key, Payload, Compare> :: top_key() const
+{
+   if (!heap.empty())
+      return heap.front().key;
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/************************************************
+ * SPLIT PRIORITY QUEUE :: TOP
+ * Get the payload of the best key. The payload is not
+ * part of the ordering, so the caller may change it or
+ * move it out before pop().
+ ***********************************************/
+template <class Key, class Payload, class Compare>
+const Payload & split_priority_queue <Key, Payload, Compare> :: top() const
+{
+   if (!heap.empty())
+      return slab[heap.front().slot];
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+template <class Key, class Payload, class Compare>
+Payload & split_priority_queue <Key, Payload, Compare> :: top()
+{
+   if (!heap.empty())
+      return slab[heap.front().slot];
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/*****************************************
+ * SPLIT PRIORITY QUEUE :: PUSH
+ * Store the payload in a free slot and sift its key
+ * into the heap. If the heap cannot take the node
+ * (bad_alloc as it grows, or a throwing Key), the
+ * slot is given back and the queue is as it was.
+ ****************************************/
+template <class Key, class Payload, class Compare>
+void split_priority_queue <Key, Payload, Compare> :: push(const Key & key, const Payload & payload)
+{
+   insert(key, payload);
+}
+template <class Key, class Payload, class Compare>
+void split_priority_queue <Key, Payload, Compare> :: push(const Key & key, Payload && payload)
+{
+   insert(key, std::move(payload));
+}
+template <class Key, class Payload, class Compare>
+template <class P>
+void split_priority_queue <Key, Payload, Compare> :: insert(const Key & key, P && payload)
+{
+   Node node{key, 0};
+   node.slot = store(std::forward<P>(payload));
+   try
+   {
+      heap.push_back(std::move(node));
+   }
+   catch (...)
+   {
+      unstore(node.slot);
+      throw;
+   }
+   percolateUp(size() - 1);
+}
+
+/*****************************************
+ * SPLIT PRIORITY QUEUE :: RESERVE
+ * Make room for N elements without reallocating.
+ ****************************************/
+template <class Key, class Payload, class Compare>
+void split_priority_queue <Key, Payload, Compare> :: reserve(size_t n)
+{
+   heap.reserve(n);
+   slab.reserve(n);
+   freeSlots.reserve(n);
+}
+
+/**********************************************
+ * SPLIT PRIORITY QUEUE :: POP
+ * Delete the best key and free its payload's slot.
+ **********************************************/
+template <class Key, class Payload, class Compare>
+void split_priority_queue <Key, Payload, Compare> :: pop()
+{
+   if (empty())
+      return;
+
+   uint32_t slot = heap[0].slot;
+   slab[slot] = Payload();   // release whatever the payload owned
+   freeSlots.push_back(slot);
+
+   if (size() > 1)
+      heap[0] = std::move(heap[size() - 1]);
+   heap.pop_back();
+   if (!empty())
+      percolateDown(0);
+}
+
+/************************************************
+ * SPLIT PRIORITY QUEUE :: STORE
+ * Put a new payload in the slab and return its slot: a
+ * recycled one if there is one, otherwise a new one at
+ * the end.
+ ************************************************/
+template <class Key, class Payload, class Compare>
+template <class P>
+uint32_t split_priority_queue <Key, Payload, Compare> :: store(P && payload)
+{
+   if (!freeSlots.empty())
+   {
+      uint32_t slot = freeSlots.back();
+      freeSlots.pop_back();
+      slab[slot] = std::forward<P>(payload);
+      return slot;
+   }
+   if (slab.size() >= UINT32_MAX)
+      throw std::length_error("split_priority_queue: out of payload slots");
+   slab.push_back(std::forward<P>(payload));
+   return (uint32_t)(slab.size() - 1);
+}
+
+/************************************************
+ * SPLIT PRIORITY QUEUE :: UNSTORE
+ * Undo the store() that returned SLOT. A new slot is
+ * the slab's last and comes off the end; a recycled
+ * one goes back on the free list, which has room for
+ * it since store() just took it from there.
+ ************************************************/
+template <class Key, class Payload, class Compare>
+void split_priority_queue <Key, Payload, Compare> :: unstore(uint32_t slot)
+{
+   if ((size_t)slot + 1 == slab.size())
+      slab.pop_back();
+   else
+   {
+      slab[slot] = Payload();
+      freeSlots.push_back(slot);
+   }
+}
+
+/************************************************
+ * SPLIT PRIORITY QUEUE :: PERCOLATE UP
+ * Move the node at INDEX toward the root while its key
+ * beats its parent's.
+ ************************************************/
+template <class Key, class Payload, class Compare>
+void split_priority_queue <Key, Payload, Compare> :: percolateUp(size_t index)
+{
+   Node node = std::move(heap[index]);
+   while (index > 0)
+   {
+      size_t indexParent = (index - 1) / 2;
+      if (!compare(heap[indexParent].key, node.key))
+         break;
+      heap[index] = std::move(heap[indexParent]);
+      index = indexParent;
+   }
+   heap[index] = std::move(node);
+}
+
+/************************************************
+ * SPLIT PRIORITY QUEUE :: PERCOLATE DOWN
+ * Move the node at INDEX away from the root while the
+ * better of its children's keys beats its own.
+ ************************************************/
+template <class Key, class Payload, class Compare>
+void split_priority_queue <Key, Payload, Compare> :: percolateDown(size_t index)
+{
+   Node node = std::move(heap[index]);
+   for (;;)
+   {
+      size_t indexChild = 2 * index + 1;
+      if (indexChild >= size())
+         break;
+      if (indexChild + 1 < size() && compare(heap[indexChild].key, heap[indexChild + 1].key))
+         indexChild++;
+      if (!compare(node.key, heap[indexChild].key))
+         break;
+      heap[index] = std::move(heap[indexChild]);
+      index = indexChild;
+   }
+   heap[index] = std::move(node);
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two split priority queues
+ ************************************************/
+template <class Key, class Payload, class Compare>
+inline void swap(custom::split_priority_queue <Key, Payload, Compare> & lhs,
+                 custom::split_priority_queue <Key, Payload, Compare> & rhs)
+{
+   using std::swap;
+   lhs.heap.swap(rhs.heap);
+   lhs.slab.swap(rhs.slab);
+   lhs.freeSlots.swap(rhs.freeSlots);
+   swap(lhs.compare, rhs.compare);
+}
+
+} // namespace custom
@@ -10,6 +10,8 @@
 #pragma once
 
 #include <cassert>
+#include <type_traits>   // for std::true_type
+#include "relocate.h"    // for is_trivially_relocatable
 
 enum { ALLOC,      // 0 allocations, number of times NEW is called
        DELETE,     // 1 deletions, number of times DELETE is called
@@ -202,3 +204,13 @@ private:
 };
 
 inline void swap(Spy & lhs, Spy & rhs) { lhs.swap(rhs);}
+
+/*************************************************************
+ * SPY is trivially relocatable: it owns its int through a
+ * pointer and nothing points back at it, so its bytes can
+ * move without the move constructor and destructor
+ *************************************************************/
+namespace custom
+{
+template <> struct is_trivially_relocatable<Spy> : std::true_type { };
+}
@@ -0,0 +1,229 @@
+/***********************************************************************
+ * Header:
+ *    STABLE PRIORITY QUEUE
+ * Summary:
+ *    Priority queues that break ties first-in, first-out. Elements of
+ *    equal priority come out in the order they were pushed, without the
+ *    caller wrapping each one in {priority, sequence}.
+ *
+ *    stable_priority_queue tags each element with a 64-bit sequence
+ *    number and compares the sequence only when the priorities tie.
+ *
+ *    packed_stable_priority_queue is for integer keys that fit in
+ *    KeyBits bits. The sequence number lives in the low 64 - KeyBits
+ *    bits of a single uint64_t, so each entry is 8 bytes and each step
+ *    of the heap is one integer compare. When the sequence numbers run
+ *    out the queue renumbers its contents, preserving their order.
+ *
+ *    This will contain the class definitions of:
+ *        stable_priority_queue         : FIFO among equal priorities
+ *        packed_stable_priority_queue  : The same, packed into integers
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>    // std::less, std::greater
+#include <stdexcept>     // std::out_of_range, std::length_error
+#include <type_traits>   // std::is_integral, std::conditional
+#include "priority_queue.h"
+
+class TestStablePQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * STABLE PRIORITY QUEUE
+ * A priority queue where equal elements leave in the
+ * order they arrived.
+ *************************************************/
+template <class T, class Compare = std::less<T>>
+class stable_priority_queue
+{
+   friend class ::TestStablePQueue; // give the unit test class access to the privates
+
+   struct Entry
+   {
+      T        value;
+      uint64_t sequence;   // order of arrival
+   };
+
+   // lower priority, or equal priority and arrived later
+   struct EntryCompare
+   {
+      EntryCompare(const Compare & c = Compare()) : compare(c) { }
+      bool operator () (const Entry & lhs, const Entry & rhs) const
+      {
+         if (compare(lhs.value, rhs.value))
+            return true;
+         if (compare(rhs.value, lhs.value))
+            return false;
+         return lhs.sequence > rhs.sequence;
+      }
+      Compare compare;
+   };
+
+public:
+
+   //
+   // construct
+   //
+   stable_priority_queue(const Compare & c = Compare()) : pq(EntryCompare(c)), nextSequence(0) { }
+
+   //
+   // Access
+   //
+   const T & top() const { return pq.top().value; }
+
+   //
+   // Insert
+   //
+   void push(const T & t)  { pq.push(Entry{t, nextSequence++}); }
+   void push(T && t)       { pq.push(Entry{std::move(t), nextSequence++}); }
+
+   //
+   // Remove
+   //
+   void pop()
+   {
+      if (!empty())
+         pq.pop();
+   }
+
+   //
+   // Status
+   //
+   size_t size()  const { return pq.size(); }
+   bool empty()   const { return pq.empty(); }
+
+private:
+   custom::priority_queue<Entry, custom::vector<Entry>, EntryCompare> pq;
+   uint64_t nextSequence;   // sequence number for the next push
+};
+
+/*************************************************
+ * PACKED STABLE PRIORITY QUEUE
+ * A stable priority queue of integers that fit in KeyBits
+ * bits. Compare must be std::less (largest first) or
+ * std::greater (smallest first). top() returns by value.
+ *************************************************/
+template <class T, int KeyBits = 32, class Compare = std::less<T>>
+class packed_stable_priority_queue
+{
+   static_assert(std::is_integral<T>::value, "packed_stable_priority_queue needs an integer key");
+   static_assert(KeyBits > 0 && KeyBits < 64, "KeyBits must leave room for a sequence number");
+   static_assert(std::is_same<Compare, std::less<T>>::value ||
+                 std::is_same<Compare, std::greater<T>>::value,
+                 "packed_stable_priority_queue orders by std::less or std::greater");
+
+   friend class ::TestStablePQueue; // give the unit test class access to the privates
+
+   static const int      SEQUENCE_BITS  = 64 - KeyBits;
+   static const uint64_t SEQUENCE_LIMIT = (uint64_t)1 << SEQUENCE_BITS;
+   static const bool     LARGEST_FIRST  = std::is_same<Compare, std::less<T>>::value;
+
+   // signed keys are biased so they sort as unsigned
+   static const uint64_t KEY_BIAS = std::is_signed<T>::value ? (uint64_t)1 << (KeyBits - 1) : 0;
+
+   typedef typename std::conditional<LARGEST_FIRST,
+                                     std::less<uint64_t>,
+                                     std::greater<uint64_t>>::type PackedCompare;
+
+public:
+
+   //
+   // construct
+   //
+   packed_stable_priority_queue() : nextSequence(0) { }
+
+   //
+   // Access
+   //
+   T top() const { return unpack(pq.top()); }
+
+   //
+   // Insert
+   //
+   void push(T t);
+
+   //
+   // Remove
+   //
+   void pop()
+   {
+      if (!empty())
+         pq.pop();
+   }
+
+   //
+   // Status
+   //
+   size_t size()  const { return pq.size(); }
+   bool empty()   const { return pq.empty(); }
+
+private:
+
+   // key in the high bits; low bits sort earlier arrivals first
+   static uint64_t pack(T t, uint64_t sequence)
+   {
+      uint64_t key = (uint64_t)(int64_t)t + KEY_BIAS;
+      if (key >> KeyBits)
+         throw std::out_of_range("std:out_of_range");
+      uint64_t order = LARGEST_FIRST ? (SEQUENCE_LIMIT - 1 - sequence) : sequence;
+      return (key << SEQUENCE_BITS) | order;
+   }
+   static T unpack(uint64_t packed)
+   {
+      return (T)(int64_t)((packed >> SEQUENCE_BITS) - KEY_BIAS);
+   }
+   void renumber();
+
+   custom::priority_queue<uint64_t, custom::vector<uint64_t>, PackedCompare> pq;
+   uint64_t nextSequence;   // sequence number for the next push
+};
+
+/*****************************************
+ * PACKED STABLE PRIORITY QUEUE :: PUSH
+ * Add a new element behind the others of the same
+ * priority. Throws if the key does not fit in KeyBits.
+ ****************************************/
+template <class T, int KeyBits, class Compare>
+void packed_stable_priority_queue <T, KeyBits, Compare> :: push(T t)
+{
+   if (nextSequence == SEQUENCE_LIMIT)
+      renumber();
+   pq.push(pack(t, nextSequence));
+   nextSequence++;
+}
+
+/************************************************
+ * PACKED STABLE PRIORITY QUEUE :: RENUMBER
+ * The sequence numbers are used up. Drain the queue in
+ * order and hand out fresh numbers 0 .. size()-1.
+ ************************************************/
+template <class T, int KeyBits, class Compare>
+void packed_stable_priority_queue <T, KeyBits, Compare> :: renumber()
+{
+   if (size() >= SEQUENCE_LIMIT)
+      throw std::length_error("packed_stable_priority_queue: out of sequence numbers");
+
+   custom::vector<uint64_t> entries;
+   entries.reserve(size());
+   for (uint64_t sequence = 0; !pq.empty(); sequence++)
+   {
+      entries.push_back(pack(unpack(pq.top()), sequence));
+      pq.pop();
+   }
+   nextSequence = entries.size();
+
+   // already in heap order, so the heapify inside is a single pass of no-ops
+   custom::priority_queue<uint64_t, custom::vector<uint64_t>, PackedCompare>
+      pqNew(PackedCompare(), std::move(entries));
+   swap(pq, pqNew);
+}
+
+} // namespace custom
@@ -0,0 +1,264 @@
+/***********************************************************************
+ * Header:
+ *    TEST BOUNDED PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the bounded (top-K) priority queue
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "bounded_priority_queue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+class TestBoundedPQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_reserves();
+      test_construct_zero();
+
+      // Access
+      test_top_empty();
+      test_top_worst();
+
+      // Insert
+      test_offer_notFull();
+      test_offer_rejectOneCompare();
+      test_offer_replace();
+      test_offer_neverReallocates();
+
+      // Remove
+      test_pop_standard();
+      test_drainSorted_standard();
+      test_drainSorted_greater();
+      test_drainSorted_random();
+
+      report("BoundedPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // the K slots are reserved up front
+   void test_construct_reserves()
+   {  // exercise
+      custom::bounded_priority_queue <int> pq(5);
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(!pq.full());
+      assertUnit(pq.capacity() == 5);
+      assertUnit(pq.container.capacity() == 5);
+   }  // teardown
+
+   // a queue of zero keeps nothing
+   void test_construct_zero()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(0);
+      // exercise
+      bool kept = pq.offer(42);
+      // verify
+      assertUnit(!kept);
+      assertUnit(pq.empty());
+      assertUnit(pq.full());
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty queue throws
+   void test_top_empty()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(3);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         pq.top();
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // top is the worst element kept
+   void test_top_worst()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(3);
+      setupStandardFixture(pq);
+      // exercise and verify
+      assertUnit(pq.top() == 8);
+      assertUnit(pq.size() == 3);
+   }  // teardown
+
+   /***************************************
+    * OFFER
+    ***************************************/
+
+   // below capacity everything is kept
+   void test_offer_notFull()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(4);
+      // exercise
+      bool kept1 = pq.offer(1);
+      bool kept2 = pq.offer(-5);
+      // verify
+      assertUnit(kept1);
+      assertUnit(kept2);
+      assertUnit(pq.size() == 2);
+      assertUnit(pq.top() == -5);
+   }  // teardown
+
+   // once full, a losing offer costs exactly one comparison
+   void test_offer_rejectOneCompare()
+   {  // setup
+      custom::bounded_priority_queue <Spy> pq(3);
+      pq.offer(Spy(10));
+      pq.offer(Spy(8));
+      pq.offer(Spy(9));
+      Spy s(2);
+      Spy::reset();
+      // exercise
+      bool kept = pq.offer(s);
+      // verify
+      assertUnit(!kept);
+      assertUnit(Spy::numLessthan() == 1);   // compare [8<2]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numSwap() == 0);
+      assertUnit(pq.size() == 3);
+   }  // teardown
+
+   // once full, a winning offer replaces the worst
+   void test_offer_replace()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(3);
+      setupStandardFixture(pq);
+      // exercise
+      bool kept = pq.offer(12);
+      // verify
+      assertUnit(kept);
+      assertUnit(pq.size() == 3);
+      assertUnit(pq.top() == 9);
+   }  // teardown
+
+   // the storage never moves once reserved
+   void test_offer_neverReallocates()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(16);
+      const int * data = &pq.container.front();
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         pq.offer((i * 7919) % 1009);
+      // verify
+      assertUnit(&pq.container.front() == data);
+      assertUnit(pq.container.capacity() == 16);
+      assertUnit(pq.size() == 16);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop removes the worst element kept
+   void test_pop_standard()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(3);
+      setupStandardFixture(pq);
+      // exercise
+      pq.pop();
+      // verify
+      assertUnit(pq.size() == 2);
+      assertUnit(pq.top() == 9);
+   }  // teardown
+
+   // drain_sorted returns best first and leaves the queue ready for more
+   void test_drainSorted_standard()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(3);
+      setupStandardFixture(pq);
+      // exercise
+      custom::vector <int> v = pq.drain_sorted();
+      // verify
+      assertUnit(v.size() == 3);
+      if (v.size() == 3)
+      {
+         assertUnit(v[0] == 10);
+         assertUnit(v[1] == 9);
+         assertUnit(v[2] == 8);
+      }
+      assertUnit(pq.empty());
+      assertUnit(pq.container.capacity() == 3);
+   }  // teardown
+
+   // with std::greater the smallest elements are kept
+   void test_drainSorted_greater()
+   {  // setup
+      custom::bounded_priority_queue <int, std::greater<int>> pq(3);
+      setupStandardFixture(pq);
+      // exercise
+      custom::vector <int> v = pq.drain_sorted();
+      // verify
+      assertUnit(v.size() == 3);
+      if (v.size() == 3)
+      {
+         assertUnit(v[0] == 3);
+         assertUnit(v[1] == 4);
+         assertUnit(v[2] == 5);
+      }
+   }  // teardown
+
+   // top-K of a random stream matches a full sort
+   void test_drainSorted_random()
+   {  // setup
+      custom::bounded_priority_queue <int> pq(50);
+      std::vector <int> all;
+      uint64_t seed = 17;
+      for (int i = 0; i < 2000; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         int value = (int)((seed >> 33) % 100000);
+         pq.offer(value);
+         all.push_back(value);
+      }
+      std::sort(all.begin(), all.end(), std::greater<int>());
+      // exercise
+      custom::vector <int> v = pq.drain_sorted();
+      // verify
+      bool same = v.size() == 50;
+      for (size_t i = 0; same && i < 50; i++)
+         same = v[i] == all[i];
+      assertUnit(same);
+   }  // teardown
+
+   /****************************************************************
+    * SETUP STANDARD FIXTURE
+    *   offer { 10, 8, 9, 4, 3, 7, 5 }
+    ****************************************************************/
+   template <class Compare>
+   void setupStandardFixture(custom::bounded_priority_queue <int, Compare> & pq)
+   {
+      int values[] = { 10, 8, 9, 4, 3, 7, 5 };
+      for (int v : values)
+         pq.offer(v);
+   }
+};
+
+#endif // DEBUG
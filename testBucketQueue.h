@@ -0,0 +1,301 @@
+/***********************************************************************
+ * Header:
+ *    TEST BUCKET QUEUE
+ * Summary:
+ *    Unit tests for the bucket queue
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "bucket_queue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <queue>
+#include <vector>
+
+class TestBucketQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_range();
+
+      // Access
+      test_top_empty();
+      test_top_standard();
+
+      // Insert
+      test_push_outOfRange();
+      test_push_bitmap();
+      test_push_wrap();
+
+      // Remove
+      test_pop_empty();
+      test_pop_standard();
+      test_pop_fifo();
+      test_pop_random();
+      test_pop_releases();
+
+      report("BucketQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing stored
+   void test_construct_default()
+   {  // exercise
+      custom::bucket_queue <int> bq;
+      // verify
+      assertUnit(bq.empty());
+      assertUnit(bq.size() == 0);
+      assertUnit(bq.buckets.size() == 256);
+      assertUnit(bq.summary == 0);
+      for (int w = 0; w < 4; w++)
+         assertUnit(bq.words[w] == 0);
+   }  // teardown
+
+   // range constructor
+   void test_construct_range()
+   {  // setup
+      int priorities[] = { 3, 200, 17 };
+      // exercise
+      custom::bucket_queue <int> bq(priorities, priorities + 3);
+      // verify
+      assertUnit(bq.size() == 3);
+      assertUnit(bq.top() == 200);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty queue throws
+   void test_top_empty()
+   {  // setup
+      custom::bucket_queue <int> bq;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         bq.top();
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // top is the highest priority
+   void test_top_standard()
+   {  // setup
+      custom::bucket_queue <int> bq;
+      setupStandardFixture(bq);
+      // exercise
+      int t = bq.top();
+      // verify
+      assertUnit(t == 10);
+      assertUnit(bq.size() == 7);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // a priority past the last bucket is rejected
+   void test_push_outOfRange()
+   {  // setup
+      custom::bucket_queue <int, 16> bq;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         bq.push(16);
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(bq.empty());
+   }  // teardown
+
+   // the two bitmap levels track non-empty buckets
+   void test_push_bitmap()
+   {  // setup
+      custom::bucket_queue <int> bq;
+      // exercise
+      bq.push(1);
+      bq.push(64);
+      bq.push(255);
+      // verify
+      assertUnit(bq.words[0] == 2);
+      assertUnit(bq.words[1] == 1);
+      assertUnit(bq.words[2] == 0);
+      assertUnit(bq.words[3] == (uint64_t)1 << 63);
+      assertUnit(bq.summary == 0xb);
+      assertUnit(bq.top() == 255);
+   }  // teardown
+
+   // a bucket keeps FIFO order after its ring wraps and grows
+   void test_push_wrap()
+   {  // setup
+      struct Job
+      {
+         int qos;
+         int id;
+      };
+      struct JobPriority
+      {
+         size_t operator () (const Job & j) const { return (size_t)j.qos; }
+      };
+      custom::bucket_queue <Job, 8, JobPriority> bq;
+      bq.push(Job{ 5, 0 });
+      bq.push(Job{ 5, 1 });
+      bq.push(Job{ 5, 2 });
+      bq.pop();
+      bq.pop();
+      // exercise
+      for (int id = 3; id < 9; id++)
+         bq.push(Job{ 5, id });
+      // verify
+      bool inOrder = true;
+      for (int id = 2; id < 9; id++)
+      {
+         inOrder = inOrder && bq.top().id == id;
+         bq.pop();
+      }
+      assertUnit(inOrder);
+      assertUnit(bq.empty());
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop an empty queue does nothing
+   void test_pop_empty()
+   {  // setup
+      custom::bucket_queue <int> bq;
+      // exercise
+      bq.pop();
+      // verify
+      assertUnit(bq.empty());
+   }  // teardown
+
+   // pop everything from the standard fixture in order
+   void test_pop_standard()
+   {  // setup
+      custom::bucket_queue <int> bq;
+      setupStandardFixture(bq);
+      int expected[] = { 10, 9, 8, 7, 5, 4, 3 };
+      // exercise and verify
+      for (int i = 0; i < 7; i++)
+      {
+         assertUnit(bq.top() == expected[i]);
+         bq.pop();
+      }
+      assertUnit(bq.empty());
+      assertUnit(bq.summary == 0);
+   }  // teardown
+
+   // equal priorities come out in arrival order
+   void test_pop_fifo()
+   {  // setup
+      struct Job
+      {
+         int qos;
+         int id;
+      };
+      struct JobPriority
+      {
+         size_t operator () (const Job & j) const { return (size_t)j.qos; }
+      };
+      custom::bucket_queue <Job, 4, JobPriority> bq;
+      bq.push(Job{ 1, 10 });
+      bq.push(Job{ 2, 20 });
+      bq.push(Job{ 1, 11 });
+      bq.push(Job{ 2, 21 });
+      bq.push(Job{ 1, 12 });
+      int expected[] = { 20, 21, 10, 11, 12 };
+      // exercise and verify
+      for (int i = 0; i < 5; i++)
+      {
+         assertUnit(bq.top().id == expected[i]);
+         bq.pop();
+      }
+   }  // teardown
+
+   // interleaved pushes and pops agree with std::priority_queue
+   void test_pop_random()
+   {  // setup
+      custom::bucket_queue <int> bq;
+      std::priority_queue <int> pq;
+      uint64_t seed = 99;
+      bool same = true;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         if ((seed >> 62) != 0 || pq.empty())
+         {
+            int p = (int)((seed >> 33) % 256);
+            bq.push(p);
+            pq.push(p);
+         }
+         else
+         {
+            same = same && bq.top() == pq.top();
+            bq.pop();
+            pq.pop();
+         }
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(bq.size() == pq.size());
+   }  // teardown
+
+   // popping frees what the element held
+   void test_pop_releases()
+   {  // setup
+      struct SpyPriority
+      {
+         size_t operator () (const Spy & s) const { return (size_t)s.get(); }
+      };
+      custom::bucket_queue <Spy, 16, SpyPriority> bq;
+      bq.push(Spy(3));
+      Spy::reset();
+      // exercise
+      bq.pop();
+      // verify
+      assertUnit(Spy::numDelete() == 1);   // delete [3]
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(bq.empty());
+   }  // teardown
+
+   /****************************************************************
+    * SETUP STANDARD FIXTURE
+    *   { 10, 8, 9, 4, 3, 7, 5 }
+    ****************************************************************/
+   void setupStandardFixture(custom::bucket_queue <int> & bq)
+   {
+      int priorities[] = { 10, 8, 9, 4, 3, 7, 5 };
+      for (int p : priorities)
+         bq.push(p);
+   }
+};
+
+#endif // DEBUG
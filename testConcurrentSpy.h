@@ -0,0 +1,188 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT SPY
+ * Summary:
+ *    Unit tests for the thread-safe spy
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent_spy.h"
+#include "priority_queue.h"
+#include "unitTest.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+class TestConcurrentSpy : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Counting
+      test_count_oneThread();
+      test_count_heap();
+      test_count_reset();
+      test_count_past32Bits();
+
+      // Threads
+      test_threads_summed();
+      test_threads_blockReused();
+      test_block_ownLines();
+
+      report("ConcurrentSpy");
+   }
+
+   /***************************************
+    * COUNTING
+    ***************************************/
+
+   // every kind of event lands on its own counter
+   void test_count_oneThread()
+   {  // setup
+      ConcurrentSpy::reset();
+      // exercise
+      {
+         ConcurrentSpy a(3);
+         ConcurrentSpy b(a);
+         ConcurrentSpy c(std::move(b));
+         b = a;
+         c = std::move(a);
+         swap(a, c);
+         bool less = a < c;
+         bool same = a == c;
+         (void)less;
+         (void)same;
+      }
+      // verify
+      assertUnit(ConcurrentSpy::numNondefault() == 1);
+      assertUnit(ConcurrentSpy::numCopy() == 1);
+      assertUnit(ConcurrentSpy::numCopyMove() == 1);
+      assertUnit(ConcurrentSpy::numAssign() == 1);
+      assertUnit(ConcurrentSpy::numAssignMove() == 1);
+      assertUnit(ConcurrentSpy::numSwap() == 1);
+      assertUnit(ConcurrentSpy::numLessthan() == 1);
+      assertUnit(ConcurrentSpy::numEquals() == 1);
+      assertUnit(ConcurrentSpy::numDestructor() == 3);
+      assertUnit(ConcurrentSpy::numAlloc() == 0);
+   }  // teardown
+
+   // a heap of ConcurrentSpy counts what a heap of Spy does
+   void test_count_heap()
+   {  // setup
+      custom::priority_queue<Spy> pqSpy;
+      custom::priority_queue<ConcurrentSpy> pqConcurrent;
+      Spy::reset();
+      ConcurrentSpy::reset();
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         pqSpy.push(Spy((i * 37) % 100));
+         pqConcurrent.push(ConcurrentSpy((uint64_t)((i * 37) % 100)));
+      }
+      for (int i = 0; i < 50; i++)
+      {
+         pqSpy.pop();
+         pqConcurrent.pop();
+      }
+      // verify
+      assertUnit(ConcurrentSpy::numLessthan() == (uint64_t)Spy::numLessthan());
+      assertUnit(ConcurrentSpy::numSwap() == (uint64_t)Spy::numSwap());
+      assertUnit(ConcurrentSpy::numCopyMove() == (uint64_t)Spy::numCopyMove());
+   }  // teardown
+
+   // reset zeroes every counter
+   void test_count_reset()
+   {  // setup
+      ConcurrentSpy a(1);
+      ConcurrentSpy b(a);
+      // exercise
+      ConcurrentSpy::reset();
+      // verify
+      assertUnit(ConcurrentSpy::numCopy() == 0);
+      assertUnit(ConcurrentSpy::numNondefault() == 0);
+   }  // teardown
+
+   // the counters are 64 bits
+   void test_count_past32Bits()
+   {  // setup
+      ConcurrentSpy::reset();
+      ConcurrentSpy a(1);
+      ConcurrentSpy b(2);
+      ConcurrentSpy::Block * block = ConcurrentSpy::blocks().load();
+      while (block && block->counters[NONDEFAULT].load() != 2)
+         block = block->next;
+      assertUnit(block != nullptr);
+      if (!block)
+         return;
+      block->counters[LESSTHAN].store(UINT32_MAX);
+      // exercise
+      bool less = a < b;
+      // verify
+      assertUnit(less);
+      assertUnit(ConcurrentSpy::numLessthan() == (uint64_t)UINT32_MAX + 1);
+      ConcurrentSpy::reset();
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // counts from several threads add up, after the threads are gone
+   void test_threads_summed()
+   {  // setup
+      ConcurrentSpy::reset();
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < 4; t++)
+         threads.emplace_back([]()
+         {
+            ConcurrentSpy a(1);
+            for (int i = 0; i < 10000; i++)
+               ConcurrentSpy b(a);
+         });
+      for (auto & thread : threads)
+         thread.join();
+      // verify
+      assertUnit(ConcurrentSpy::numCopy() == 40000);
+      assertUnit(ConcurrentSpy::numNondefault() == 4);
+      assertUnit(ConcurrentSpy::numDestructor() == 40004);
+   }  // teardown
+
+   // threads one after another share one block
+   void test_threads_blockReused()
+   {  // setup
+      ConcurrentSpy a(1);   // this thread has its block
+      std::thread([]() { ConcurrentSpy b(2); }).join();
+      size_t before = numBlocks();
+      // exercise
+      for (int t = 0; t < 5; t++)
+         std::thread([]() { ConcurrentSpy b(2); }).join();
+      // verify
+      assertUnit(numBlocks() == before);
+   }  // teardown
+
+   // no two threads' counters share a cache line
+   void test_block_ownLines()
+   {  // exercise and verify
+      assertUnit(alignof(ConcurrentSpy::Block) == custom::CACHE_LINE);
+      assertUnit(sizeof(ConcurrentSpy::Block) % custom::CACHE_LINE == 0);
+   }  // teardown
+
+   size_t numBlocks()
+   {
+      size_t num = 0;
+      for (ConcurrentSpy::Block * block = ConcurrentSpy::blocks().load(); block; block = block->next)
+         num++;
+      return num;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,303 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONTAINER STATS
+ * Summary:
+ *    Unit tests for the stats policies of priority_queue and vector
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "container_stats.h"
+#include "priority_queue.h"
+#include "vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cstdint>
+#include <memory>
+
+class TestContainerStats : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Histogram
+      test_histogram_exactBelowSub();
+      test_histogram_relativeError();
+      test_histogram_percentile();
+      test_histogram_empty();
+
+      // No stats
+      test_noStats_noSpace();
+      test_noStats_snapshotZero();
+
+      // Priority queue
+      test_pqueue_counts();
+      test_pqueue_siftLevels();
+      test_pqueue_comparisonsMatchSpy();
+      test_pqueue_reallocations();
+      test_pqueue_shrinkReallocations();
+      test_pqueue_shrinkToEmpty();
+      test_pqueue_latency();
+
+      // Vector
+      test_vector_counts();
+      test_vector_bulkCounts();
+
+      report("ContainerStats");
+   }
+
+   /***************************************
+    * HISTOGRAM
+    ***************************************/
+
+   // small values each have their own bucket
+   void test_histogram_exactBelowSub()
+   {  // setup
+      bool exact = true;
+      // exercise
+      for (uint64_t v = 0; v < custom::latency_histogram::SUB; v++)
+      {
+         size_t bucket = custom::latency_histogram::bucketOf(v);
+         exact = exact && bucket == v && custom::latency_histogram::highestIn(bucket) == v;
+      }
+      // verify
+      assertUnit(exact);
+   }  // teardown
+
+   // a bucket's top is never below the value and within about 3% above it
+   void test_histogram_relativeError()
+   {  // setup
+      bool close = true;
+      size_t previous = 0;
+      bool ordered = true;
+      // exercise
+      for (uint64_t v = 1; v < ((uint64_t)1 << 40); v += v / 7 + 1)
+      {
+         size_t bucket = custom::latency_histogram::bucketOf(v);
+         uint64_t top = custom::latency_histogram::highestIn(bucket);
+         close = close && top >= v && (double)(top - v) <= (double)v / 32.0 + 1.0;
+         ordered = ordered && bucket >= previous;
+         previous = bucket;
+      }
+      // verify
+      assertUnit(close);
+      assertUnit(ordered);
+      assertUnit(custom::latency_histogram::bucketOf(UINT64_MAX) == custom::latency_histogram::BUCKETS - 1);
+   }  // teardown
+
+   // percentiles of 1..1000
+   void test_histogram_percentile()
+   {  // setup
+      custom::latency_histogram h;
+      for (uint64_t v = 1; v <= 1000; v++)
+         h.record(v);
+      // exercise
+      uint64_t p50  = h.percentile(0.50);
+      uint64_t p99  = h.percentile(0.99);
+      uint64_t p999 = h.percentile(0.999);
+      // verify
+      assertUnit(h.count() == 1000);
+      assertUnit(p50 >= 500 && p50 <= 516);
+      assertUnit(p99 >= 990 && p99 <= 1023);
+      assertUnit(p999 >= 999 && p999 <= 1023);
+   }  // teardown
+
+   // no samples, no percentile
+   void test_histogram_empty()
+   {  // setup
+      custom::latency_histogram h;
+      // exercise and verify
+      assertUnit(h.percentile(0.99) == 0);
+   }  // teardown
+
+   /***************************************
+    * NO STATS
+    ***************************************/
+
+   // the default policy fits in padding that was already there
+   void test_noStats_noSpace()
+   {  // exercise and verify
+      assertUnit(sizeof(custom::vector<int>) == sizeof(int *) + 2 * sizeof(size_t) + sizeof(void *));
+      assertUnit(sizeof(custom::priority_queue<int>) == sizeof(custom::vector<int>) + 4 * sizeof(size_t));
+   }  // teardown
+
+   // nothing is counted
+   void test_noStats_snapshotZero()
+   {  // setup
+      custom::priority_queue<int> pq;
+      pq.push(1);
+      pq.push(2);
+      // exercise
+      custom::stats_snapshot s = pq.snapshot();
+      // verify
+      assertUnit(s.pushes == 0);
+      assertUnit(s.maxSize == 0);
+      assertUnit(s.pushP99 == 0);
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // pushes, pops and the high-water mark
+   void test_pqueue_counts()
+   {  // setup
+      custom::priority_queue<int, custom::vector<int>, std::less<int>,
+                             custom::implicit_layout, custom::op_stats> pq;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         pq.push(i);
+      for (int i = 0; i < 4; i++)
+         pq.pop();
+      pq.push(3);
+      custom::stats_snapshot s = pq.snapshot();
+      // verify
+      assertUnit(s.pushes == 11);
+      assertUnit(s.pops == 4);
+      assertUnit(s.maxSize == 10);
+   }  // teardown
+
+   // ascending pushes climb to the root; counted the same both paths
+   //    push 2, 3: one level each; push 4..7: two levels each
+   void test_pqueue_siftLevels()
+   {  // setup
+      custom::priority_queue<int, custom::vector<int>, std::less<int>,
+                             custom::implicit_layout, custom::op_stats> pqInt;
+      custom::priority_queue<Spy, custom::vector<Spy>, std::less<Spy>,
+                             custom::implicit_layout, custom::op_stats> pqSpy;
+      // exercise
+      for (int i = 1; i <= 7; i++)
+      {
+         pqInt.push(i);
+         pqSpy.push(Spy(i));
+      }
+      // verify
+      assertUnit(pqInt.snapshot().siftLevels == 10);
+      assertUnit(pqSpy.snapshot().siftLevels == 10);
+   }  // teardown
+
+   // the comparison count agrees with what Spy saw
+   void test_pqueue_comparisonsMatchSpy()
+   {  // setup
+      custom::priority_queue<Spy, custom::vector<Spy>, std::less<Spy>,
+                             custom::implicit_layout, custom::op_stats> pq;
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 50; i++)
+         pq.push(Spy((i * 37) % 50));
+      while (!pq.empty())
+         pq.pop();
+      // verify
+      assertUnit(pq.snapshot().comparisons == (uint64_t)Spy::numLessthan());
+      assertUnit(pq.snapshot().comparisons > 0);
+   }  // teardown
+
+   // the container doubles: grows at sizes 0, 1, 2 and 4
+   void test_pqueue_reallocations()
+   {  // setup
+      custom::priority_queue<int, custom::vector<int>, std::less<int>,
+                             custom::implicit_layout, custom::op_stats> pq;
+      // exercise
+      for (int i = 0; i < 5; i++)
+         pq.push(i);
+      // verify
+      assertUnit(pq.snapshot().reallocations == 4);
+   }  // teardown
+
+   // a shrink that moves the elements is a reallocation:
+   //    grows at 0, 1, 2 ... 128; shrinks to 126 and to 60
+   void test_pqueue_shrinkReallocations()
+   {  // setup
+      custom::priority_queue<int, custom::vector<int>, std::less<int>,
+                             custom::implicit_layout, custom::op_stats> pq;
+      pq.set_shrink_policy(4, 64);
+      for (int i = 0; i < 256; i++)
+         pq.push(i);
+      // exercise
+      while (!pq.empty())
+         pq.pop();
+      // verify
+      assertUnit(pq.snapshot().reallocations == 9 + 2);
+   }  // teardown
+
+   // emptying the queue frees its buffer; nothing moves, nothing is counted
+   void test_pqueue_shrinkToEmpty()
+   {  // setup
+      custom::priority_queue<int, custom::vector<int>, std::less<int>,
+                             custom::implicit_layout, custom::op_stats> pq;
+      pq.set_shrink_policy(4, 0);
+      for (int i = 0; i < 4; i++)
+         pq.push(i);
+      // exercise
+      while (!pq.empty())
+         pq.pop();
+      // verify
+      assertUnit(pq.snapshot().reallocations == 3);
+   }  // teardown
+
+   // every push and pop is timed
+   void test_pqueue_latency()
+   {  // setup
+      custom::priority_queue<int, custom::vector<int>, std::less<int>,
+                             custom::implicit_layout, custom::op_stats> pq;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         pq.push(i);
+      for (int i = 0; i < 300; i++)
+         pq.pop();
+      custom::stats_snapshot s = pq.snapshot();
+      // verify
+      assertUnit(s.pushP50 > 0);
+      assertUnit(s.popP50 > 0);
+      assertUnit(s.pushP50 <= s.pushP99 && s.pushP99 <= s.pushP999);
+      assertUnit(s.popP50 <= s.popP99 && s.popP99 <= s.popP999);
+   }  // teardown
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // push_back, pop_back, the high-water mark and the growth
+   void test_vector_counts()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::op_stats> v;
+      // exercise
+      for (int i = 0; i < 9; i++)
+         v.push_back(i);
+      v.pop_back();
+      v.shrink_to_fit();
+      custom::stats_snapshot s = v.snapshot();
+      // verify
+      assertUnit(s.pushes == 9);
+      assertUnit(s.pops == 1);
+      assertUnit(s.maxSize == 9);
+      assertUnit(s.reallocations == 6);   // 1, 2, 4, 8, 16, then 8
+   }  // teardown
+
+   // bulk adds and removals count each element, as push_back and pop_back do
+   void test_vector_bulkCounts()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::op_stats> v;
+      int values[] = { 1, 2, 3, 4, 5 };
+      // exercise
+      v.append_range(values, values + 5);               // +5
+      v.insert(v.begin() + 1, values, values + 3);      // +3
+      v.erase(v.begin(), v.begin() + 2);                // -2
+      v.assign(values, values + 4);                     // -6, +4
+      custom::stats_snapshot s = v.snapshot();
+      // verify
+      assertUnit(s.pushes == 12);
+      assertUnit(s.pops == 8);
+      assertUnit(s.maxSize == 8);
+      assertUnit(v.size() == 4);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,368 @@
+/***********************************************************************
+ * Header:
+ *    TEST D-ARY HEAP
+ * Summary:
+ *    Unit tests for the d-ary heap and its child selection
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "dary_heap.h"
+#include "child_select.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class TestDaryHeap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_range();
+      test_construct_moveContainer();
+
+      // Access
+      test_top_empty();
+      test_top_standard();
+
+      // Child select
+      test_childSelect_everyPosition();
+      test_childSelect_ties();
+      test_childSelect_scalarAgrees();
+
+      // Insert and remove
+      test_pop_empty();
+      test_pop_sorted2();
+      test_pop_sorted4();
+      test_pop_sorted8();
+      test_pop_minHeap();
+      test_pop_double();
+      test_pop_partialChildren();
+      test_pop_spy();
+      test_pop_prefetch();
+
+      report("DaryHeap");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing stored
+   void test_construct_default()
+   {  // exercise
+      custom::dary_heap <int> h;
+      // verify
+      assertUnit(h.empty());
+      assertUnit(h.size() == 0);
+      assertUnit(h.container.empty());
+   }  // teardown
+
+   // range constructor builds a valid heap
+   void test_construct_range()
+   {  // setup
+      int values[] = { 3, 9, 1, 7, 5, 8, 2, 6, 4, 10 };
+      // exercise
+      custom::dary_heap <int, 4> h(values, values + 10);
+      // verify
+      assertUnit(h.size() == 10);
+      assertUnit(h.container.capacity() == 10);
+      assertUnit(isHeap(h));
+      assertUnit(h.top() == 10);
+   }  // teardown
+
+   // adopt a container and heapify it in place
+   void test_construct_moveContainer()
+   {  // setup
+      custom::vector <uint32_t> v { 4, 8, 15, 16, 23, 42, 1, 2, 3 };
+      // exercise
+      custom::dary_heap <uint32_t, 8> h(std::less<uint32_t>(), std::move(v));
+      // verify
+      assertUnit(v.empty());
+      assertUnit(h.size() == 9);
+      assertUnit(isHeap(h));
+      assertUnit(h.top() == 42);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty heap throws
+   void test_top_empty()
+   {  // setup
+      custom::dary_heap <int> h;
+      bool thrown = false;
+      // exercise
+      try { h.top(); } catch (const std::out_of_range &) { thrown = true; }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // the largest is on top
+   void test_top_standard()
+   {  // setup
+      custom::dary_heap <int> h;
+      int values[] = { 10, 8, 9, 4, 3, 7, 5 };
+      // exercise
+      for (int v : values)
+         h.push(v);
+      // verify
+      assertUnit(h.top() == 10);
+      assertUnit(isHeap(h));
+   }  // teardown
+
+   /***************************************
+    * CHILD SELECT
+    ***************************************/
+
+   // the best child is found wherever it sits
+   void test_childSelect_everyPosition()
+   {  // setup
+      bool found = true;
+      // exercise
+      for (size_t pos = 0; pos < 8; pos++)
+      {
+         found = found && selectAt<uint32_t, 4>(pos) && selectAt<uint32_t, 8>(pos);
+         found = found && selectAt<uint64_t, 4>(pos) && selectAt<uint64_t, 8>(pos);
+         found = found && selectAt<float,    4>(pos) && selectAt<float,    8>(pos);
+         found = found && selectAt<double,   4>(pos) && selectAt<double,   8>(pos);
+      }
+      // verify
+      assertUnit(found);
+   }  // teardown
+
+   // equal children: the first one wins, as in the scalar loop
+   void test_childSelect_ties()
+   {  // setup
+      uint32_t u32[8] = { 1, 9, 3, 9, 2, 9, 0, 9 };
+      uint64_t u64[8] = { 5, 5, 5, 5, 5, 5, 5, 5 };
+      double   dbl[8] = { 2.0, 1.0, 1.0, 3.0, 1.0, 3.0, 1.0, 2.0 };
+      // exercise and verify
+      assertUnit((custom::child_select<uint32_t, 8, std::less<uint32_t>>::best(u32, std::less<uint32_t>())) == 1);
+      assertUnit((custom::child_select<uint32_t, 8, std::greater<uint32_t>>::best(u32, std::greater<uint32_t>())) == 6);
+      assertUnit((custom::child_select<uint64_t, 8, std::less<uint64_t>>::best(u64, std::less<uint64_t>())) == 0);
+      assertUnit((custom::child_select<double, 8, std::less<double>>::best(dbl, std::less<double>())) == 3);
+      assertUnit((custom::child_select<double, 8, std::greater<double>>::best(dbl, std::greater<double>())) == 1);
+   }  // teardown
+
+   // with the kernels turned off the heap comes out the same
+   void test_childSelect_scalarAgrees()
+   {  // setup
+      bool saved = custom::simd::useAvx2();
+      custom::vector <uint64_t> vectorOrder;
+      custom::vector <uint64_t> scalarOrder;
+      // exercise
+      drain<uint64_t, 8, std::greater<uint64_t>>(1000, vectorOrder);
+      custom::simd::useAvx2() = false;
+      drain<uint64_t, 8, std::greater<uint64_t>>(1000, scalarOrder);
+      custom::simd::useAvx2() = saved;
+      // verify
+      assertUnit(vectorOrder.size() == 1000);
+      assertUnit(scalarOrder.size() == 1000);
+      bool same = true;
+      for (size_t i = 0; i < vectorOrder.size() && i < scalarOrder.size(); i++)
+         same = same && vectorOrder[i] == scalarOrder[i];
+      assertUnit(same);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop from an empty heap does nothing
+   void test_pop_empty()
+   {  // setup
+      custom::dary_heap <int> h;
+      // exercise
+      h.pop();
+      // verify
+      assertUnit(h.empty());
+   }  // teardown
+
+   // a binary heap drains largest first
+   void test_pop_sorted2()
+   {  // exercise and verify
+      assertUnit((drainsSorted<int, 2, std::less<int>>(500)));
+   }  // teardown
+
+   // a 4-ary heap of every kernel type drains in order
+   void test_pop_sorted4()
+   {  // exercise and verify
+      assertUnit((drainsSorted<uint32_t, 4, std::less<uint32_t>>(1000)));
+      assertUnit((drainsSorted<uint64_t, 4, std::less<uint64_t>>(1000)));
+      assertUnit((drainsSorted<float,    4, std::less<float>>(1000)));
+      assertUnit((drainsSorted<double,   4, std::less<double>>(1000)));
+   }  // teardown
+
+   // an 8-ary heap of every kernel type drains in order
+   void test_pop_sorted8()
+   {  // exercise and verify
+      assertUnit((drainsSorted<uint32_t, 8, std::less<uint32_t>>(1000)));
+      assertUnit((drainsSorted<uint64_t, 8, std::less<uint64_t>>(1000)));
+      assertUnit((drainsSorted<float,    8, std::less<float>>(1000)));
+      assertUnit((drainsSorted<double,   8, std::less<double>>(1000)));
+   }  // teardown
+
+   // std::greater puts the smallest on top
+   void test_pop_minHeap()
+   {  // exercise and verify
+      assertUnit((drainsSorted<uint32_t, 8, std::greater<uint32_t>>(1000)));
+      assertUnit((drainsSorted<uint64_t, 4, std::greater<uint64_t>>(1000)));
+      assertUnit((drainsSorted<float,    8, std::greater<float>>(1000)));
+      assertUnit((drainsSorted<double,   4, std::greater<double>>(1000)));
+   }  // teardown
+
+   // negative and fractional keys, where float compares must be signed
+   void test_pop_double()
+   {  // setup
+      double values[] = { -1.5, 2.25, -0.0, 1e300, -1e300, 0.5, 3.0, -7.0, 0.0 };
+      custom::dary_heap <double, 4, custom::vector<double>, std::greater<double>> h(values, values + 9);
+      // exercise and verify
+      assertUnit(h.top() == -1e300);
+      h.pop();
+      assertUnit(h.top() == -7.0);
+      h.pop();
+      assertUnit(h.top() == -1.5);
+   }  // teardown
+
+   // the last parent has fewer than D children
+   void test_pop_partialChildren()
+   {  // setup
+      custom::dary_heap <uint32_t, 8> h;
+      for (uint32_t i = 0; i < 12; i++)
+         h.push(i);
+      // exercise
+      h.pop();
+      // verify
+      assertUnit(h.size() == 11);
+      assertUnit(isHeap(h));
+      assertUnit(h.top() == 10);
+   }  // teardown
+
+   // removing an element destroys exactly one Spy
+   void test_pop_spy()
+   {  // setup
+      custom::dary_heap <Spy, 4> h;
+      for (int i = 1; i <= 9; i++)
+         h.push(Spy(i));
+      Spy::reset();
+      // exercise
+      h.pop();
+      // verify
+      assertUnit(Spy::numDestructor() == 2);   // destroy [9] and the held-aside [1]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(h.size() == 8);
+      assertUnit(h.top() == Spy(8));
+      assertUnit(isHeap(h));
+   }  // teardown
+
+   // prefetching from the first element changes nothing but timing
+   void test_pop_prefetch()
+   {  // setup
+      custom::dary_heap <uint64_t, 8> h;
+      h.set_prefetch_threshold(0);
+      for (uint64_t i = 0; i < 1000; i++)
+         h.push((i * 7919) % 1000);
+      bool sorted = true;
+      // exercise
+      for (uint64_t expected = 1000; expected-- > 0; )
+      {
+         sorted = sorted && h.top() == expected;
+         h.pop();
+      }
+      // verify
+      assertUnit(sorted);
+      assertUnit(h.empty());
+   }  // teardown
+
+   /****************************************************************
+    * IS HEAP
+    * No child belongs above its parent.
+    ****************************************************************/
+   template <class T, size_t D, class Container, class Compare>
+   bool isHeap(const custom::dary_heap <T, D, Container, Compare> & h)
+   {
+      for (size_t i = 1; i < h.size(); i++)
+         if (h.compare(h.container[(i - 1) / D], h.container[i]))
+            return false;
+      return true;
+   }
+
+   /****************************************************************
+    * SELECT AT
+    * D distinct children with the largest at POS (if POS < D)
+    ****************************************************************/
+   template <class T, size_t D>
+   bool selectAt(size_t pos)
+   {
+      if (pos >= D)
+         return true;
+      T children[D];
+      for (size_t i = 0; i < D; i++)
+         children[i] = (T)(10 + (i * 3) % D);
+      children[pos] = (T)100;
+      size_t largest = custom::child_select<T, D, std::less<T>>::best(children, std::less<T>());
+      children[pos] = (T)1;
+      size_t smallest = custom::child_select<T, D, std::greater<T>>::best(children, std::greater<T>());
+      return largest == pos && smallest == pos;
+   }
+
+   /****************************************************************
+    * DRAIN
+    * Push N pseudo-random keys, then pop them all into ORDER
+    ****************************************************************/
+   template <class T, size_t D, class Compare>
+   void drain(size_t n, custom::vector <T> & order)
+   {
+      custom::dary_heap <T, D, custom::vector<T>, Compare> h;
+      uint64_t seed = 11;
+      for (size_t i = 0; i < n; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         h.push((T)((seed >> 33) % 300));   // plenty of duplicates
+      }
+      while (!h.empty())
+      {
+         order.push_back(h.top());
+         h.pop();
+      }
+   }
+
+   /****************************************************************
+    * DRAINS SORTED
+    * Draining N keys agrees with std::sort
+    ****************************************************************/
+   template <class T, size_t D, class Compare>
+   bool drainsSorted(size_t n)
+   {
+      custom::vector <T> order;
+      drain<T, D, Compare>(n, order);
+      std::vector <T> expected;
+      for (size_t i = 0; i < order.size(); i++)
+         expected.push_back(order[i]);
+      std::sort(expected.begin(), expected.end(), Compare());
+      std::reverse(expected.begin(), expected.end());
+      if (order.size() != n)
+         return false;
+      for (size_t i = 0; i < n; i++)
+         if (!(order[i] == expected[i]))
+            return false;
+      return true;
+   }
+};
+
+#endif // DEBUG
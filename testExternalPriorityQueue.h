@@ -0,0 +1,402 @@
+/***********************************************************************
+ * Header:
+ *    TEST EXTERNAL PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the external priority queue
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(DEBUG) && (defined(__unix__) || defined(__APPLE__))
+
+#include "external_priority_queue.h"
+#include "unitTest.h"
+
+#include <csignal>      // for SIGXFSZ
+#include <cstdint>
+#include <cstdlib>      // for getenv, setenv, unsetenv
+#include <functional>   // for std::greater
+#include <queue>        // for std::priority_queue, the reference
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <sys/resource.h>   // for RLIMIT_FSIZE, to make writes fail
+
+class TestExternalPQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Access
+      test_top_empty();
+
+      // In memory
+      test_push_noSpill();
+
+      // Directory
+      test_directory_tmpdir();
+      test_directory_noTmpdir();
+
+      // Runs
+      test_push_spills();
+      test_pop_mergesRuns();
+      test_pop_interleaved();
+      test_spill_fanIn();
+      test_spill_levels();
+      test_spill_reusesSlots();
+      test_compare_greater();
+
+      // Failures
+      test_spill_writeFails();
+      test_merge_writeFails();
+
+      report("ExternalPQueue");
+   }
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // top of nothing throws like priority_queue
+   void test_top_empty()
+   {  // setup
+      custom::external_priority_queue<int> pq(16);
+      // exercise
+      bool thrown = false;
+      try
+      {
+         pq.top();
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   /***************************************
+    * IN MEMORY
+    ***************************************/
+
+   // a buffer that never fills never touches the disk
+   void test_push_noSpill()
+   {  // setup
+      custom::external_priority_queue<int> pq(16);
+      // exercise
+      for (int i = 0; i < 16; i++)
+         pq.push((i * 5) % 16);
+      // verify
+      assertUnit(pq.size() == 16);
+      assertUnit(pq.runs() == 0);
+      assertUnit(pq.files.empty());
+      assertUnit(pq.top() == 15);
+   }  // teardown
+
+   /***************************************
+    * DIRECTORY
+    ***************************************/
+
+   // runs go where TMPDIR says
+   void test_directory_tmpdir()
+   {  // setup
+      TmpdirSetting setting(".");
+      // exercise
+      custom::external_priority_queue<int> pq(4);
+      for (int i = 0; i < 10; i++)
+         pq.push(i);
+      // verify
+      assertUnit(pq.directory == ".");
+      assertUnit(pq.runs() == 2);
+      assertUnit(pq.top() == 9);
+   }  // teardown
+
+   // without TMPDIR, /tmp
+   void test_directory_noTmpdir()
+   {  // setup
+      TmpdirSetting setting(nullptr);
+      // exercise
+      custom::external_priority_queue<int> pq(4);
+      // verify
+      assertUnit(pq.directory == "/tmp");
+   }  // teardown
+
+   // while in scope, TMPDIR is VALUE, or unset for nullptr
+   class TmpdirSetting
+   {
+   public:
+      TmpdirSetting(const char * value)
+      {
+         const char * old = std::getenv("TMPDIR");
+         hadOld = old != nullptr;
+         if (hadOld)
+            saved = old;
+         if (value)
+            setenv("TMPDIR", value, 1);
+         else
+            unsetenv("TMPDIR");
+      }
+      ~TmpdirSetting()
+      {
+         if (hadOld)
+            setenv("TMPDIR", saved.c_str(), 1);
+         else
+            unsetenv("TMPDIR");
+      }
+   private:
+      bool        hadOld;
+      std::string saved;
+   };
+
+   /***************************************
+    * RUNS
+    ***************************************/
+
+   // every full buffer becomes a run
+   void test_push_spills()
+   {  // setup
+      custom::external_priority_queue<int> pq(100);
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 7) % 1000);
+      // verify
+      assertUnit(pq.runs() == 9);
+      assertUnit(pq.buffer.size() == 100);
+      assertUnit(pq.numOnDisk == 900);
+      assertUnit(pq.size() == 1000);
+      assertUnit(pq.top() == 999);
+   }  // teardown
+
+   // popping walks the runs and the buffer in order
+   void test_pop_mergesRuns()
+   {  // setup
+      custom::external_priority_queue<int> pq(100);
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 7) % 1000);
+      // exercise
+      bool ordered = true;
+      for (int expect = 999; expect >= 0; expect--)
+      {
+         ordered = ordered && pq.top() == expect;
+         pq.pop();
+      }
+      // verify
+      assertUnit(ordered);
+      assertUnit(pq.empty());
+      assertUnit(pq.runs() == 0);
+   }  // teardown
+
+   // pushes and pops mixed agree with std::priority_queue
+   void test_pop_interleaved()
+   {  // setup
+      custom::external_priority_queue<uint64_t> pq(64);
+      std::priority_queue<uint64_t> reference;
+      uint64_t state = 43;
+      // exercise
+      bool agree = true;
+      for (int i = 0; i < 20000; i++)
+      {
+         state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+         if ((state >> 60) < 10 || reference.empty())
+         {
+            pq.push(state >> 20);
+            reference.push(state >> 20);
+         }
+         else
+         {
+            agree = agree && pq.top() == reference.top();
+            pq.pop();
+            reference.pop();
+         }
+      }
+      while (agree && !reference.empty())
+      {
+         agree = pq.top() == reference.top();
+         pq.pop();
+         reference.pop();
+      }
+      // verify
+      assertUnit(agree);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // fanIn runs of one level are merged, so few stay live:
+   //    19 spills leave one run of level 2 and three of level 0
+   void test_spill_fanIn()
+   {  // setup
+      custom::external_priority_queue<int> pq(10);
+      pq.fanIn = 4;
+      // exercise
+      for (int i = 0; i < 200; i++)
+         pq.push((i * 13) % 200);
+      // verify
+      assertUnit(pq.runs() <= 4);
+      assertUnit(pq.size() == 200);
+      bool ordered = true;
+      for (int expect = 199; expect >= 0; expect--)
+      {
+         ordered = ordered && pq.top() == expect;
+         pq.pop();
+      }
+      assertUnit(ordered);
+   }  // teardown
+
+   // a merge only rewrites its own level: 63 spills of 10 leave three runs
+   //    at each of levels 2, 1 and 0, written 3, 2 and 1 times
+   void test_spill_levels()
+   {  // setup
+      custom::external_priority_queue<int> pq(10);
+      pq.fanIn = 4;
+      // exercise
+      for (int i = 0; i < 640; i++)
+         pq.push((i * 13) % 640);
+      // verify
+      assertUnit(pq.runs() == 9);
+      assertUnit(pq.levels.size() == 3);
+      if (pq.levels.size() == 3)
+      {
+         assertUnit(pq.levels[0] == 3);
+         assertUnit(pq.levels[1] == 3);
+         assertUnit(pq.levels[2] == 3);
+      }
+      assertUnit(pq.numWritten == 480 * 3 + 120 * 2 + 30);
+      bool ordered = true;
+      for (int expect = 639; expect >= 0; expect--)
+      {
+         ordered = ordered && pq.top() == expect;
+         pq.pop();
+      }
+      assertUnit(ordered);
+   }  // teardown
+
+   // once every run is drained, their slots are let go
+   void test_spill_reusesSlots()
+   {  // setup
+      custom::external_priority_queue<int> pq(10);
+      for (int i = 0; i < 50; i++)
+         pq.push(i);
+      while (!pq.empty())
+         pq.pop();
+      // exercise
+      for (int i = 0; i < 11; i++)
+         pq.push(i);
+      // verify
+      assertUnit(pq.files.size() == 1);
+      assertUnit(pq.runs() == 1);
+      assertUnit(pq.top() == 10);
+   }  // teardown
+
+   // std::greater puts the smallest on top, on disk as in memory
+   void test_compare_greater()
+   {  // setup
+      custom::external_priority_queue<int, std::greater<int>> pq(8);
+      for (int i = 0; i < 40; i++)
+         pq.push((i * 3) % 40);
+      // exercise
+      bool ordered = true;
+      for (int expect = 0; expect < 40; expect++)
+      {
+         ordered = ordered && pq.top() == expect;
+         pq.pop();
+      }
+      // verify
+      assertUnit(ordered);
+   }  // teardown
+
+   /***************************************
+    * FAILURES
+    ***************************************/
+
+   // a failed spill throws and leaves the buffer as it was
+   void test_spill_writeFails()
+   {  // setup
+      custom::external_priority_queue<int> pq(2000);
+      for (int i = 0; i < 2000; i++)
+         pq.push((i * 7) % 2000);
+      // exercise
+      bool thrown = false;
+      {
+         FileSizeLimit limit(4096);
+         try
+         {
+            pq.push(5000);
+         }
+         catch (const std::system_error &)
+         {
+            thrown = true;
+         }
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(pq.size() == 2000);
+      assertUnit(pq.runs() == 0);
+      bool ordered = true;
+      for (int expect = 1999; expect >= 0; expect--)
+      {
+         ordered = ordered && pq.top() == expect;
+         pq.pop();
+      }
+      assertUnit(ordered);
+   }  // teardown
+
+   // a failed merge throws and winds its runs back to where they were
+   void test_merge_writeFails()
+   {  // setup
+      custom::external_priority_queue<int> pq(100);
+      pq.fanIn = 2;
+      for (int i = 0; i < 200; i++)
+         pq.push((i * 7) % 200);
+      // exercise
+      bool thrown = false;
+      {
+         FileSizeLimit limit(600);   // a run of 100 fits, a merge of two does not
+         try
+         {
+            pq.push(5000);
+         }
+         catch (const std::system_error &)
+         {
+            thrown = true;
+         }
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(pq.size() == 200);
+      assertUnit(pq.runs() == 2);
+      bool ordered = true;
+      for (int expect = 199; expect >= 0; expect--)
+      {
+         ordered = ordered && pq.top() == expect;
+         pq.pop();
+      }
+      assertUnit(ordered);
+   }  // teardown
+
+   // while in scope, no file may grow past BYTES; writes past it fail
+   class FileSizeLimit
+   {
+   public:
+      FileSizeLimit(rlim_t bytes) : handler(std::signal(SIGXFSZ, SIG_IGN))
+      {
+         getrlimit(RLIMIT_FSIZE, &saved);
+         rlimit limit = saved;
+         limit.rlim_cur = bytes;
+         setrlimit(RLIMIT_FSIZE, &limit);
+      }
+      ~FileSizeLimit()
+      {
+         setrlimit(RLIMIT_FSIZE, &saved);
+         std::signal(SIGXFSZ, handler);
+      }
+   private:
+      rlimit saved;
+      void (*handler)(int);
+   };
+};
+
+#endif // DEBUG && POSIX
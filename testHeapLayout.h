@@ -0,0 +1,244 @@
+/***********************************************************************
+ * Header:
+ *    TEST HEAP LAYOUT
+ * Summary:
+ *    Unit tests for the heap layouts and priority_queue built on them
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "heap_layout.h"
+#include "priority_queue.h"
+#include "unitTest.h"
+
+#include <cstdint>
+
+class TestHeapLayout : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Index arithmetic
+      test_implicit_standard();
+      test_blocked_heightOneIsImplicit();
+      test_blocked_cacheLine();
+      test_blocked_childrenAgreeWithParent();
+      test_blocked_lastParent();
+      test_blocked_cursor();
+
+      // Priority queue
+      test_pqueue_blockedPushPop();
+      test_pqueue_blockedRange();
+      test_pqueue_prefetch();
+
+      report("HeapLayout");
+   }
+
+   /***************************************
+    * INDEX ARITHMETIC
+    ***************************************/
+
+   // children at 2i and 2i+1
+   void test_implicit_standard()
+   {  // exercise and verify
+      assertUnit(custom::implicit_layout::left(1) == 2);
+      assertUnit(custom::implicit_layout::right(1) == 3);
+      assertUnit(custom::implicit_layout::parent(7) == 3);
+      assertUnit(custom::implicit_layout::parent(1) == 0);
+      assertUnit(custom::implicit_layout::lastParent(7) == 3);
+   }  // teardown
+
+   // one-level blocks are the breadth-first array
+   void test_blocked_heightOneIsImplicit()
+   {  // setup
+      typedef custom::blocked_layout<1> Blocked;
+      bool same = true;
+      // exercise
+      for (size_t i = 1; i < 1000; i++)
+      {
+         same = same && Blocked::left(i)   == custom::implicit_layout::left(i);
+         same = same && Blocked::right(i)  == custom::implicit_layout::right(i);
+         same = same && Blocked::parent(i) == custom::implicit_layout::parent(i);
+      }
+      // verify
+      assertUnit(same);
+   }  // teardown
+
+   // blocks of two levels: the root is alone, 2-7 is the first block,
+   // its leaf 4 has the child block 8-13, its leaf 7 the block 26-31
+   //
+   //                   1
+   //           2               3
+   //       4       5       6       7
+   //     8   9  14  15  20  21  26  27
+   void test_blocked_cacheLine()
+   {  // setup
+      typedef custom::blocked_layout<2> Blocked;
+      // exercise and verify
+      assertUnit(Blocked::left(1) == 2);
+      assertUnit(Blocked::right(3) == 7);
+      assertUnit(Blocked::left(4) == 8);
+      assertUnit(Blocked::right(4) == 9);
+      assertUnit(Blocked::left(5) == 14);
+      assertUnit(Blocked::left(7) == 26);
+      assertUnit(Blocked::right(7) == 27);
+      assertUnit(Blocked::left(8) == 10);
+      assertUnit(Blocked::parent(8) == 4);
+      assertUnit(Blocked::parent(15) == 5);
+      assertUnit(Blocked::parent(27) == 7);
+      assertUnit(Blocked::parent(13) == 9);
+   }  // teardown
+
+   // a cursor walking down finds the same children as left()
+   void test_blocked_cursor()
+   {  // setup
+      typedef custom::blocked_layout<3> Blocked;
+      bool same = true;
+      // exercise
+      for (size_t start = 1; start < 200; start++)
+      {
+         Blocked::cursor node(start);
+         for (int level = 0; level < 12; level++)
+         {
+            same = same && node.left() == Blocked::left(node.position());
+            node.down(node.left() + (level + start) % 2);
+         }
+      }
+      // verify
+      assertUnit(same);
+   }  // teardown
+
+   // every node is its children's parent, and comes before them
+   void test_blocked_childrenAgreeWithParent()
+   {  // setup
+      bool agree = true;
+      // exercise
+      agree = agree && childrenAgree<custom::blocked_layout<2>>(5000);
+      agree = agree && childrenAgree<custom::blocked_layout<3>>(5000);
+      agree = agree && childrenAgree<custom::blocked_layout<9>>(5000);
+      // verify
+      assertUnit(agree);
+   }  // teardown
+
+   // lastParent is the largest parent of any of the first n nodes
+   void test_blocked_lastParent()
+   {  // setup
+      typedef custom::blocked_layout<3> Blocked;
+      size_t largest = 0;
+      bool same = true;
+      // exercise
+      for (size_t n = 1; n < 2000; n++)
+      {
+         if (Blocked::parent(n) > largest)
+            largest = Blocked::parent(n);
+         same = same && Blocked::lastParent(n) == largest;
+      }
+      // verify
+      assertUnit(same);
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // a blocked priority_queue drains largest first
+   void test_pqueue_blockedPushPop()
+   {  // setup
+      custom::priority_queue <uint32_t, custom::vector<uint32_t>, std::less<uint32_t>,
+                              custom::blocked_layout<3>> pq;
+      uint64_t seed = 3;
+      for (int i = 0; i < 2000; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         pq.push((uint32_t)(seed >> 40));
+      }
+      bool sorted = true;
+      uint32_t previous = UINT32_MAX;
+      // exercise
+      while (!pq.empty())
+      {
+         sorted = sorted && pq.top() <= previous;
+         previous = pq.top();
+         pq.pop();
+      }
+      // verify
+      assertUnit(sorted);
+   }  // teardown
+
+   // heapify works backwards through the blocks
+   void test_pqueue_blockedRange()
+   {  // setup
+      custom::vector <int> v;
+      for (int i = 0; i < 500; i++)
+         v.push_back((i * 37) % 503);
+      bool sorted = true;
+      int previous = 503;
+      // exercise
+      custom::priority_queue <int, custom::vector<int>, std::less<int>,
+                              custom::blocked_layout<4>> pq(std::less<int>(), std::move(v));
+      // verify
+      assertUnit(pq.size() == 500);
+      assertUnit(pq.top() == 502);
+      while (!pq.empty())
+      {
+         sorted = sorted && pq.top() <= previous;
+         previous = pq.top();
+         pq.pop();
+      }
+      assertUnit(sorted);
+   }  // teardown
+
+   // prefetching from the first element changes nothing but timing,
+   // in either layout
+   void test_pqueue_prefetch()
+   {  // setup
+      custom::priority_queue <int> pqImplicit;
+      custom::priority_queue <int, custom::vector<int>, std::less<int>,
+                              custom::blocked_layout<2>> pqBlocked;
+      pqImplicit.set_prefetch_threshold(0);
+      pqBlocked.set_prefetch_threshold(0);
+      for (int i = 0; i < 1000; i++)
+      {
+         pqImplicit.push((i * 7919) % 1000);
+         pqBlocked.push((i * 7919) % 1000);
+      }
+      bool sorted = true;
+      // exercise
+      for (int expected = 999; expected >= 0; expected--)
+      {
+         sorted = sorted && pqImplicit.top() == expected && pqBlocked.top() == expected;
+         pqImplicit.pop();
+         pqBlocked.pop();
+      }
+      // verify
+      assertUnit(sorted);
+      assertUnit(pqImplicit.empty());
+      assertUnit(pqBlocked.empty());
+   }  // teardown
+
+   /****************************************************************
+    * CHILDREN AGREE
+    * For the first n positions: both children name this node as
+    * their parent and come after it.
+    ****************************************************************/
+   template <class Layout>
+   bool childrenAgree(size_t n)
+   {
+      for (size_t i = 1; i <= n; i++)
+      {
+         if (Layout::parent(Layout::left(i)) != i || Layout::parent(Layout::right(i)) != i)
+            return false;
+         if (Layout::left(i) <= i || Layout::right(i) <= Layout::left(i))
+            return false;
+      }
+      return true;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,293 @@
+/***********************************************************************
+ * Header:
+ *    TEST HEAP TRACE
+ * Summary:
+ *    Unit tests for the heap trace format and the recording queue
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "heap_trace.h"
+#include "unitTest.h"
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+class TestHeapTrace : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Format
+      test_empty();
+      test_pushKeys();
+      test_runs();
+      test_runLongerThanTag();
+      test_compact();
+      test_badHeader();
+      test_truncated();
+
+      // Recorder
+      test_record_operations();
+      test_record_emptyNotLogged();
+      test_record_layoutAndStats();
+
+      report("HeapTrace");
+   }
+
+   /***************************************
+    * FORMAT
+    ***************************************/
+
+   // a trace with nothing in it is just the header
+   void test_empty()
+   {  // setup
+      std::stringstream stream;
+      {
+         custom::trace_writer writer(stream);
+      }
+      custom::trace_reader reader(stream);
+      custom::trace_op op;
+      uint64_t key;
+      // exercise and verify
+      assertUnit(stream.str().size() == 5);
+      assertUnit(reader.next(op, key) == false);
+   }  // teardown
+
+   // keys come back exactly, going up, down, and to the extremes
+   void test_pushKeys()
+   {  // setup
+      const uint64_t keys[] = { 5, 7, 3, 0, UINT64_MAX, 1, UINT64_MAX / 2, 1000000 };
+      std::stringstream stream;
+      {
+         custom::trace_writer writer(stream);
+         for (uint64_t k : keys)
+            writer.push(k);
+      }
+      custom::trace_reader reader(stream);
+      custom::trace_op op;
+      uint64_t key;
+      bool same = true;
+      // exercise
+      for (uint64_t k : keys)
+         same = same && reader.next(op, key) && op == custom::trace_op::PUSH && key == k;
+      // verify
+      assertUnit(same);
+      assertUnit(reader.next(op, key) == false);
+   }  // teardown
+
+   // pops and tops interleaved with pushes keep their order
+   void test_runs()
+   {  // setup
+      std::stringstream stream;
+      {
+         custom::trace_writer writer(stream);
+         writer.push(10);
+         writer.top();
+         writer.top();
+         writer.pop();
+         writer.push(20);
+         writer.pop();
+         writer.pop();
+         writer.pop();
+      }
+      custom::trace_reader reader(stream);
+      const custom::trace_op expected[] = {
+         custom::trace_op::PUSH, custom::trace_op::TOP, custom::trace_op::TOP,
+         custom::trace_op::POP,  custom::trace_op::PUSH, custom::trace_op::POP,
+         custom::trace_op::POP,  custom::trace_op::POP };
+      custom::trace_op op;
+      uint64_t key;
+      bool same = true;
+      // exercise
+      for (custom::trace_op e : expected)
+         same = same && reader.next(op, key) && op == e;
+      // verify
+      assertUnit(same);
+      assertUnit(reader.next(op, key) == false);
+      assertUnit(stream.str().size() == 5 + 2 + 1 + 1 + 2 + 1);
+   }  // teardown
+
+   // a run longer than one tag holds is split across tags
+   void test_runLongerThanTag()
+   {  // setup
+      std::stringstream stream;
+      {
+         custom::trace_writer writer(stream);
+         for (int i = 0; i < 150; i++)
+            writer.pop();
+      }
+      custom::trace_reader reader(stream);
+      custom::trace_op op;
+      uint64_t key;
+      int numPops = 0;
+      // exercise
+      while (reader.next(op, key))
+         numPops += op == custom::trace_op::POP;
+      // verify
+      assertUnit(numPops == 150);
+      assertUnit(stream.str().size() == 5 + 3);
+   }  // teardown
+
+   // ascending keys close together take two bytes a push
+   void test_compact()
+   {  // setup
+      std::stringstream stream;
+      {
+         custom::trace_writer writer(stream);
+         for (uint64_t k = 1000000000; k < 1000000000 + 1000 * 7; k += 7)
+            writer.push(k);
+      }
+      // exercise and verify
+      assertUnit(stream.str().size() == 5 + 6 + 999 * 2);
+   }  // teardown
+
+   // a stream that is not a trace is refused
+   void test_badHeader()
+   {  // setup
+      std::stringstream stream("PQTX\x01");
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::trace_reader reader(stream);
+      }
+      catch (const std::invalid_argument &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // a push cut off in its key is an error, not a zero
+   void test_truncated()
+   {  // setup
+      std::stringstream stream;
+      {
+         custom::trace_writer writer(stream);
+         writer.push(UINT64_MAX / 3);
+      }
+      std::string bytes = stream.str();
+      std::stringstream cut(bytes.substr(0, bytes.size() - 1));
+      custom::trace_reader reader(cut);
+      custom::trace_op op;
+      uint64_t key;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         reader.next(op, key);
+      }
+      catch (const std::invalid_argument &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   /***************************************
+    * RECORDER
+    ***************************************/
+
+   // the recorder serves the queue and logs what it served
+   void test_record_operations()
+   {  // setup
+      std::stringstream stream;
+      int served = 0;
+      {
+         custom::trace_writer writer(stream);
+         custom::recording_priority_queue<int> pq(writer);
+         // exercise
+         pq.push(3);
+         pq.push(9);
+         served = pq.top();
+         pq.pop();
+      }
+      custom::trace_reader reader(stream);
+      custom::trace_op op;
+      uint64_t key;
+      // verify
+      assertUnit(served == 9);
+      assertUnit(reader.next(op, key) && op == custom::trace_op::PUSH && key == 3);
+      assertUnit(reader.next(op, key) && op == custom::trace_op::PUSH && key == 9);
+      assertUnit(reader.next(op, key) && op == custom::trace_op::TOP);
+      assertUnit(reader.next(op, key) && op == custom::trace_op::POP);
+      assertUnit(reader.next(op, key) == false);
+   }  // teardown
+
+   // top and pop on an empty queue leave no record
+   void test_record_emptyNotLogged()
+   {  // setup
+      std::stringstream stream;
+      bool thrown = false;
+      {
+         custom::trace_writer writer(stream);
+         custom::recording_priority_queue<int> pq(writer);
+         // exercise
+         pq.pop();
+         try
+         {
+            pq.top();
+         }
+         catch (const std::out_of_range &)
+         {
+            thrown = true;
+         }
+      }
+      custom::trace_reader reader(stream);
+      custom::trace_op op;
+      uint64_t key;
+      // verify
+      assertUnit(thrown);
+      assertUnit(reader.next(op, key) == false);
+   }  // teardown
+
+   // a queue with its own layout and stats is recorded as itself
+   void test_record_layoutAndStats()
+   {  // setup
+      std::stringstream stream;
+      custom::stats_snapshot stats;
+      bool ordered = true;
+      {
+         custom::trace_writer writer(stream);
+         custom::recording_priority_queue<int, custom::vector<int>, std::less<int>,
+                                          custom::blocked_layout<3>, custom::op_stats> pq(writer);
+         // exercise
+         for (int i = 0; i < 100; i++)
+            pq.push((i * 37) % 100);
+         for (int expect = 99; expect >= 90; expect--)
+         {
+            ordered = ordered && pq.top() == expect;
+            pq.pop();
+         }
+         stats = pq.snapshot();
+      }
+      custom::trace_reader reader(stream);
+      custom::trace_op op;
+      uint64_t key;
+      size_t numPushes = 0;
+      size_t numPops = 0;
+      while (reader.next(op, key))
+      {
+         numPushes += op == custom::trace_op::PUSH;
+         numPops += op == custom::trace_op::POP;
+      }
+      // verify
+      assertUnit(ordered);
+      assertUnit(stats.pushes == 100);
+      assertUnit(stats.pops == 10);
+      assertUnit(numPushes == 100);
+      assertUnit(numPops == 10);
+   }  // teardown
+};
+
+#endif // DEBUG
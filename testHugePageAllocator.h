@@ -0,0 +1,144 @@
+/***********************************************************************
+ * Header:
+ *    TEST HUGE PAGE ALLOCATOR
+ * Summary:
+ *    Unit tests for the huge page allocator
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(DEBUG) && (defined(__unix__) || defined(__APPLE__))
+
+#include "huge_page_allocator.h"
+#include "priority_queue.h"
+#include "vector.h"
+#include "unitTest.h"
+
+#include <cstdint>
+
+class TestHugePageAllocator : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Allocate
+      test_allocate_small();
+      test_allocate_hugeAligned();
+      test_allocate_roundsUp();
+      test_equal_always();
+
+      // Containers
+      test_vector_grows();
+      test_pqueue_popsInOrder();
+
+      report("HugePageAllocator");
+   }
+
+   typedef custom::huge_page_allocator<uint64_t> Allocator;
+
+   /***************************************
+    * ALLOCATE
+    ***************************************/
+
+   // under a huge page is an ordinary allocation
+   void test_allocate_small()
+   {  // setup
+      Allocator alloc;
+      // exercise
+      uint64_t * p = alloc.allocate(100);
+      p[0] = 1;
+      p[99] = 2;
+      // verify
+      assertUnit(!Allocator::huge(100));
+      assertUnit(p[0] + p[99] == 3);
+      // teardown
+      alloc.deallocate(p, 100);
+   }
+
+   // a huge page or more starts on a 2 MB boundary
+   void test_allocate_hugeAligned()
+   {  // setup
+      Allocator alloc;
+      size_t n = Allocator::HUGE_PAGE_BYTES / sizeof(uint64_t);
+      // exercise
+      uint64_t * p = alloc.allocate(n);
+      p[0] = 1;
+      p[n - 1] = 2;
+      // verify
+      assertUnit(Allocator::huge(n));
+      assertUnit((uintptr_t)p % Allocator::HUGE_PAGE_BYTES == 0);
+      assertUnit(p[0] + p[n - 1] == 3);
+      // teardown
+      alloc.deallocate(p, n);
+   }
+
+   // the mapping covers whole huge pages, so the last one can be written
+   void test_allocate_roundsUp()
+   {  // setup
+      Allocator alloc;
+      size_t n = Allocator::HUGE_PAGE_BYTES / sizeof(uint64_t) + 1;
+      // exercise
+      uint64_t * p = alloc.allocate(n);
+      p[n - 1] = 7;
+      // verify
+      assertUnit(Allocator::mappedBytes(n) == 2 * Allocator::HUGE_PAGE_BYTES);
+      assertUnit((uintptr_t)p % Allocator::HUGE_PAGE_BYTES == 0);
+      assertUnit(p[n - 1] == 7);
+      // teardown
+      alloc.deallocate(p, n);
+   }
+
+   // any one frees what another allocated
+   void test_equal_always()
+   {  // setup
+      Allocator lhs;
+      custom::huge_page_allocator<int> rhs;
+      // exercise
+      // verify
+      assertUnit(lhs == rhs);
+      assertUnit(!(lhs != rhs));
+   }  // teardown
+
+   /***************************************
+    * CONTAINERS
+    ***************************************/
+
+   // growing past a huge page moves the elements onto one
+   void test_vector_grows()
+   {  // setup
+      custom::vector<uint64_t, Allocator> v;
+      // exercise
+      for (uint64_t i = 0; i < 1000000; i++)
+         v.push_back(i * 3);
+      // verify
+      assertUnit((uintptr_t)&v[0] % Allocator::HUGE_PAGE_BYTES == 0);
+      bool same = true;
+      for (uint64_t i = 0; i < 1000000; i++)
+         same = same && v[i] == i * 3;
+      assertUnit(same);
+   }  // teardown
+
+   // a heap on huge pages is still a heap, shrinking as it drains
+   void test_pqueue_popsInOrder()
+   {  // setup
+      custom::priority_queue<uint64_t, custom::vector<uint64_t, Allocator>> pq;
+      for (uint64_t i = 0; i < 400000; i++)
+         pq.push((i * 7919) % 400000);
+      // exercise
+      bool ordered = true;
+      for (uint64_t expect = 400000; ordered && expect > 0; expect--)
+      {
+         ordered = pq.top() == expect - 1;
+         pq.pop();
+      }
+      // verify
+      assertUnit(ordered);
+      assertUnit(pq.empty());
+   }  // teardown
+};
+
+#endif // DEBUG && POSIX
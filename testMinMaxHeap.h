@@ -0,0 +1,306 @@
+/***********************************************************************
+ * Header:
+ *    TEST MIN-MAX HEAP
+ * Summary:
+ *    Unit tests for the min-max heap
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "minmax_heap.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <set>
+#include <iterator>
+
+class TestMinMaxHeap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_range();
+      test_construct_moveContainer();
+
+      // Access
+      test_top_empty();
+      test_top_one();
+      test_top_two();
+      test_top_standard();
+
+      // Insert
+      test_push_levels();
+
+      // Remove
+      test_popMax_empty();
+      test_popMax_standard();
+      test_popMin_standard();
+      test_pop_random();
+      test_pop_spy();
+
+      report("MinMaxHeap");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing stored
+   void test_construct_default()
+   {  // exercise
+      custom::minmax_heap <int> h;
+      // verify
+      assertUnit(h.empty());
+      assertUnit(h.size() == 0);
+      assertUnit(h.container.empty());
+   }  // teardown
+
+   // range constructor builds a valid heap
+   void test_construct_range()
+   {  // setup
+      int values[] = { 3, 9, 1, 7, 5, 8, 2, 6, 4, 10 };
+      // exercise
+      custom::minmax_heap <int> h(values, values + 10);
+      // verify
+      assertUnit(h.size() == 10);
+      assertUnit(h.container.capacity() == 10);
+      assertUnit(isMinMaxHeap(h));
+      assertUnit(h.top_min() == 1);
+      assertUnit(h.top_max() == 10);
+   }  // teardown
+
+   // adopt a container and heapify it in place
+   void test_construct_moveContainer()
+   {  // setup
+      custom::vector <int> v { 4, 8, 15, 16, 23, 42 };
+      // exercise
+      custom::minmax_heap <int> h(std::less<int>(), std::move(v));
+      // verify
+      assertUnit(v.empty());
+      assertUnit(h.size() == 6);
+      assertUnit(isMinMaxHeap(h));
+      assertUnit(h.top_min() == 4);
+      assertUnit(h.top_max() == 42);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // both ends of an empty heap throw
+   void test_top_empty()
+   {  // setup
+      custom::minmax_heap <int> h;
+      int numThrown = 0;
+      // exercise
+      try { h.top_max(); } catch (const std::out_of_range &) { numThrown++; }
+      try { h.top_min(); } catch (const std::out_of_range &) { numThrown++; }
+      // verify
+      assertUnit(numThrown == 2);
+   }  // teardown
+
+   // with one element both ends are the root
+   void test_top_one()
+   {  // setup
+      custom::minmax_heap <int> h;
+      h.push(7);
+      // exercise and verify
+      assertUnit(h.top_min() == 7);
+      assertUnit(h.top_max() == 7);
+      assertUnit(h.top() == 7);
+   }  // teardown
+
+   // with two elements the max is the only child
+   void test_top_two()
+   {  // setup
+      custom::minmax_heap <int> h;
+      h.push(7);
+      h.push(3);
+      // exercise and verify
+      assertUnit(h.container[0] == 3);
+      assertUnit(h.container[1] == 7);
+      assertUnit(h.top_min() == 3);
+      assertUnit(h.top_max() == 7);
+   }  // teardown
+
+   // the standard fixture
+   void test_top_standard()
+   {  // setup
+      custom::minmax_heap <int> h;
+      setupStandardFixture(h);
+      // exercise and verify
+      assertUnit(h.top_min() == 3);
+      assertUnit(h.top_max() == 10);
+      assertUnit(h.top() == 10);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // every push leaves min and max levels in order
+   void test_push_levels()
+   {  // setup
+      custom::minmax_heap <int> h;
+      bool valid = true;
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         h.push((i * 37) % 101);
+         valid = valid && isMinMaxHeap(h);
+      }
+      // verify
+      assertUnit(valid);
+      assertUnit(h.size() == 100);
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop from an empty heap does nothing
+   void test_popMax_empty()
+   {  // setup
+      custom::minmax_heap <int> h;
+      // exercise
+      h.pop_max();
+      h.pop_min();
+      // verify
+      assertUnit(h.empty());
+   }  // teardown
+
+   // pop_max drains largest first
+   void test_popMax_standard()
+   {  // setup
+      custom::minmax_heap <int> h;
+      setupStandardFixture(h);
+      int expected[] = { 10, 9, 8, 7, 5, 4, 3 };
+      // exercise and verify
+      for (int i = 0; i < 7; i++)
+      {
+         assertUnit(h.top_max() == expected[i]);
+         h.pop_max();
+         assertUnit(isMinMaxHeap(h));
+      }
+      assertUnit(h.empty());
+   }  // teardown
+
+   // pop_min drains smallest first
+   void test_popMin_standard()
+   {  // setup
+      custom::minmax_heap <int> h;
+      setupStandardFixture(h);
+      int expected[] = { 3, 4, 5, 7, 8, 9, 10 };
+      // exercise and verify
+      for (int i = 0; i < 7; i++)
+      {
+         assertUnit(h.top_min() == expected[i]);
+         h.pop_min();
+         assertUnit(isMinMaxHeap(h));
+      }
+      assertUnit(h.empty());
+   }  // teardown
+
+   // random pushes and pops at both ends agree with std::multiset
+   void test_pop_random()
+   {  // setup
+      custom::minmax_heap <int> h;
+      std::multiset <int> s;
+      uint64_t seed = 5;
+      bool same = true;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         int op = (int)(seed >> 62);
+         int value = (int)((seed >> 32) % 1000);
+         if (op < 2 || s.empty())
+         {
+            h.push(value);
+            s.insert(value);
+         }
+         else if (op == 2)
+         {
+            same = same && h.top_max() == *s.rbegin();
+            h.pop_max();
+            s.erase(std::prev(s.end()));
+         }
+         else
+         {
+            same = same && h.top_min() == *s.begin();
+            h.pop_min();
+            s.erase(s.begin());
+         }
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(h.size() == s.size());
+      assertUnit(isMinMaxHeap(h));
+   }  // teardown
+
+   // removing an element destroys exactly one Spy
+   void test_pop_spy()
+   {  // setup
+      custom::minmax_heap <Spy> h;
+      for (int i = 1; i <= 7; i++)
+         h.push(Spy(i));
+      Spy::reset();
+      // exercise
+      h.pop_max();
+      h.pop_min();
+      // verify
+      assertUnit(Spy::numDestructor() == 2);   // destroy [7] [1]
+      assertUnit(Spy::numDelete() == 2);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(h.size() == 5);
+      assertUnit(h.top_max() == Spy(6));
+      assertUnit(h.top_min() == Spy(2));
+   }  // teardown
+
+   /****************************************************************
+    * IS MIN-MAX HEAP
+    * Every node on a min level is no larger than its descendants,
+    * every node on a max level no smaller. Checking parents and
+    * grandparents is enough.
+    ****************************************************************/
+   template <class T>
+   bool isMinMaxHeap(const custom::minmax_heap <T> & h)
+   {
+      for (size_t i = 1; i < h.size(); i++)
+      {
+         size_t p = (i - 1) / 2;
+         bool parentIsMin = custom::minmax_heap<T>::isMinLevel(p);
+         if (parentIsMin ? h.container[i] < h.container[p] : h.container[p] < h.container[i])
+            return false;
+         if (p > 0)
+         {
+            size_t g = (p - 1) / 2;
+            if (parentIsMin ? h.container[g] < h.container[i] : h.container[i] < h.container[g])
+               return false;
+         }
+      }
+      return true;
+   }
+
+   /****************************************************************
+    * SETUP STANDARD FIXTURE
+    *   { 10, 8, 9, 4, 3, 7, 5 }
+    ****************************************************************/
+   void setupStandardFixture(custom::minmax_heap <int> & h)
+   {
+      int values[] = { 10, 8, 9, 4, 3, 7, 5 };
+      for (int v : values)
+         h.push(v);
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,301 @@
+/***********************************************************************
+ * Header:
+ *    TEST MMAP VECTOR
+ * Summary:
+ *    Unit tests for the file-backed vector
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#if defined(DEBUG) && (defined(__unix__) || defined(__APPLE__))
+
+#include "mmap_vector.h"
+#include "priority_queue.h"
+#include "unitTest.h"
+
+#include <cstdlib>      // for mkstemp
+#include <string>
+#include <sys/stat.h>   // for stat
+#include <unistd.h>     // for close, unlink
+
+class TestMmapVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Vector
+      test_vector_createEmpty();
+      test_vector_pushPop();
+      test_vector_growIsSparse();
+      test_vector_reopen();
+      test_vector_reopenWrongType();
+      test_vector_anonymous();
+      test_vector_move();
+      test_vector_movedFrom();
+      test_vector_advise();
+
+      // Priority queue
+      test_pqueue_container();
+      test_pqueue_reopenAlreadyHeap();
+      test_pqueue_movedFrom();
+
+      report("MmapVector");
+   }
+
+   /***************************************
+    * A file that goes away with the test
+    ***************************************/
+   struct TempFile
+   {
+      TempFile()
+      {
+         char name[] = "/tmp/pq_mmap_XXXXXX";
+         int fd = mkstemp(name);
+         if (fd >= 0)
+            close(fd);
+         path = name;
+      }
+      ~TempFile() { unlink(path.c_str()); }
+      size_t bytes() const
+      {
+         struct stat info;
+         return stat(path.c_str(), &info) == 0 ? (size_t)info.st_size : 0;
+      }
+      size_t blocks() const
+      {
+         struct stat info;
+         return stat(path.c_str(), &info) == 0 ? (size_t)info.st_blocks * 512 : 0;
+      }
+      std::string path;
+   };
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // a new file holds the header and nothing else
+   void test_vector_createEmpty()
+   {  // setup
+      TempFile file;
+      // exercise
+      custom::mmap_vector<int> v(file.path);
+      // verify
+      assertUnit(v.empty());
+      assertUnit(v.size() == 0);
+      assertUnit(v.capacity() == 0);
+      assertUnit(file.bytes() == custom::mmap_vector<int>::HEADER_BYTES);
+   }  // teardown
+
+   // push and pop at the back
+   void test_vector_pushPop()
+   {  // setup
+      TempFile file;
+      custom::mmap_vector<int> v(file.path);
+      // exercise
+      for (int i = 0; i < 100; i++)
+         v.push_back(i * 3);
+      v.pop_back();
+      // verify
+      assertUnit(v.size() == 99);
+      assertUnit(v.front() == 0);
+      assertUnit(v.back() == 98 * 3);
+      assertUnit(v[50] == 150);
+      assertUnit(v.end() - v.begin() == 99);
+   }  // teardown
+
+   // reserve grows the file without writing it
+   void test_vector_growIsSparse()
+   {  // setup
+      TempFile file;
+      custom::mmap_vector<uint64_t> v(file.path);
+      // exercise
+      v.reserve(1 << 24);
+      v.push_back(7);
+      // verify
+      assertUnit(v.capacity() == 1 << 24);
+      assertUnit(file.bytes() == custom::mmap_vector<uint64_t>::HEADER_BYTES + (8 << 24));
+      assertUnit(file.blocks() < (8 << 24) / 2);
+      assertUnit(v[0] == 7);
+   }  // teardown
+
+   // what was pushed is there when the file is opened again
+   void test_vector_reopen()
+   {  // setup
+      TempFile file;
+      {
+         custom::mmap_vector<int> v(file.path);
+         for (int i = 0; i < 5000; i++)
+            v.push_back(i);
+         v.pop_back();
+      }
+      // exercise
+      custom::mmap_vector<int> v(file.path);
+      // verify
+      assertUnit(v.size() == 4999);
+      assertUnit(v.capacity() >= 4999);
+      assertUnit(v[0] == 0);
+      assertUnit(v[4998] == 4998);
+   }  // teardown
+
+   // a file of other elements is refused
+   void test_vector_reopenWrongType()
+   {  // setup
+      TempFile file;
+      {
+         custom::mmap_vector<int> v(file.path);
+         v.push_back(1);
+      }
+      // exercise
+      bool thrown = false;
+      try
+      {
+         custom::mmap_vector<double> v(file.path);
+      }
+      catch (const std::invalid_argument &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // with no file, anonymous memory grows the same way
+   void test_vector_anonymous()
+   {  // setup
+      custom::mmap_vector<int> v;
+      // exercise
+      for (int i = 0; i < 300000; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.fd == -1);
+      assertUnit(v.size() == 300000);
+      assertUnit(v[0] == 0);
+      assertUnit(v[299999] == 299999);
+   }  // teardown
+
+   // a move takes the mapping and leaves nothing to unmap
+   void test_vector_move()
+   {  // setup
+      TempFile file;
+      custom::mmap_vector<int> v(file.path);
+      v.push_back(4);
+      // exercise
+      custom::mmap_vector<int> moved(std::move(v));
+      // verify
+      assertUnit(v.map == nullptr);
+      assertUnit(v.fd == -1);
+      assertUnit(moved.size() == 1);
+      assertUnit(moved[0] == 4);
+   }  // teardown
+
+   // what a move leaves behind is empty, and can be used again
+   void test_vector_movedFrom()
+   {  // setup
+      TempFile file;
+      custom::mmap_vector<int> v(file.path);
+      v.push_back(4);
+      custom::mmap_vector<int> moved(std::move(v));
+      // exercise
+      bool wasEmpty = v.empty() && v.size() == 0;
+      v.clear();
+      v.pop_back();
+      v.push_back(9);
+      // verify
+      assertUnit(wasEmpty);
+      assertUnit(v.fd == -1);
+      assertUnit(v.size() == 1);
+      assertUnit(v[0] == 9);
+      assertUnit(moved.size() == 1);
+      assertUnit(moved[0] == 4);
+   }  // teardown
+
+   // the advice is kept across a remap
+   void test_vector_advise()
+   {  // setup
+      custom::mmap_vector<int> v;
+      // exercise
+      v.advise(custom::access_pattern::sequential);
+      v.reserve(100000);
+      // verify
+      assertUnit(v.pattern == custom::access_pattern::sequential);
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // a heap in a file pops in order
+   void test_pqueue_container()
+   {  // setup
+      TempFile file;
+      custom::priority_queue<int, custom::mmap_vector<int>> pq(std::less<int>(),
+                                                              custom::mmap_vector<int>(file.path));
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 7) % 1000);
+      // verify
+      bool ordered = true;
+      for (int expect = 999; expect >= 0; expect--)
+      {
+         ordered = ordered && pq.top() == expect;
+         pq.pop();
+      }
+      assertUnit(ordered);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // a heap left in a file is taken back as it is: no comparisons
+   void test_pqueue_reopenAlreadyHeap()
+   {  // setup
+      TempFile file;
+      {
+         custom::priority_queue<int, custom::mmap_vector<int>> pq(std::less<int>(),
+                                                                 custom::mmap_vector<int>(file.path));
+         for (int i = 0; i < 1000; i++)
+            pq.push((i * 7) % 1000);
+         pq.pop();
+      }
+      int compares = 0;
+      // exercise
+      custom::priority_queue<int, custom::mmap_vector<int>, CountingLess> pq(
+         custom::already_heap, CountingLess(compares), custom::mmap_vector<int>(file.path));
+      // verify
+      assertUnit(compares == 0);
+      assertUnit(pq.size() == 999);
+      assertUnit(pq.top() == 998);
+      pq.pop();
+      assertUnit(pq.top() == 997);
+   }  // teardown
+
+   // a queue moved from is empty, not a crash
+   void test_pqueue_movedFrom()
+   {  // setup
+      custom::priority_queue<int, custom::mmap_vector<int>> pq;
+      for (int i = 0; i < 10; i++)
+         pq.push(i);
+      // exercise
+      custom::priority_queue<int, custom::mmap_vector<int>> moved(std::move(pq));
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.size() == 0);
+      pq.pop();
+      pq.push(3);
+      assertUnit(pq.top() == 3);
+      assertUnit(moved.size() == 10);
+      assertUnit(moved.top() == 9);
+   }  // teardown
+
+   // std::less, counting as it goes
+   struct CountingLess
+   {
+      explicit CountingLess(int & count) : count(&count) { }
+      bool operator()(int lhs, int rhs) const { ++*count; return lhs < rhs; }
+      int * count;
+   };
+};
+
+#endif // DEBUG && POSIX
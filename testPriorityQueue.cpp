@@ -18,6 +18,23 @@
 #include "testPriorityQueue.h"  // for the priority queue unit tests
 #include "testSpy.h"            // for the spy unit tests
 #include "testVector.h"         // for the vector unit tests
+#include "testTimerWheel.h"     // for the timer wheel unit tests
+#include "testRadixHeap.h"      // for the radix heap unit tests
+#include "testBucketQueue.h"    // for the bucket queue unit tests
+#include "testStablePriorityQueue.h" // for the stable priority queue unit tests
+#include "testMinMaxHeap.h"     // for the min-max heap unit tests
+#include "testBoundedPriorityQueue.h" // for the bounded priority queue unit tests
+#include "testDaryHeap.h"       // for the d-ary heap unit tests
+#include "testSplitPriorityQueue.h" // for the split priority queue unit tests
+#include "testHeapLayout.h"     // for the heap layout unit tests
+#include "testHeapTrace.h"      // for the heap trace unit tests
+#include "testContainerStats.h" // for the stats policy unit tests
+#include "testConcurrentSpy.h"  // for the concurrent spy unit tests
+#include "testTrackingAllocator.h" // for the tracking allocator unit tests
+#include "testMmapVector.h"     // for the file-backed vector unit tests
+#include "testExternalPriorityQueue.h" // for the external priority queue unit tests
+#include "testSerialize.h"      // for the serialize unit tests
+#include "testHugePageAllocator.h" // for the huge page allocator unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -31,6 +48,27 @@ int main()
    TestSpy().run();
    TestVector().run();
    TestPQueue().run();
+   TestTimerWheel().run();
+   TestRadixHeap().run();
+   TestBucketQueue().run();
+   TestStablePQueue().run();
+   TestMinMaxHeap().run();
+   TestBoundedPQueue().run();
+   TestDaryHeap().run();
+   TestSplitPQueue().run();
+   TestHeapLayout().run();
+   TestHeapTrace().run();
+   TestContainerStats().run();
+   TestConcurrentSpy().run();
+   TestTrackingAllocator().run();
+#if defined(__unix__) || defined(__APPLE__)
+   TestMmapVector().run();
+   TestExternalPQueue().run();
+#endif
+   TestSerialize().run();
+#if defined(__unix__) || defined(__APPLE__)
+   TestHugePageAllocator().run();
+#endif
 #endif // DEBUG
    
    return 0;
@@ -43,6 +43,7 @@ public:
        test_constructMoveInit_one();
        test_constructMoveInit_standard();
        test_constructMoveInit_twoLevels();
+       test_constructMoveInit_adoptedInPlace();
        test_destructor_empty();
        test_destructor_standard();
        test_destructor_partiallyFilled();
@@ -68,12 +69,17 @@ public:
        test_pushMove_levelOne();
        test_pushMove_levelTwo();
        test_pushMove_levelThree();
+      test_push_oddSize();
 
       // Remove
       test_pop_empty();
       test_pop_one();
       test_pop_two();
       test_pop_standard();
+      test_pop_emptyReserved();
+      test_pop_shrinksAfterBurst();
+      test_pop_shrinkHysteresis();
+      test_pop_shrinkOff();
 
       // Status
       test_size_empty();
@@ -91,6 +97,9 @@ public:
       test_heapify_nothing();
       test_heapify_oneLevel();
       test_heapify_twoLevels();
+      test_percolateDown_branchlessTwoLevels();
+      test_percolateDown_branchlessLeftOnly();
+      test_heapify_branchless();
 
       report("PQueue");
    }
@@ -378,7 +387,7 @@ public:
       // verify
       assertUnit(Spy::numCopy() == 3);     // copy [10][9][8]
       assertUnit(Spy::numAlloc() == 3);    // allocate [10][9][8]
-      assertUnit(Spy::numLessthan() == 3); // [9<10] [9<8][9<10]
+      assertUnit(Spy::numLessthan() == 2); // [9<8][10<9]
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
@@ -471,7 +480,7 @@ public:
       assertUnit(Spy::numCopy() == 0);
       assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numLessthan() == 2); // [10<8][9>10]]
-      assertUnit(Spy::numSwap() == 1);     // [9,10]
+      assertUnit(Spy::numSwap() == 0);     // relocated into the hole, not swapped
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numDefault() == 0);
@@ -515,7 +524,7 @@ public:
       //          5      6
       //         4 2    1 3
       assertUnit(Spy::numLessthan() == 8); // compare[6<7][3<7][4<5][2<5][5<7][1<7][6<3][1<6]
-      assertUnit(Spy::numSwap() == 4);     // swap(3,7)(2,5)(1,7)(1,6)
+      assertUnit(Spy::numSwap() == 0);     // relocated into the hole, not swapped
       assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numDestructor() == 0);
@@ -543,6 +552,39 @@ public:
       teardownStandardFixture(pq);
    }
 
+   // a decoded buffer, adopted then moved in, is heapified where it lies
+   void test_constructMoveInit_adoptedInPlace()
+   {  // setup
+      //   p = [1, 2, 3]
+      std::allocator<Spy> alloc;
+      Spy * p = alloc.allocate(3);
+      new (p + 0) Spy(1);
+      new (p + 1) Spy(2);
+      new (p + 2) Spy(3);
+      custom::vector <Spy> v;
+      v.adopt(p, 3, 3);
+      Spy::reset();
+      // exercise
+      custom::priority_queue <Spy> pq(std::less<Spy>(), std::move(v));
+      // verify
+      //  +---+---+---+
+      //  | 3 | 2 | 1 |
+      //  +---+---+---+
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(pq.container.data == p);
+      assertUnit(pq.container.size() == 3);
+      if (pq.container.size() == 3)
+      {
+         assertUnit(pq.container[0] == Spy(3));
+         assertUnit(pq.container[1] == Spy(2));
+         assertUnit(pq.container[2] == Spy(1));
+      }
+      // teardown
+      teardownStandardFixture(pq);
+   }
+
    /***************************************
     * SIZE EMPTY
     ***************************************/
@@ -874,7 +916,7 @@ public:
       bool returnValue = pq.percolateDown(3 /*indexHeap*/);
       // Verify
       assertUnit(Spy::numLessthan() == 2);    // compare [9<5][9<7]
-      assertUnit(Spy::numSwap() == 1);        // swap of [7,9]
+      assertUnit(Spy::numSwap() == 0);        // relocated into the hole, not swapped
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
       assertUnit(Spy::numDestructor() == 0);
@@ -918,7 +960,7 @@ public:
       bool returnValue = pq.percolateDown(1 /*indexHeap*/);
       // Verify
       assertUnit(Spy::numLessthan() == 4);    // compare [8<10][5<10] [7<9][9<5]
-      assertUnit(Spy::numSwap() == 2);        // swap of [10,5] [5,9]
+      assertUnit(Spy::numSwap() == 0);        // relocated into the hole, not swapped
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
       assertUnit(Spy::numDestructor() == 0);
@@ -1103,7 +1145,7 @@ public:
       //             5
       //          4      3
       assertUnit(Spy::numLessthan() == 2); // compare[4 < 5][3 < 5]
-      assertUnit(Spy::numSwap() == 1);     // swap(3, 5)
+      assertUnit(Spy::numSwap() == 0);     // relocated into the hole, not swapped
       assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numDestructor() == 0);
@@ -1149,7 +1191,7 @@ public:
       //          5      6
       //         4 2    1 3
       assertUnit(Spy::numLessthan() == 8); // compare[6<7][3<7][4<5][2<5][5<7][1<7][6<3][1<6]
-      assertUnit(Spy::numSwap() == 4);     // swap(3,7)(2,5)(1,7)(1,6)
+      assertUnit(Spy::numSwap() == 0);     // relocated into the hole, not swapped
       assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numDestructor() == 0);
@@ -1175,6 +1217,91 @@ public:
       pq.container.clear();
    }
 
+   // an int heap takes the branchless path and ends up the same
+   void test_percolateDown_branchlessTwoLevels()
+   {  // setup
+      //               5
+      //         8            10
+      //      4     3      7     9
+      custom::priority_queue <int> pq;
+      pq.container = { 5, 8, 10, 4, 3, 7, 9 };
+      // Exercise
+      bool returnValue = pq.percolateDown(1 /*indexHeap*/);
+      // Verify
+      //               10
+      //         8            9
+      //      4     3      7     5
+      assertUnit(returnValue == true);
+      assertUnit(pq.container.size() == 7);
+      if (pq.container.size() == 7)
+      {
+         assertUnit(pq.container[1 - 1] == 10);
+         assertUnit(pq.container[2 - 1] == 8);
+         assertUnit(pq.container[3 - 1] == 9);
+         assertUnit(pq.container[4 - 1] == 4);
+         assertUnit(pq.container[5 - 1] == 3);
+         assertUnit(pq.container[6 - 1] == 7);
+         assertUnit(pq.container[7 - 1] == 5);
+      }
+      // Teardown
+      pq.container.clear();
+   }
+
+   // the last parent has a left child only
+   void test_percolateDown_branchlessLeftOnly()
+   {  // setup
+      //               9
+      //         2            8
+      //      6
+      custom::priority_queue <int> pq;
+      pq.container = { 9, 2, 8, 6 };
+      // Exercise
+      bool changedLeftOnly = pq.percolateDown(2 /*indexHeap*/);
+      bool changedLeaf = pq.percolateDown(4 /*indexHeap*/);
+      // Verify
+      //               9
+      //         6            8
+      //      2
+      assertUnit(changedLeftOnly == true);
+      assertUnit(changedLeaf == false);
+      assertUnit(pq.container.size() == 4);
+      if (pq.container.size() == 4)
+      {
+         assertUnit(pq.container[1 - 1] == 9);
+         assertUnit(pq.container[2 - 1] == 6);
+         assertUnit(pq.container[3 - 1] == 8);
+         assertUnit(pq.container[4 - 1] == 2);
+      }
+      // Teardown
+      pq.container.clear();
+   }
+
+   // heapify an int heap the same as the Spy heap above
+   void test_heapify_branchless()
+   {  // setup
+      custom::priority_queue <int> pq;
+      pq.container = { 1, 2, 3, 4, 5, 6, 7 };
+      // Exercise
+      pq.heapify();
+      // Verify
+      //             7
+      //          5      6
+      //         4 2    1 3
+      assertUnit(pq.container.size() == 7);
+      if (pq.container.size() == 7)
+      {
+         assertUnit(pq.container[1 - 1] == 7);
+         assertUnit(pq.container[2 - 1] == 5);
+         assertUnit(pq.container[3 - 1] == 6);
+         assertUnit(pq.container[4 - 1] == 4);
+         assertUnit(pq.container[5 - 1] == 2);
+         assertUnit(pq.container[6 - 1] == 1);
+         assertUnit(pq.container[7 - 1] == 3);
+      }
+      // Teardown
+      pq.container.clear();
+   }
+
    /***************************************
     * TOP
     ***************************************/
@@ -1388,7 +1515,7 @@ public:
       // exercise
       pq.pop();
       // verify
-      assertUnit(Spy::numSwap() == 3);         // swap [10,5] [9,5] [7,5]
+      assertUnit(Spy::numSwap() == 1);         // top with last; the sift relocates
       assertUnit(Spy::numDestructor() == 1);   // destroy [10]
       assertUnit(Spy::numDelete() == 1);       // delete [10]
       assertUnit(Spy::numLessthan() == 3);     // compare [8<9][9<5] [7<5]
@@ -1421,7 +1548,77 @@ public:
       teardownStandardFixture(pq);
    }
 
+   // pop of nothing, with room reserved, stays empty
+   void test_pop_emptyReserved()
+   {  // setup
+      custom::priority_queue <Spy> pq;
+      pq.container.reserve(4);
+      Spy::reset();
+      // exercise
+      pq.pop();
+      // verify
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(pq.container.size() == 0);
+      assertUnit(pq.container.capacity() == 4);
+   }  // teardown
 
+   // after a burst, popping under a quarter full gives the memory back
+   void test_pop_shrinksAfterBurst()
+   {  // setup
+      custom::priority_queue <int> pq;
+      pq.set_shrink_policy(4, 64);
+      for (int i = 0; i < 1024; i++)
+         pq.push(i);
+      // exercise
+      while (pq.size() > 10)
+         pq.pop();
+      // verify
+      assertUnit(pq.container.capacity() < 64);
+      assertUnit(pq.container.capacity() >= pq.size());
+      bool ordered = true;
+      for (int expect = 9; expect >= 0; expect--)
+      {
+         ordered = ordered && pq.top() == expect;
+         pq.pop();
+      }
+      assertUnit(ordered);
+   }  // teardown
+
+   // a shrink leaves twice the size, so it does not happen again right away
+   void test_pop_shrinkHysteresis()
+   {  // setup
+      custom::priority_queue <int> pq;
+      pq.set_shrink_policy(4, 64);
+      for (int i = 0; i < 256; i++)
+         pq.push(i);
+      while (pq.size() >= 64)
+         pq.pop();
+      // exercise
+      size_t shrunk = pq.container.capacity();
+      pq.pop();
+      pq.pop();
+      pq.push(1000);
+      pq.push(1001);
+      // verify
+      assertUnit(shrunk == 126);
+      assertUnit(pq.container.capacity() == 126);
+      assertUnit(pq.top() == 1001);
+   }  // teardown
+
+   // a divisor of zero keeps the capacity
+   void test_pop_shrinkOff()
+   {  // setup
+      custom::priority_queue <int> pq;
+      pq.set_shrink_policy(0, 0);
+      for (int i = 0; i < 1024; i++)
+         pq.push(i);
+      // exercise
+      while (!pq.empty())
+         pq.pop();
+      // verify
+      assertUnit(pq.container.capacity() == 1024);
+   }  // teardown
 
    /***************************************
     * PUSH
@@ -1526,7 +1723,7 @@ public:
       assertUnit(Spy::numCopy() == 1);       // copy-create [6]
       assertUnit(Spy::numAlloc() == 1);      // allocate    [6]
       assertUnit(Spy::numLessthan() == 3);   // [4<6] [6<3][6<8]
-      assertUnit(Spy::numSwap() == 1);       // swap [4,6]
+      assertUnit(Spy::numSwap() == 0);       // relocated into the hole, not swapped
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numDelete() == 0);
@@ -1578,7 +1775,7 @@ public:
       assertUnit(Spy::numCopy() == 1);      // copy-create [9]
       assertUnit(Spy::numAlloc() == 1);     // allocate    [9]
       assertUnit(Spy::numLessthan() == 6);  // compare [4<9] [9<3][9<8] [8<4] [9<9][9<10]
-      assertUnit(Spy::numSwap() == 2);      // swap [4,9] [8,9]
+      assertUnit(Spy::numSwap() == 0);      // relocated into the hole, not swapped
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numDelete() == 0);
@@ -1630,7 +1827,7 @@ public:
       assertUnit(Spy::numCopy() == 1);      // copy-create [11]
       assertUnit(Spy::numAlloc() == 1);     // allocate    [11]
       assertUnit(Spy::numLessthan() == 8);  // compare [4<11] [11<3][11<8] [8<4] [11<9][11<10] [8<3] [10<8]
-      assertUnit(Spy::numSwap() == 3);      // swap [4,11] [8,11] [10,11]
+      assertUnit(Spy::numSwap() == 0);      // relocated into the hole, not swapped
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numDelete() == 0);
@@ -1760,7 +1957,7 @@ public:
       pq.push(std::move(s));
       // verify
       assertUnit(Spy::numLessthan() == 3);    // [4<6] [6<3][6<8]
-      assertUnit(Spy::numSwap() == 1);        // swap [4,6]
+      assertUnit(Spy::numSwap() == 0);        // relocated into the hole, not swapped
       assertUnit(Spy::numCopyMove() == 1);    // move [6]
       assertUnit(Spy::numAssignMove() == 0);
       assertUnit(Spy::numCopy() == 0);
@@ -1812,7 +2009,7 @@ public:
       pq.push(std::move(s));
       // verify
       assertUnit(Spy::numLessthan() == 6);  // compare [4<9] [9<3][9<8] [8<4] [9<9][9<10]
-      assertUnit(Spy::numSwap() == 2);      // swap [4,9] [8,9]
+      assertUnit(Spy::numSwap() == 0);      // relocated into the hole, not swapped
       assertUnit(Spy::numCopyMove() == 1);  // copy-move [9]
       assertUnit(Spy::numCopy() == 0);
       assertUnit(Spy::numAlloc() == 0);
@@ -1865,7 +2062,7 @@ public:
       // verify
       assertUnit(Spy::numCopyMove() == 1);  // copy-move [11]
       assertUnit(Spy::numLessthan() == 8);  // compare [4<11] [11<3][11<8] [8<4] [11<9][11<10] [8<3] [10<8]
-      assertUnit(Spy::numSwap() == 3);      // swap [4,11] [8,11] [10,11]
+      assertUnit(Spy::numSwap() == 0);      // relocated into the hole, not swapped
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numCopy() == 0);
       assertUnit(Spy::numAlloc() == 0);
@@ -1898,6 +2095,21 @@ public:
       teardownStandardFixture(pq);
    }
 
+   // a push that makes the size odd still sifts from the new element's parent
+   void test_push_oddSize()
+   {  // setup
+      custom::priority_queue <int> pq;
+      pq.push(1);
+      pq.push(2);
+      // exercise
+      pq.push(3);
+      // verify
+      assertUnit(pq.top() == 3);
+      assertUnit(pq.container.size() == 3);
+      if (pq.container.size() == 3)
+         assertUnit(pq.container[0] == 3);
+   }  // teardown
+
    /***************************************************
     * SETUP STANDARD FIXTURE
     *                 10
@@ -0,0 +1,267 @@
+/***********************************************************************
+ * Header:
+ *    TEST RADIX HEAP
+ * Summary:
+ *    Unit tests for the radix heap
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "radix_heap.h"
+#include "unitTest.h"
+
+#include <queue>
+#include <vector>
+#include <functional>
+
+class TestRadixHeap : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_range();
+
+      // Access
+      test_top_empty();
+      test_top_standard();
+
+      // Insert
+      test_push_equalToLast();
+      test_push_bucket();
+
+      // Remove
+      test_pop_empty();
+      test_pop_standard();
+      test_pop_redistribute();
+      test_pop_monotone();
+      test_pop_payload();
+
+      report("RadixHeap");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing stored
+   void test_construct_default()
+   {  // exercise
+      custom::radix_heap <uint32_t> rh;
+      // verify
+      assertUnit(rh.empty());
+      assertUnit(rh.size() == 0);
+      assertUnit(rh.buckets.size() == 65);
+      assertUnit(rh.occupied == 0);
+      assertUnit(rh.lastKey == 0);
+   }  // teardown
+
+   // range constructor
+   void test_construct_range()
+   {  // setup
+      uint32_t keys[] = { 7, 2, 9 };
+      // exercise
+      custom::radix_heap <uint32_t> rh(keys, keys + 3);
+      // verify
+      assertUnit(rh.size() == 3);
+      assertUnit(rh.top() == 2);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty heap throws
+   void test_top_empty()
+   {  // setup
+      custom::radix_heap <uint32_t> rh;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         rh.top();
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // top redistributes lazily and returns the smallest key
+   void test_top_standard()
+   {  // setup
+      custom::radix_heap <uint32_t> rh;
+      setupStandardFixture(rh);
+      // exercise
+      uint32_t t = rh.top();
+      // verify
+      assertUnit(t == 3);
+      assertUnit(rh.lastKey == 3);
+      assertUnit(rh.buckets[0].size() == 1);
+      assertUnit(rh.size() == 7);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // a key equal to the last key goes straight to bucket 0
+   void test_push_equalToLast()
+   {  // setup
+      custom::radix_heap <uint32_t> rh;
+      // exercise
+      rh.push(0);
+      // verify
+      assertUnit(rh.buckets[0].size() == 1);
+      assertUnit(rh.occupied == 0);
+   }  // teardown
+
+   // other keys go to the bucket of their highest differing bit
+   void test_push_bucket()
+   {  // setup
+      custom::radix_heap <uint32_t> rh;
+      // exercise
+      rh.push(1);     // bit 0
+      rh.push(5);     // bit 2
+      rh.push(6);     // bit 2
+      rh.push(1000);  // bit 9
+      // verify
+      assertUnit(rh.buckets[1].size() == 1);
+      assertUnit(rh.buckets[3].size() == 2);
+      assertUnit(rh.buckets[10].size() == 1);
+      assertUnit(rh.occupied == ((1 << 0) | (1 << 2) | (1 << 9)));
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop an empty heap does nothing
+   void test_pop_empty()
+   {  // setup
+      custom::radix_heap <uint32_t> rh;
+      // exercise
+      rh.pop();
+      // verify
+      assertUnit(rh.empty());
+   }  // teardown
+
+   // pop everything from the standard fixture in order
+   void test_pop_standard()
+   {  // setup
+      custom::radix_heap <uint32_t> rh;
+      setupStandardFixture(rh);
+      uint32_t expected[] = { 3, 4, 5, 7, 8, 9, 10 };
+      // exercise and verify
+      for (int i = 0; i < 7; i++)
+      {
+         assertUnit(rh.top() == expected[i]);
+         rh.pop();
+      }
+      assertUnit(rh.empty());
+      assertUnit(rh.occupied == 0);
+   }  // teardown
+
+   // redistributing a bucket moves everything to lower buckets
+   void test_pop_redistribute()
+   {  // setup
+      custom::radix_heap <uint32_t> rh;
+      rh.push(1024);
+      rh.push(1030);
+      rh.push(1500);
+      // exercise
+      rh.pop();
+      // verify
+      assertUnit(rh.lastKey == 1024);
+      assertUnit(rh.buckets[11].empty());
+      assertUnit(rh.buckets[0].empty());
+      assertUnit(rh.buckets[3].size() == 1);   // 1030 ^ 1024 = 6
+      assertUnit(rh.buckets[9].size() == 1);   // 1500 ^ 1024 = 476
+      assertUnit(rh.size() == 2);
+   }  // teardown
+
+   // interleaved monotone pushes and pops agree with std::priority_queue
+   void test_pop_monotone()
+   {  // setup
+      custom::radix_heap <uint64_t> rh;
+      std::priority_queue <uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> pq;
+      uint64_t seed = 2024;
+      uint64_t now = 0;
+      bool same = true;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         if ((seed >> 60) < 9 || pq.empty())
+         {
+            uint64_t k = now + ((seed >> 24) & 0xffff);
+            rh.push(k);
+            pq.push(k);
+         }
+         else
+         {
+            same = same && rh.top() == pq.top();
+            now = pq.top();
+            rh.pop();
+            pq.pop();
+         }
+      }
+      while (!pq.empty())
+      {
+         same = same && rh.top() == pq.top();
+         rh.pop();
+         pq.pop();
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(rh.empty());
+   }  // teardown
+
+   // a key extractor lets the heap carry a payload
+   void test_pop_payload()
+   {  // setup
+      struct Edge
+      {
+         uint32_t distance;
+         int      vertex;
+      };
+      struct EdgeKey
+      {
+         uint64_t operator () (const Edge & e) const { return e.distance; }
+      };
+      custom::radix_heap <Edge, EdgeKey> rh;
+      rh.push(Edge{ 30, 1 });
+      rh.push(Edge{ 10, 2 });
+      rh.push(Edge{ 20, 3 });
+      // exercise
+      int first = rh.top().vertex;
+      rh.pop();
+      int second = rh.top().vertex;
+      // verify
+      assertUnit(first == 2);
+      assertUnit(second == 3);
+      assertUnit(rh.size() == 2);
+   }  // teardown
+
+   /****************************************************************
+    * SETUP STANDARD FIXTURE
+    *   { 10, 8, 9, 4, 3, 7, 5 }
+    ****************************************************************/
+   void setupStandardFixture(custom::radix_heap <uint32_t> & rh)
+   {
+      uint32_t keys[] = { 10, 8, 9, 4, 3, 7, 5 };
+      for (uint32_t k : keys)
+         rh.push(k);
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,350 @@
+/***********************************************************************
+ * Header:
+ *    TEST SERIALIZE
+ * Summary:
+ *    Unit tests for saving and loading vectors and priority queues
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "serialize.h"
+#include "priority_queue.h"
+#include "vector.h"
+#include "unitTest.h"
+
+#include <cstdio>       // for std::tmpfile
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+class TestSerialize : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Vector
+      test_vector_roundTrip();
+      test_vector_empty();
+      test_vector_layout();
+      test_vector_replaces();
+#if defined(__unix__) || defined(__APPLE__)
+      test_vector_fd();
+#endif
+
+      // Errors
+      test_error_checksum();
+      test_error_elementSize();
+      test_error_truncated();
+      test_error_notSerialized();
+      test_error_hugeCount();
+      test_error_countOverflows();
+#if defined(__unix__) || defined(__APPLE__)
+      test_error_hugeCountPipe();
+#endif
+
+      // Priority queue
+      test_pqueue_noHeapify();
+      test_pqueue_popsInOrder();
+
+      report("Serialize");
+   }
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // what goes out comes back
+   void test_vector_roundTrip()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(i * 3);
+      std::stringstream stream;
+      custom::vector<int> loaded;
+      // exercise
+      custom::serialize(stream, v);
+      custom::deserialize(stream, loaded);
+      // verify
+      assertUnit(loaded.size() == 1000);
+      bool same = true;
+      for (int i = 0; i < 1000; i++)
+         same = same && loaded[i] == i * 3;
+      assertUnit(same);
+   }  // teardown
+
+   // nothing is a header and no elements
+   void test_vector_empty()
+   {  // setup
+      custom::vector<double> v;
+      std::stringstream stream;
+      custom::vector<double> loaded;
+      loaded.push_back(1.0);
+      // exercise
+      custom::serialize(stream, v);
+      custom::deserialize(stream, loaded);
+      // verify
+      assertUnit(stream.str().size() == 32);
+      assertUnit(loaded.empty());
+   }  // teardown
+
+   // the header, then the bytes of the elements as they are
+   void test_vector_layout()
+   {  // setup
+      custom::vector<uint32_t> v;
+      v.push_back(0x01020304);
+      v.push_back(0x05060708);
+      std::ostringstream stream;
+      // exercise
+      custom::serialize(stream, v);
+      // verify
+      std::string bytes = stream.str();
+      assertUnit(bytes.size() == 32 + 8);
+      assertUnit(bytes.compare(0, 4, "PQSN") == 0);
+      uint64_t count = 0;
+      uint32_t first = 0;
+      std::memcpy(&count, bytes.data() + 16, 8);
+      std::memcpy(&first, bytes.data() + 32, 4);
+      assertUnit(count == 2);
+      assertUnit(first == 0x01020304);
+   }  // teardown
+
+   // loading replaces, it does not append
+   void test_vector_replaces()
+   {  // setup
+      custom::vector<int> v{ 7, 8 };
+      std::stringstream stream;
+      custom::serialize(stream, v);
+      custom::vector<int> loaded{ 1, 2, 3, 4, 5 };
+      // exercise
+      custom::deserialize(stream, loaded);
+      // verify
+      assertUnit(loaded.size() == 2);
+      assertUnit(loaded[0] == 7);
+      assertUnit(loaded[1] == 8);
+   }  // teardown
+
+#if defined(__unix__) || defined(__APPLE__)
+   // a file descriptor works as a stream does
+   void test_vector_fd()
+   {  // setup
+      std::FILE * file = std::tmpfile();
+      int fd = fileno(file);
+      custom::vector<uint64_t> v;
+      for (uint64_t i = 0; i < 100000; i++)
+         v.push_back(i * i);
+      custom::vector<uint64_t> loaded;
+      // exercise
+      custom::serialize(fd, v);
+      lseek(fd, 0, SEEK_SET);
+      custom::deserialize(fd, loaded);
+      // verify
+      assertUnit(loaded.size() == 100000);
+      assertUnit(loaded[99999] == 99999ULL * 99999ULL);
+      // teardown
+      std::fclose(file);
+   }
+#endif
+
+   /***************************************
+    * ERRORS
+    ***************************************/
+
+   // a flipped bit is caught and nothing is loaded
+   void test_error_checksum()
+   {  // setup
+      custom::vector<int> v{ 1, 2, 3 };
+      std::ostringstream out;
+      custom::serialize(out, v);
+      std::string bytes = out.str();
+      bytes[32 + 5] ^= 0x10;
+      std::istringstream in(bytes);
+      custom::vector<int> loaded{ 9 };
+      // exercise
+      std::string message = loadError(in, loaded);
+      // verify
+      assertUnit(message == "deserialize: checksum mismatch");
+      assertUnit(loaded.empty());
+   }  // teardown
+
+   // ints are not read as doubles
+   void test_error_elementSize()
+   {  // setup
+      custom::vector<int> v{ 1, 2, 3 };
+      std::stringstream stream;
+      custom::serialize(stream, v);
+      custom::vector<double> loaded;
+      // exercise
+      std::string message = loadError(stream, loaded);
+      // verify
+      assertUnit(message == "deserialize: elements of another size");
+   }  // teardown
+
+   // fewer elements than the header promised
+   void test_error_truncated()
+   {  // setup
+      custom::vector<int> v{ 1, 2, 3 };
+      std::ostringstream out;
+      custom::serialize(out, v);
+      std::istringstream in(out.str().substr(0, 32 + 8));
+      custom::vector<int> loaded;
+      // exercise
+      std::string message = loadError(in, loaded);
+      // verify
+      assertUnit(message == "deserialize: truncated");
+      assertUnit(loaded.empty());
+   }  // teardown
+
+   // anything else is refused at the header
+   void test_error_notSerialized()
+   {  // setup
+      std::istringstream in(std::string(64, 'x'));
+      custom::vector<int> loaded{ 1, 2 };
+      // exercise
+      std::string message = loadError(in, loaded);
+      // verify
+      assertUnit(message == "deserialize: not a serialized container");
+      assertUnit(loaded.empty());
+   }  // teardown
+
+   // a corrupt count is not taken at its word: no giant allocation
+   void test_error_hugeCount()
+   {  // setup
+      custom::vector<uint64_t> v{ 1, 2, 3 };
+      std::ostringstream out;
+      custom::serialize(out, v);
+      std::string bytes = out.str();
+      uint64_t count = (uint64_t)1 << 40;
+      std::memcpy(&bytes[16], &count, 8);
+      std::istringstream in(bytes);
+      custom::vector<uint64_t> loaded;
+      // exercise
+      std::string message = loadError(in, loaded);
+      // verify
+      assertUnit(message == "deserialize: truncated");
+      assertUnit(loaded.empty());
+      assertUnit(loaded.capacity() <= custom::serializer::CHUNK_BYTES / sizeof(uint64_t));
+   }  // teardown
+
+#if defined(__unix__) || defined(__APPLE__)
+   // a pipe cannot say how much is left, so memory follows what arrives
+   void test_error_hugeCountPipe()
+   {  // setup
+      custom::vector<uint64_t> v{ 1, 2, 3 };
+      std::ostringstream out;
+      custom::serialize(out, v);
+      std::string bytes = out.str();
+      uint64_t count = (uint64_t)1 << 40;
+      std::memcpy(&bytes[16], &count, 8);
+      int ends[2];
+      bool piped = pipe(ends) == 0 &&
+                   write(ends[1], bytes.data(), bytes.size()) == (ssize_t)bytes.size();
+      if (piped)
+         close(ends[1]);
+      custom::vector<uint64_t> loaded;
+      // exercise
+      std::string message = piped ? loadError(ends[0], loaded) : "";
+      // verify
+      assertUnit(piped);
+      assertUnit(message == "deserialize: truncated");
+      assertUnit(loaded.empty());
+      assertUnit(loaded.capacity() <= custom::serializer::CHUNK_BYTES / sizeof(uint64_t));
+      // teardown
+      if (piped)
+         close(ends[0]);
+   }
+#endif
+
+   // nor one whose bytes would not fit in a size_t
+   void test_error_countOverflows()
+   {  // setup
+      custom::vector<uint64_t> v{ 1 };
+      std::ostringstream out;
+      custom::serialize(out, v);
+      std::string bytes = out.str();
+      uint64_t count = ~(uint64_t)0 / 4;
+      std::memcpy(&bytes[16], &count, 8);
+      std::istringstream in(bytes);
+      custom::vector<uint64_t> loaded;
+      // exercise
+      std::string message = loadError(in, loaded);
+      // verify
+      assertUnit(message == "deserialize: truncated");
+      assertUnit(loaded.empty());
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // the heap comes back as it was, with no comparisons
+   void test_pqueue_noHeapify()
+   {  // setup
+      int compares = 0;
+      custom::priority_queue<int, custom::vector<int>, CountingLess> pq{ CountingLess(compares) };
+      for (int i = 0; i < 1000; i++)
+         pq.push((i * 7) % 1000);
+      std::stringstream stream;
+      custom::serialize(stream, pq);
+      custom::priority_queue<int, custom::vector<int>, CountingLess> loaded{ CountingLess(compares) };
+      compares = 0;
+      // exercise
+      custom::deserialize(stream, loaded);
+      // verify
+      assertUnit(compares == 0);
+      assertUnit(loaded.size() == 1000);
+      assertUnit(loaded.top() == 999);
+   }  // teardown
+
+   // and pops as the original would
+   void test_pqueue_popsInOrder()
+   {  // setup
+      custom::priority_queue<int> pq;
+      for (int i = 0; i < 500; i++)
+         pq.push((i * 11) % 500);
+      pq.pop();
+      std::stringstream stream;
+      custom::serialize(stream, pq);
+      custom::priority_queue<int> loaded;
+      // exercise
+      custom::deserialize(stream, loaded);
+      // verify
+      bool ordered = loaded.size() == 499;
+      for (int expect = 498; ordered && expect >= 0; expect--)
+      {
+         ordered = loaded.top() == expect;
+         loaded.pop();
+      }
+      assertUnit(ordered);
+   }  // teardown
+
+   // std::less, counting as it goes
+   struct CountingLess
+   {
+      explicit CountingLess(int & count) : count(&count) { }
+      bool operator()(int lhs, int rhs) const { ++*count; return lhs < rhs; }
+      int * count;
+   };
+
+   // the message deserialize threw, or "" if it did not
+   template <class In, class V>
+   static std::string loadError(In & in, V & v)
+   {
+      try
+      {
+         custom::deserialize(in, v);
+      }
+      catch (const std::invalid_argument & e)
+      {
+         return e.what();
+      }
+      return "";
+   }
+};
+
+#endif // DEBUG
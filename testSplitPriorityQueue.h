@@ -0,0 +1,335 @@
+/***********************************************************************
+ * Header:
+ *    TEST SPLIT PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the key/payload split priority queue
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "split_priority_queue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+/***************************************
+ * THROWING KEY
+ * An int key whose copy or move throws once
+ * copiesLeft runs out
+ ***************************************/
+struct ThrowingKey
+{
+   ThrowingKey(int value = 0) : value(value) { }
+   ThrowingKey(const ThrowingKey & rhs) : value(rhs.value) { count(); }
+   ThrowingKey & operator = (const ThrowingKey & rhs) { value = rhs.value; return *this; }
+   bool operator < (const ThrowingKey & rhs) const { return value < rhs.value; }
+   int value;
+   static inline int copiesLeft = -1;   // negative: never throw
+private:
+   static void count()
+   {
+      if (copiesLeft == 0)
+         throw std::runtime_error("ThrowingKey: no copies left");
+      if (copiesLeft > 0)
+         copiesLeft--;
+   }
+};
+
+class TestSplitPQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Access
+      test_top_empty();
+      test_top_standard();
+      test_top_moveOut();
+
+      // Insert
+      test_push_heapOrder();
+      test_push_spyNoCopy();
+      test_push_throwsNewSlot();
+      test_push_throwsRecycledSlot();
+
+      // Remove
+      test_pop_empty();
+      test_pop_standard();
+      test_pop_recyclesSlots();
+      test_pop_random();
+
+      report("SplitPQueue");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing stored
+   void test_construct_default()
+   {  // exercise
+      custom::split_priority_queue <int, std::string> pq;
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.size() == 0);
+      assertUnit(pq.heap.empty());
+      assertUnit(pq.slab.empty());
+      assertUnit(pq.freeSlots.empty());
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // both accessors of an empty queue throw
+   void test_top_empty()
+   {  // setup
+      custom::split_priority_queue <int, std::string> pq;
+      int numThrown = 0;
+      // exercise
+      try { pq.top_key(); } catch (const std::out_of_range &) { numThrown++; }
+      try { pq.top(); }     catch (const std::out_of_range &) { numThrown++; }
+      // verify
+      assertUnit(numThrown == 2);
+   }  // teardown
+
+   // the largest key and the payload pushed with it
+   void test_top_standard()
+   {  // setup
+      custom::split_priority_queue <int, std::string> pq;
+      // exercise
+      setupStandardFixture(pq);
+      // verify
+      assertUnit(pq.top_key() == 10);
+      assertUnit(pq.top() == "ten");
+      assertUnit(pq.size() == 7);
+   }  // teardown
+
+   // the top payload can be moved out before the pop
+   void test_top_moveOut()
+   {  // setup
+      custom::split_priority_queue <int, std::string> pq;
+      setupStandardFixture(pq);
+      // exercise
+      std::string s = std::move(pq.top());
+      pq.pop();
+      // verify
+      assertUnit(s == "ten");
+      assertUnit(pq.top() == "nine");
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // the heap holds only keys and slots, in heap order
+   void test_push_heapOrder()
+   {  // setup
+      custom::split_priority_queue <int, std::string> pq;
+      // exercise
+      setupStandardFixture(pq);
+      // verify
+      assertUnit(pq.heap.size() == 7);
+      assertUnit(pq.slab.size() == 7);
+      assertUnit(isHeap(pq));
+      assertUnit(pq.slab[pq.heap[0].slot] == "ten");
+   }  // teardown
+
+   // sifting never copies or moves a payload
+   void test_push_spyNoCopy()
+   {  // setup
+      custom::split_priority_queue <int, Spy> pq;
+      pq.reserve(8);
+      Spy::reset();
+      // exercise
+      for (int i = 1; i <= 8; i++)
+         pq.push(i, Spy(i));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopyMove() == 8);     // each payload moved once, into its slot
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(pq.top() == Spy(8));
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop from an empty queue does nothing
+   void test_pop_empty()
+   {  // setup
+      custom::split_priority_queue <int, std::string> pq;
+      // exercise
+      pq.pop();
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.freeSlots.empty());
+   }  // teardown
+
+   // keys come out largest first, each with its payload
+   void test_pop_standard()
+   {  // setup
+      custom::split_priority_queue <int, std::string> pq;
+      setupStandardFixture(pq);
+      int keys[] = { 10, 9, 8, 7, 5, 4, 3 };
+      const char * payloads[] = { "ten", "nine", "eight", "seven", "five", "four", "three" };
+      // exercise and verify
+      for (int i = 0; i < 7; i++)
+      {
+         assertUnit(pq.top_key() == keys[i]);
+         assertUnit(pq.top() == payloads[i]);
+         pq.pop();
+      }
+      assertUnit(pq.empty());
+      assertUnit(pq.freeSlots.size() == 7);
+   }  // teardown
+
+   // a node the heap cannot take gives its new slot back
+   void test_push_throwsNewSlot()
+   {  // setup
+      custom::split_priority_queue <ThrowingKey, std::string> pq;
+      pq.reserve(4);
+      pq.push(ThrowingKey(5), "five");
+      ThrowingKey::copiesLeft = 1;   // into the node, but not into the heap
+      // exercise
+      bool thrown = false;
+      try
+      {
+         pq.push(ThrowingKey(7), "seven");
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      ThrowingKey::copiesLeft = -1;
+      // verify
+      assertUnit(thrown);
+      assertUnit(pq.size() == 1);
+      assertUnit(pq.slab.size() == 1);
+      assertUnit(pq.freeSlots.empty());
+      assertUnit(pq.top() == "five");
+   }  // teardown
+
+   // a recycled slot goes back on the free list, emptied
+   void test_push_throwsRecycledSlot()
+   {  // setup
+      custom::split_priority_queue <ThrowingKey, std::string> pq;
+      pq.reserve(4);
+      pq.push(ThrowingKey(6), "six");    // slot 0, freed by the pop
+      pq.push(ThrowingKey(5), "five");   // slot 1
+      pq.pop();
+      ThrowingKey::copiesLeft = 1;
+      // exercise
+      bool thrown = false;
+      try
+      {
+         pq.push(ThrowingKey(7), "seven");
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      ThrowingKey::copiesLeft = -1;
+      // verify
+      assertUnit(thrown);
+      assertUnit(pq.size() == 1);
+      assertUnit(pq.slab.size() == 2);
+      assertUnit(pq.freeSlots.size() == 1);
+      if (pq.freeSlots.size() == 1)
+         assertUnit(pq.slab[pq.freeSlots[0]].empty());
+      assertUnit(pq.top() == "five");
+   }  // teardown
+
+   // a steady state of push/pop reuses the same slots
+   void test_pop_recyclesSlots()
+   {  // setup
+      custom::split_priority_queue <int, std::string> pq;
+      setupStandardFixture(pq);
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         pq.pop();
+         pq.push(i, "again");
+      }
+      // verify
+      assertUnit(pq.size() == 7);
+      assertUnit(pq.slab.size() == 7);
+      assertUnit(pq.freeSlots.empty());
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   // random pushes and pops agree with std::multimap
+   void test_pop_random()
+   {  // setup
+      custom::split_priority_queue <uint32_t, uint64_t> pq;
+      std::multimap <uint32_t, uint64_t> m;
+      uint64_t seed = 7;
+      bool same = true;
+      // exercise
+      for (uint64_t i = 0; i < 5000; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         if ((seed >> 62) != 0 || m.empty())
+         {
+            uint32_t key = (uint32_t)((seed >> 32) % 100000);   // unique enough to check payloads
+            pq.push(key, (uint64_t)key * 3);
+            m.insert(std::make_pair(key, (uint64_t)key * 3));
+         }
+         else
+         {
+            same = same && pq.top_key() == m.rbegin()->first;
+            same = same && pq.top() == m.rbegin()->second;
+            pq.pop();
+            m.erase(std::prev(m.end()));
+         }
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(pq.size() == m.size());
+      assertUnit(pq.slab.size() == pq.size() + pq.freeSlots.size());
+      assertUnit(isHeap(pq));
+   }  // teardown
+
+   /****************************************************************
+    * IS HEAP
+    * No key beats its parent's.
+    ****************************************************************/
+   template <class Key, class Payload>
+   bool isHeap(const custom::split_priority_queue <Key, Payload> & pq)
+   {
+      for (size_t i = 1; i < pq.heap.size(); i++)
+         if (pq.heap[(i - 1) / 2].key < pq.heap[i].key)
+            return false;
+      return true;
+   }
+
+   /****************************************************************
+    * SETUP STANDARD FIXTURE
+    *   { 10, 8, 9, 4, 3, 7, 5 } with their names as payloads
+    ****************************************************************/
+   void setupStandardFixture(custom::split_priority_queue <int, std::string> & pq)
+   {
+      pq.push(10, "ten");
+      pq.push(8, "eight");
+      pq.push(9, "nine");
+      pq.push(4, "four");
+      pq.push(3, "three");
+      pq.push(7, "seven");
+      pq.push(5, "five");
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,311 @@
+/***********************************************************************
+ * Header:
+ *    TEST STABLE PRIORITY QUEUE
+ * Summary:
+ *    Unit tests for the stable priority queues
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "stable_priority_queue.h"
+#include "unitTest.h"
+
+#include <functional>
+
+class TestStablePQueue : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Stable
+      test_stable_construct();
+      test_stable_topEmpty();
+      test_stable_order();
+      test_stable_fifo();
+      test_stable_fifoGreater();
+
+      // Packed
+      test_packed_construct();
+      test_packed_order();
+      test_packed_fifo();
+      test_packed_signed();
+      test_packed_greater();
+      test_packed_outOfRange();
+      test_packed_renumber();
+      test_packed_full();
+
+      report("StablePQueue");
+   }
+
+   // a job whose priority is only part of it
+   struct Job
+   {
+      int priority;
+      int id;
+   };
+   struct JobLess
+   {
+      bool operator () (const Job & lhs, const Job & rhs) const { return lhs.priority < rhs.priority; }
+   };
+   struct JobGreater
+   {
+      bool operator () (const Job & lhs, const Job & rhs) const { return lhs.priority > rhs.priority; }
+   };
+
+   /***************************************
+    * STABLE PRIORITY QUEUE
+    ***************************************/
+
+   // default constructor, nothing stored
+   void test_stable_construct()
+   {  // exercise
+      custom::stable_priority_queue <int> pq;
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.size() == 0);
+      assertUnit(pq.nextSequence == 0);
+   }  // teardown
+
+   // top of an empty queue throws
+   void test_stable_topEmpty()
+   {  // setup
+      custom::stable_priority_queue <int> pq;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         pq.top();
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // distinct priorities come out largest first
+   void test_stable_order()
+   {  // setup
+      custom::stable_priority_queue <int> pq;
+      int values[] = { 10, 8, 9, 4, 3, 7, 5 };
+      for (int v : values)
+         pq.push(v);
+      int expected[] = { 10, 9, 8, 7, 5, 4, 3 };
+      // exercise and verify
+      for (int i = 0; i < 7; i++)
+      {
+         assertUnit(pq.top() == expected[i]);
+         pq.pop();
+      }
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // equal priorities come out in arrival order
+   void test_stable_fifo()
+   {  // setup
+      custom::stable_priority_queue <Job, JobLess> pq;
+      for (int id = 0; id < 20; id++)
+         pq.push(Job{ id % 3, id });
+      // exercise
+      bool fifo = true;
+      int previousPriority = 3;
+      int previousId = -1;
+      while (!pq.empty())
+      {
+         Job job = pq.top();
+         pq.pop();
+         if (job.priority == previousPriority)
+            fifo = fifo && job.id > previousId;
+         else
+            fifo = fifo && job.priority < previousPriority;
+         previousPriority = job.priority;
+         previousId = job.id;
+      }
+      // verify
+      assertUnit(fifo);
+   }  // teardown
+
+   // FIFO holds for smallest-first queues too
+   void test_stable_fifoGreater()
+   {  // setup
+      custom::stable_priority_queue <Job, JobGreater> pq;
+      pq.push(Job{ 2, 0 });
+      pq.push(Job{ 1, 1 });
+      pq.push(Job{ 2, 2 });
+      pq.push(Job{ 1, 3 });
+      int expected[] = { 1, 3, 0, 2 };
+      // exercise and verify
+      for (int i = 0; i < 4; i++)
+      {
+         assertUnit(pq.top().id == expected[i]);
+         pq.pop();
+      }
+   }  // teardown
+
+   /***************************************
+    * PACKED STABLE PRIORITY QUEUE
+    ***************************************/
+
+   // default constructor, nothing stored
+   void test_packed_construct()
+   {  // exercise
+      custom::packed_stable_priority_queue <uint32_t> pq;
+      // verify
+      assertUnit(pq.empty());
+      assertUnit(pq.size() == 0);
+      assertUnit(pq.nextSequence == 0);
+   }  // teardown
+
+   // distinct keys come out largest first
+   void test_packed_order()
+   {  // setup
+      custom::packed_stable_priority_queue <uint32_t> pq;
+      uint32_t values[] = { 10, 8, 9, 4, 3, 7, 5 };
+      for (uint32_t v : values)
+         pq.push(v);
+      uint32_t expected[] = { 10, 9, 8, 7, 5, 4, 3 };
+      // exercise and verify
+      for (int i = 0; i < 7; i++)
+      {
+         assertUnit(pq.top() == expected[i]);
+         pq.pop();
+      }
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // equal keys leave in order of their sequence number
+   void test_packed_fifo()
+   {  // setup
+      custom::packed_stable_priority_queue <uint32_t> pq;
+      pq.push(5);   // sequence 0
+      pq.push(6);   // sequence 1
+      pq.push(5);   // sequence 2
+      pq.push(5);   // sequence 3
+      // exercise
+      pq.pop();     // the 6
+      uint64_t first = pq.pq.top();
+      pq.pop();
+      uint64_t second = pq.pq.top();
+      pq.pop();
+      uint64_t third = pq.pq.top();
+      // verify: low 32 bits hold (2^32 - 1 - sequence)
+      assertUnit((first  & 0xffffffff) == 0xffffffff - 0);
+      assertUnit((second & 0xffffffff) == 0xffffffff - 2);
+      assertUnit((third  & 0xffffffff) == 0xffffffff - 3);
+      assertUnit(pq.top() == 5);
+   }  // teardown
+
+   // signed keys order correctly across zero
+   void test_packed_signed()
+   {  // setup
+      custom::packed_stable_priority_queue <int, 16> pq;
+      pq.push(-3);
+      pq.push(7);
+      pq.push(0);
+      pq.push(-32768);
+      pq.push(32767);
+      int expected[] = { 32767, 7, 0, -3, -32768 };
+      // exercise and verify
+      for (int i = 0; i < 5; i++)
+      {
+         assertUnit(pq.top() == expected[i]);
+         pq.pop();
+      }
+   }  // teardown
+
+   // std::greater puts the smallest key on top, earliest first
+   void test_packed_greater()
+   {  // setup
+      custom::packed_stable_priority_queue <uint16_t, 16, std::greater<uint16_t>> pq;
+      pq.push(9);
+      pq.push(2);
+      pq.push(2);
+      // exercise
+      uint64_t first = pq.pq.top();
+      pq.pop();
+      uint64_t second = pq.pq.top();
+      // verify
+      assertUnit((first >> 48) == 2);
+      assertUnit((first & 0xffffffffffff) == 1);    // sequence 1
+      assertUnit((second >> 48) == 2);
+      assertUnit((second & 0xffffffffffff) == 2);   // sequence 2
+   }  // teardown
+
+   // a key wider than KeyBits is rejected
+   void test_packed_outOfRange()
+   {  // setup
+      custom::packed_stable_priority_queue <int, 8> pq;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         pq.push(128);
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // running out of sequence numbers renumbers without reordering
+   void test_packed_renumber()
+   {  // setup: 4 bits of sequence, so 16 pushes before renumbering
+      custom::packed_stable_priority_queue <uint32_t, 60> pq;
+      for (int i = 0; i < 16; i++)
+      {
+         pq.push(i % 2);
+         if (i % 2 == 1)
+            pq.pop();   // drops a 1, leaving the 0s
+      }
+      assertUnit(pq.size() == 8);
+      assertUnit(pq.nextSequence == 16);
+      // exercise
+      pq.push(1);
+      // verify
+      assertUnit(pq.nextSequence == 9);
+      assertUnit(pq.size() == 9);
+      assertUnit(pq.top() == 1);
+      pq.pop();
+      bool renumbered = true;
+      for (uint64_t sequence = 0; sequence < 8; sequence++)
+      {
+         renumbered = renumbered && (pq.pq.top() & 0xf) == 15 - sequence;
+         pq.pop();
+      }
+      assertUnit(renumbered);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // a queue holding every sequence number cannot take more
+   void test_packed_full()
+   {  // setup
+      custom::packed_stable_priority_queue <uint32_t, 60> pq;
+      for (int i = 0; i < 16; i++)
+         pq.push(1);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         pq.push(1);
+      }
+      catch (const std::length_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(pq.size() == 16);
+   }  // teardown
+};
+
+#endif // DEBUG
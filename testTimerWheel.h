@@ -0,0 +1,401 @@
+/***********************************************************************
+ * Header:
+ *    TEST TIMER WHEEL
+ * Summary:
+ *    Unit tests for the timer wheel
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "timer_wheel.h"
+#include "unitTest.h"
+
+#include <queue>
+#include <vector>
+#include <functional>
+
+class TestTimerWheel : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_range();
+
+      // Access
+      test_top_empty();
+      test_top_standard();
+
+      // Insert
+      test_push_levelZero();
+      test_push_cascade();
+      test_push_beforeCursor();
+      test_push_overdueRebase();
+      test_push_mixedDelays();
+
+      // Remove
+      test_pop_empty();
+      test_pop_standard();
+      test_pop_random();
+      test_cancel_standard();
+      test_cancel_stale();
+      test_cancel_overdue();
+      test_expire_standard();
+
+      report("TimerWheel");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, nothing scheduled
+   void test_construct_default()
+   {  // exercise
+      custom::timer_wheel <uint64_t> tw;
+      // verify
+      assertUnit(tw.size() == 0);
+      assertUnit(tw.empty());
+      assertUnit(tw.nodes.empty());
+      assertUnit(tw.buckets.size() == 64 * 11);
+      assertUnit(tw.cursor == 0);
+   }  // teardown
+
+   // range constructor
+   void test_construct_range()
+   {  // setup
+      uint64_t deadlines[] = { 40, 10, 30, 20 };
+      // exercise
+      custom::timer_wheel <uint64_t> tw(deadlines, deadlines + 4);
+      // verify
+      assertUnit(tw.size() == 4);
+      assertUnit(tw.top() == 10);
+   }  // teardown
+
+   /***************************************
+    * TOP
+    ***************************************/
+
+   // top of an empty wheel throws
+   void test_top_empty()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         tw.top();
+      }
+      catch (const std::out_of_range &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // top is the earliest deadline
+   void test_top_standard()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      setupStandardFixture(tw);
+      // exercise
+      uint64_t t = tw.top();
+      // verify
+      assertUnit(t == 3);
+      assertUnit(tw.size() == 7);
+   }  // teardown
+
+   /***************************************
+    * PUSH
+    ***************************************/
+
+   // near deadlines stay on level 0
+   void test_push_levelZero()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      // exercise
+      tw.push(5);
+      tw.push(63);
+      // verify
+      assertUnit(tw.size() == 2);
+      assertUnit(tw.occupied[0] == (((uint64_t)1 << 5) | ((uint64_t)1 << 63)));
+      for (int level = 1; level < 11; level++)
+         assertUnit(tw.occupied[level] == 0);
+      assertUnit(tw.top() == 5);
+   }  // teardown
+
+   // a far deadline on its own is cascaded down to level 0
+   void test_push_cascade()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      // exercise
+      tw.push(1000000);
+      tw.push(1000000 + 64 * 64);
+      // verify
+      assertUnit(tw.cursor == 1000000);
+      assertUnit(tw.occupied[0] == 1);   // slot of 1000000 relative to itself
+      assertUnit(tw.occupied[2] != 0);   // second timer differs in the third digit
+      assertUnit(tw.top() == 1000000);
+   }  // teardown
+
+   // a deadline before the cursor waits on the overdue heap and comes out first
+   void test_push_beforeCursor()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      tw.push(5000);
+      tw.push(9000);
+      assertUnit(tw.cursor == 4992);   // start of the level 0 row holding 5000
+      // exercise
+      tw.push(100);
+      // verify
+      assertUnit(tw.cursor == 4992);   // no rebase
+      assertUnit(tw.overdue.size() == 1);
+      assertUnit(tw.size() == 3);
+      assertUnit(tw.top() == 100);
+      tw.pop();
+      assertUnit(tw.top() == 5000);
+      tw.pop();
+      assertUnit(tw.top() == 9000);
+   }  // teardown
+
+   // once the overdue heap outgrows the wheel, the cursor moves back
+   void test_push_overdueRebase()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      tw.push(5000);
+      tw.push(300);
+      // exercise
+      tw.push(200);
+      // verify
+      assertUnit(tw.overdue.empty());
+      assertUnit(tw.cursor == 200);
+      assertUnit(tw.top() == 200);
+      tw.pop();
+      assertUnit(tw.top() == 300);
+      tw.pop();
+      assertUnit(tw.top() == 5000);
+   }  // teardown
+
+   // short delays among long ones never rebase a wheel full of long ones
+   void test_push_mixedDelays()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      std::priority_queue <uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> pq;
+      for (uint64_t i = 0; i < 1000; i++)
+      {
+         tw.push(1000000 + i * 1000);
+         pq.push(1000000 + i * 1000);
+      }
+      uint64_t cursor = tw.cursor;
+      bool same = true;
+      // exercise
+      for (uint64_t now = 0; now < 5000; now++)
+      {
+         tw.push(now + 10 + now % 7);
+         pq.push(now + 10 + now % 7);
+         same = same && tw.overdue.size() <= tw.size() / 2 + 1;
+         while (same && !pq.empty() && pq.top() <= now)
+         {
+            same = tw.top() == pq.top();
+            tw.pop();
+            pq.pop();
+         }
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(tw.cursor == cursor);
+      while (same && !pq.empty())
+      {
+         same = tw.top() == pq.top();
+         tw.pop();
+         pq.pop();
+      }
+      assertUnit(same);
+      assertUnit(tw.empty());
+   }  // teardown
+
+   /***************************************
+    * POP
+    ***************************************/
+
+   // pop an empty wheel does nothing
+   void test_pop_empty()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      // exercise
+      tw.pop();
+      // verify
+      assertUnit(tw.empty());
+   }  // teardown
+
+   // pop everything from the standard fixture in order
+   void test_pop_standard()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      setupStandardFixture(tw);
+      uint64_t expected[] = { 3, 4, 70, 4100, 4100, 300000, 90000000000 };
+      // exercise and verify
+      for (int i = 0; i < 7; i++)
+      {
+         assertUnit(tw.top() == expected[i]);
+         tw.pop();
+      }
+      assertUnit(tw.empty());
+      assertUnit(tw.nodes.size() == 7);   // the slab is kept for reuse
+   }  // teardown
+
+   // interleaved pushes and pops agree with std::priority_queue
+   void test_pop_random()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      std::priority_queue <uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> pq;
+      uint64_t seed = 12345;
+      uint64_t now = 0;
+      bool same = true;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         if ((seed >> 60) < 10 || pq.empty())
+         {
+            uint64_t t = now + ((seed >> 20) & 0xfffff);
+            tw.push(t);
+            pq.push(t);
+         }
+         else
+         {
+            same = same && tw.top() == pq.top();
+            now = pq.top();
+            tw.pop();
+            pq.pop();
+         }
+      }
+      while (!pq.empty())
+      {
+         same = same && tw.top() == pq.top();
+         tw.pop();
+         pq.pop();
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(tw.empty());
+   }  // teardown
+
+   /***************************************
+    * CANCEL
+    ***************************************/
+
+   // cancel removes a timer wherever it is on the wheel
+   void test_cancel_standard()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      tw.push(4);
+      custom::timer_wheel <uint64_t>::handle h3 = tw.push(3);
+      custom::timer_wheel <uint64_t>::handle hFar = tw.push(300000);
+      tw.push(70);
+      // exercise
+      bool canceledNear = tw.cancel(h3);
+      bool canceledFar = tw.cancel(hFar);
+      // verify
+      assertUnit(canceledNear);
+      assertUnit(canceledFar);
+      assertUnit(tw.size() == 2);
+      assertUnit(tw.top() == 4);
+      tw.pop();
+      assertUnit(tw.top() == 70);
+      tw.pop();
+      assertUnit(tw.empty());
+   }  // teardown
+
+   // a handle whose timer already fired does not cancel its successor
+   void test_cancel_stale()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      custom::timer_wheel <uint64_t>::handle h = tw.push(10);
+      tw.pop();
+      tw.push(20);   // reuses the same node
+      // exercise
+      bool canceled = tw.cancel(h);
+      // verify
+      assertUnit(!canceled);
+      assertUnit(tw.size() == 1);
+      assertUnit(tw.top() == 20);
+   }  // teardown
+
+   // cancel reaches a timer on the overdue heap
+   void test_cancel_overdue()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      tw.push(5000);
+      tw.push(9000);
+      tw.push(7000);
+      tw.push(20);
+      custom::timer_wheel <uint64_t>::handle h = tw.push(10);
+      tw.push(30);
+      assertUnit(tw.overdue.size() == 3);
+      // exercise
+      bool canceled = tw.cancel(h);
+      // verify
+      assertUnit(canceled);
+      assertUnit(tw.size() == 5);
+      uint64_t expected[] = { 20, 30, 5000, 7000, 9000 };
+      for (int i = 0; i < 5; i++)
+      {
+         assertUnit(tw.top() == expected[i]);
+         tw.pop();
+      }
+   }  // teardown
+
+   /***************************************
+    * EXPIRE
+    ***************************************/
+
+   // expire fires everything due, earliest first
+   void test_expire_standard()
+   {  // setup
+      custom::timer_wheel <uint64_t> tw;
+      setupStandardFixture(tw);
+      std::vector<uint64_t> fired;
+      // exercise
+      size_t numFired = tw.expire(4100, [&fired](const uint64_t & t) { fired.push_back(t); });
+      // verify
+      assertUnit(numFired == 5);
+      assertUnit(fired.size() == 5);
+      if (fired.size() == 5)
+      {
+         assertUnit(fired[0] == 3);
+         assertUnit(fired[1] == 4);
+         assertUnit(fired[2] == 70);
+         assertUnit(fired[3] == 4100);
+         assertUnit(fired[4] == 4100);
+      }
+      assertUnit(tw.size() == 2);
+      assertUnit(tw.top() == 300000);
+   }  // teardown
+
+   /****************************************************************
+    * SETUP STANDARD FIXTURE
+    *   deadlines spread across levels 0, 1, 2, 3, and 6
+    *   { 4100, 3, 300000, 70, 90000000000, 4, 4100 }
+    ****************************************************************/
+   void setupStandardFixture(custom::timer_wheel <uint64_t> & tw)
+   {
+      tw.push(4100);
+      tw.push(3);
+      tw.push(300000);
+      tw.push(70);
+      tw.push(90000000000ULL);
+      tw.push(4);
+      tw.push(4100);
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,302 @@
+/***********************************************************************
+ * Header:
+ *    TEST TRACKING ALLOCATOR
+ * Summary:
+ *    Unit tests for the tracking allocator and its tracker
+ * Author:
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "tracking_allocator.h"
+#include "priority_queue.h"
+#include "vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <sstream>
+
+class TestTrackingAllocator : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Vector
+      test_vector_growth();
+      test_vector_history();
+      test_vector_shrinkToFit();
+      test_vector_destroyFreesAll();
+      test_vector_copyKeepsTracker();
+      test_vector_swapKeepsBuffersWithTrackers();
+      test_vector_spyBalanced();
+      test_vector_defaultInitBalanced();
+      test_vector_appendUninitializedBalanced();
+      test_vector_releaseAdoptBalanced();
+
+      // Tracker
+      test_tracker_global();
+      test_tracker_reset();
+      test_report_print();
+
+      // Priority queue
+      test_pqueue_tracked();
+
+      report("TrackingAllocator");
+   }
+
+   typedef custom::vector<int, custom::tracking_allocator<int>> Vector;
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // five pushes double to 1, 2, 4 then 8 ints; the peak is 4 and 8 at once
+   void test_vector_growth()
+   {  // setup
+      custom::allocation_tracker tracker;
+      Vector v{ custom::tracking_allocator<int>(tracker) };
+      // exercise
+      for (int i = 0; i < 5; i++)
+         v.push_back(i);
+      custom::allocation_report r = tracker.report();
+      // verify
+      assertUnit(r.allocations == 4);
+      assertUnit(r.deallocations == 3);
+      assertUnit(r.bytesLive == 8 * sizeof(int));
+      assertUnit(r.bytesPeak == 12 * sizeof(int));
+      assertUnit(r.bytesUsed == 5 * sizeof(int));
+      assertUnit(r.bytesWasted() == 3 * sizeof(int));
+   }  // teardown
+
+   // every allocate and free, in order
+   void test_vector_history()
+   {  // setup
+      custom::allocation_tracker tracker;
+      Vector v{ custom::tracking_allocator<int>(tracker) };
+      // exercise
+      v.push_back(1);
+      v.push_back(2);
+      // verify
+      assertUnit(tracker.history().size() == 3);
+      if (tracker.history().size() == 3)
+      {
+         assertUnit(tracker.history()[0].bytes == (long long)sizeof(int));
+         assertUnit(tracker.history()[1].bytes == 2 * (long long)sizeof(int));
+         assertUnit(tracker.history()[1].bytesLive == 3 * sizeof(int));
+         assertUnit(tracker.history()[2].bytes == -(long long)sizeof(int));
+         assertUnit(tracker.history()[2].bytesLive == 2 * sizeof(int));
+      }
+   }  // teardown
+
+   // shrink_to_fit gives back the unused capacity
+   void test_vector_shrinkToFit()
+   {  // setup
+      custom::allocation_tracker tracker;
+      Vector v{ custom::tracking_allocator<int>(tracker) };
+      for (int i = 0; i < 5; i++)
+         v.push_back(i);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(tracker.report().bytesLive == 5 * sizeof(int));
+      assertUnit(tracker.report().bytesWasted() == 0);
+   }  // teardown
+
+   // nothing is left when the vector goes
+   void test_vector_destroyFreesAll()
+   {  // setup
+      custom::allocation_tracker tracker;
+      // exercise
+      {
+         Vector v{ custom::tracking_allocator<int>(tracker) };
+         for (int i = 0; i < 100; i++)
+            v.push_back(i);
+      }
+      // verify
+      assertUnit(tracker.report().bytesLive == 0);
+      assertUnit(tracker.report().bytesUsed == 0);
+      assertUnit(tracker.report().allocations == tracker.report().deallocations);
+   }  // teardown
+
+   // a copy reports to the same tracker
+   void test_vector_copyKeepsTracker()
+   {  // setup
+      custom::allocation_tracker tracker;
+      Vector v{ custom::tracking_allocator<int>(tracker) };
+      v.push_back(1);
+      v.push_back(2);
+      // exercise
+      Vector copy(v);
+      // verify
+      assertUnit(tracker.report().allocations == 3);
+      assertUnit(tracker.report().bytesUsed == 4 * sizeof(int));
+   }  // teardown
+
+   // a buffer is freed through the tracker that allocated it
+   void test_vector_swapKeepsBuffersWithTrackers()
+   {  // setup
+      custom::allocation_tracker trackerA;
+      custom::allocation_tracker trackerB;
+      {
+         Vector a{ custom::tracking_allocator<int>(trackerA) };
+         Vector b{ custom::tracking_allocator<int>(trackerB) };
+         a.push_back(1);
+         b.push_back(2);
+         b.push_back(3);
+         // exercise
+         a.swap(b);
+      }
+      // verify
+      assertUnit(trackerA.report().bytesLive == 0);
+      assertUnit(trackerB.report().bytesLive == 0);
+   }  // teardown
+
+   // every element constructed, moved or copied is destroyed
+   void test_vector_spyBalanced()
+   {  // setup
+      custom::allocation_tracker tracker;
+      // exercise
+      {
+         custom::vector<Spy, custom::tracking_allocator<Spy>> v{ custom::tracking_allocator<Spy>(tracker) };
+         for (int i = 0; i < 20; i++)
+            v.push_back(Spy(i));
+         v.pop_back();
+         v.shrink_to_fit();
+         assertUnit(tracker.report().bytesUsed == 19 * sizeof(Spy));
+      }
+      // verify
+      assertUnit(tracker.report().bytesUsed == 0);
+      assertUnit(tracker.report().bytesLive == 0);
+   }  // teardown
+
+   // default-initialized elements are counted as they are made and as they go
+   void test_vector_defaultInitBalanced()
+   {  // setup
+      custom::allocation_tracker tracker;
+      Vector v{ custom::tracking_allocator<int>(tracker) };
+      // exercise
+      v.resize_default_init(10);
+      size_t used = tracker.report().bytesUsed;
+      v.clear();
+      // verify
+      assertUnit(used == 10 * sizeof(int));
+      assertUnit(tracker.report().bytesUsed == 0);
+   }  // teardown
+
+   // so are the ones append_uninitialized hands out
+   void test_vector_appendUninitializedBalanced()
+   {  // setup
+      custom::allocation_tracker tracker;
+      // exercise
+      {
+         Vector v{ custom::tracking_allocator<int>(tracker) };
+         int * p = v.append_uninitialized(8);
+         for (int i = 0; i < 8; i++)
+            p[i] = i;
+         v.pop_back();
+         assertUnit(tracker.report().bytesUsed == 7 * sizeof(int));
+      }
+      // verify
+      assertUnit(tracker.report().bytesUsed == 0);
+      assertUnit(tracker.report().bytesLive == 0);
+   }  // teardown
+
+   // a buffer passed from vector to vector is counted once, and let go once
+   void test_vector_releaseAdoptBalanced()
+   {  // setup
+      custom::allocation_tracker tracker;
+      custom::tracking_allocator<int> alloc(tracker);
+      // exercise
+      {
+         Vector from{ alloc };
+         for (int i = 0; i < 5; i++)
+            from.push_back(i);
+         Vector::buffer released = from.release();
+         Vector to{ alloc };
+         to.adopt(released.data, released.size, released.capacity);
+         assertUnit(tracker.report().bytesUsed == 5 * sizeof(int));
+         assertUnit(to[4] == 4);
+      }
+      // verify
+      assertUnit(tracker.report().bytesUsed == 0);
+      assertUnit(tracker.report().bytesLive == 0);
+   }  // teardown
+
+   /***************************************
+    * TRACKER
+    ***************************************/
+
+   // a default allocator reports to the global tracker
+   void test_tracker_global()
+   {  // setup
+      custom::allocation_tracker::global().reset();
+      // exercise
+      Vector v;
+      v.push_back(7);
+      // verify
+      assertUnit(custom::allocation_tracker::global().report().allocations == 1);
+      assertUnit(custom::allocation_tracker::global().report().bytesUsed >= sizeof(int));
+   }  // teardown
+
+   // reset starts the counts and the peak over from what is live
+   void test_tracker_reset()
+   {  // setup
+      custom::allocation_tracker tracker;
+      Vector v{ custom::tracking_allocator<int>(tracker) };
+      for (int i = 0; i < 5; i++)
+         v.push_back(i);
+      // exercise
+      tracker.reset();
+      // verify
+      assertUnit(tracker.report().allocations == 0);
+      assertUnit(tracker.report().bytesLive == 8 * sizeof(int));
+      assertUnit(tracker.report().bytesPeak == 8 * sizeof(int));
+      assertUnit(tracker.history().empty());
+   }  // teardown
+
+   // the report prints on one line
+   void test_report_print()
+   {  // setup
+      custom::allocation_report r;
+      r.allocations = 2;
+      r.bytesLive = 16;
+      r.bytesPeak = 24;
+      r.bytesUsed = 12;
+      std::ostringstream out;
+      // exercise
+      r.print(out);
+      // verify
+      assertUnit(out.str() == "allocations 2, frees 0, live 16B, peak 24B, wasted 4B\n");
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // a heap over a tracked vector drains and frees
+   void test_pqueue_tracked()
+   {  // setup
+      custom::allocation_tracker tracker;
+      tracker.reset();
+      {
+         custom::priority_queue<int, Vector> pq(std::less<int>(),
+                                                Vector{ custom::tracking_allocator<int>(tracker) });
+         // exercise
+         for (int i = 0; i < 1000; i++)
+            pq.push((i * 7) % 1000);
+         while (!pq.empty())
+            pq.pop();
+         assertUnit(tracker.report().bytesUsed == 0);
+         assertUnit(tracker.report().bytesPeak == 1536 * sizeof(int));
+      }
+      // verify
+      assertUnit(tracker.report().bytesLive == 0);
+   }  // teardown
+};
+
+#endif // DEBUG
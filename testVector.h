@@ -17,7 +17,71 @@
 #include "spy.h"
 
 #include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
+
+/***************************************
+ * THROWING COPY
+ * Owns an int; its copy throws once copiesLeft
+ * runs out. Nothing points at one, so its bytes
+ * can move.
+ ***************************************/
+struct ThrowingCopy
+{
+   explicit ThrowingCopy(int value) : p(new int(value)) { live++; }
+   ThrowingCopy(const ThrowingCopy & rhs) : p(nullptr)
+   {
+      if (copiesLeft == 0)
+         throw std::runtime_error("ThrowingCopy: no copies left");
+      if (copiesLeft > 0)
+         copiesLeft--;
+      p = new int(*rhs.p);
+      live++;
+   }
+   ThrowingCopy & operator = (const ThrowingCopy & rhs) { *p = *rhs.p; return *this; }
+   ~ThrowingCopy() { delete p; live--; }
+   int * p;
+   static inline int copiesLeft = -1;   // negative: never throw
+   static inline int live = 0;
+};
+
+namespace custom
+{
+template <> struct is_trivially_relocatable<ThrowingCopy> : std::true_type { };
+}
+
+/***************************************
+ * STEP ITERATORS
+ * Count up from value, and count every ++ taken.
+ * RandomStep has iterator traits and subtraction;
+ * WalkStep has neither and must be walked.
+ ***************************************/
+struct RandomStep
+{
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef int                             value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef const int *                     pointer;
+   typedef const int &                     reference;
+
+   int value;
+   static inline int steps = 0;
+   RandomStep & operator ++ () { value++; steps++; return *this; }
+   const int & operator * () const { return value; }
+   bool operator != (const RandomStep & rhs) const { return value != rhs.value; }
+   bool operator == (const RandomStep & rhs) const { return value == rhs.value; }
+   std::ptrdiff_t operator - (const RandomStep & rhs) const { return value - rhs.value; }
+};
+struct WalkStep
+{
+   int value;
+   static inline int steps = 0;
+   WalkStep & operator ++ () { value++; steps++; return *this; }
+   const int & operator * () const { return value; }
+   bool operator != (const WalkStep & rhs) const { return value != rhs.value; }
+};
 
 class TestVector : public UnitTest
 {
@@ -90,6 +154,21 @@ public:
       test_resize_fourZero();
       test_resize_fourSixDefault();
       test_resize_fourSixValue();
+      test_resizeDefaultInit_fourSix();
+      test_resizeDefaultInit_fourTwo();
+      test_resizeDefaultInit_intKeepsCapacity();
+      test_appendUninitialized_empty();
+      test_appendUninitialized_amortized();
+      test_insert_middle();
+      test_insert_trivial();
+      test_insert_nothing();
+      test_insert_copyThrows();
+      test_appendRange_standard();
+      test_assign_range();
+      test_assign_copyThrows();
+      test_distance_randomAccess();
+      test_distance_noTraits();
+      test_distance_vectorIterator();
       test_reserve_emptyZero();
       test_reserve_emptyTen();
       test_reserve_fourZero();
@@ -102,6 +181,7 @@ public:
       test_popback_empty();
       test_popback_full();
       test_popback_partiallyFilled();
+      test_popback_emptyReserved();
       test_clear_empty();
       test_clear_full();
       test_clear_partiallyFilled();
@@ -109,6 +189,11 @@ public:
       test_shrink_toEmpty();
       test_shrink_standard();
       test_shrink_twoExtraSlots();
+      test_shrink_moveOnly();
+      test_shrinkTo_headroom();
+      test_shrinkTo_belowSize();
+      test_erase_middle();
+      test_erase_trivial();
       
       // Status
       test_size_empty();
@@ -118,6 +203,18 @@ public:
       test_capacity_empty();
       test_capacity_full();
 
+      // Relocation
+      test_relocatable_trait();
+      test_reserve_notRelocatable();
+
+      // Ownership
+      test_adopt_empty();
+      test_adopt_replaces();
+      test_adopt_tooSmall();
+      test_adopt_noCapacity();
+      test_adopt_ownBuffer();
+      test_release_standard();
+
       report("Vector");
    }
    
@@ -681,8 +778,8 @@ public:
       // exercise
       v.resize(6);
       // verify
-      assertUnit(Spy::numCopyMove() == 4);  // copy-move [26,49,67,89]
-      assertUnit(Spy::numDestructor() == 4);// destory now-empty [26,49,67,89]
+      assertUnit(Spy::numCopyMove() == 0);  // relocate [26,49,67,89]
+      assertUnit(Spy::numDestructor() == 0);// nothing left behind to destroy
       assertUnit(Spy::numDefault() == 2);   // create new [00,00]
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numNondefault() == 0);
@@ -722,8 +819,8 @@ public:
       // exercise
       v.resize(6, s);
       // verify
-      assertUnit(Spy::numCopyMove() == 4);  // copy-move [26,49,67,89]
-      assertUnit(Spy::numDestructor() == 4);// destroy old and moved [26,49,67,89]
+      assertUnit(Spy::numCopyMove() == 0);  // relocate [26,49,67,89]
+      assertUnit(Spy::numDestructor() == 0);// nothing left behind to destroy
       assertUnit(Spy::numCopy() == 2);      // copy-create [99,99]
       assertUnit(Spy::numAlloc() == 2);     // allocate [99,99]
       assertUnit(Spy::numDelete() == 0);
@@ -945,8 +1042,8 @@ public:
       v.reserve(10);
       // verify
       assertUnit(v.numCapacity == 10);
-      assertUnit(Spy::numCopyMove() == 4);   // copy-move [26,49,67,89]
-      assertUnit(Spy::numDestructor() == 4); // destroy the now-empty [26,49,67,89]
+      assertUnit(Spy::numCopyMove() == 0);   // relocate [26,49,67,89]
+      assertUnit(Spy::numDestructor() == 0); // nothing left behind to destroy
       assertUnit(Spy::numCopy() == 0);  
       assertUnit(Spy::numAlloc() == 0); 
       assertUnit(Spy::numDelete() == 0);
@@ -1062,10 +1159,10 @@ public:
       Spy::reset();
       v.shrink_to_fit();
       // verify
-      assertUnit(Spy::numCopy() == 4);      // copy [26,49,67,89] to new buffer
-      assertUnit(Spy::numAlloc() == 4);     // allocate [26,49,67,89]
-      assertUnit(Spy::numDestructor() == 4);// destroy [26,49,67,89] from old buffer
-      assertUnit(Spy::numDelete() == 4);    // delete [26,49,67,89]
+      assertUnit(Spy::numCopy() == 0);      // relocate [26,49,67,89] to new buffer
+      assertUnit(Spy::numAlloc() == 0);     // their ints stay where they are
+      assertUnit(Spy::numDestructor() == 0);// nothing left behind to destroy
+      assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
@@ -1075,6 +1172,68 @@ public:
       // teardown
       teardownStandardFixture(v);
    }
+   // an element that cannot be copied is moved into the smaller array
+   void test_shrink_moveOnly()
+   {  // setup
+      custom::vector<std::unique_ptr<int>> v;
+      v.reserve(8);
+      for (int i = 0; i < 3; i++)
+         v.push_back(std::unique_ptr<int>(new int(i * 10)));
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.numCapacity == 3);
+      assertUnit(v.numElements == 3);
+      assertUnit(*v.data[0] == 0);
+      assertUnit(*v.data[2] == 20);
+   }  // teardown
+
+   // shrink_to keeps the capacity asked for, no more
+   void test_shrinkTo_headroom()
+   {  // setup
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 49 |    |    |    |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      custom::vector<Spy> v;
+      v.reserve(8);
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      v.shrink_to(4);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 |    |    |
+      //    +----+----+----+----+
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 2);
+      assertUnit(v.data[0] == Spy(26));
+      assertUnit(v.data[1] == Spy(49));
+   }  // teardown
+
+   // shrink_to never drops below the elements, nor grows
+   void test_shrinkTo_belowSize()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      // exercise
+      v.shrink_to(2);
+      v.shrink_to(10);
+      // verify
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
    
    /***************************************
     * SIZE EMPTY CAPACITY
@@ -2014,6 +2173,29 @@ public:
       teardownStandardFixture(v);
    }
 
+   // popback of nothing, with room reserved, stays empty
+   void test_popback_emptyReserved()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    |    |    |    |    |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      v.data = v.alloc.allocate(4);
+      v.numElements = 0;
+      v.numCapacity = 4;
+      Spy::reset();
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.numCapacity == 4);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
    /***************************************
     * CLEAR
     ***************************************/
@@ -2200,8 +2382,8 @@ public:
       // exercise
       v.push_back(s);
       // verify
-      assertUnit(Spy::numCopyMove() == 3);       // move [26,49,67] 
-      assertUnit(Spy::numDestructor() == 3);     // destroy empty [26,49,67]
+      assertUnit(Spy::numCopyMove() == 0);       // relocate [26,49,67]
+      assertUnit(Spy::numDestructor() == 0);     // nothing left behind to destroy
       assertUnit(Spy::numCopy() == 1);           // copy [99]
       assertUnit(Spy::numAlloc() == 1);          // allocate [99]
       assertUnit(Spy::numDelete() == 0);
@@ -2315,8 +2497,8 @@ public:
       // exercise
       v.push_back(std::move(s));
       // verify
-      assertUnit(Spy::numCopyMove() == 4);       // move [26,49,67] and [99]
-      assertUnit(Spy::numDestructor() == 3);     // destroy empty [26,49,67]
+      assertUnit(Spy::numCopyMove() == 1);       // relocate [26,49,67], move [99]
+      assertUnit(Spy::numDestructor() == 0);     // nothing left behind to destroy
       assertUnit(Spy::numCopy() == 0);           
       assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDelete() == 0);
@@ -2570,6 +2752,558 @@ public:
       teardownStandardFixture(v);
    }
 
+   /***************************************
+    * RESIZE DEFAULT INIT and APPEND UNINITIALIZED
+    ***************************************/
+
+   // grow from 4 to 6: Spy still gets its default constructor
+   void test_resizeDefaultInit_fourSix()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.resize_default_init(6);
+      // verify
+      assertUnit(Spy::numDefault() == 2);   // create new [00,00]
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      if (v.data)
+         assertUnit(v.data[5] == Spy());
+      v.numCapacity = 4;
+      v.numElements = 4;
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // shrink from 4 to 2 like resize
+   void test_resizeDefaultInit_fourTwo()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.resize_default_init(2);
+      // verify
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 2);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[1] == Spy(49));
+      }
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // ints are left as they are: what was written stays
+   void test_resizeDefaultInit_intKeepsCapacity()
+   {  // setup
+      custom::vector<int> v;
+      v.reserve(8);
+      v.push_back(1);
+      v.data[3] = 42;
+      // exercise
+      v.resize_default_init(5);
+      // verify
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == 1);
+      assertUnit(v.data[3] == 42);
+   }  // teardown
+
+   // the pointer is to the first new element
+   void test_appendUninitialized_empty()
+   {  // setup
+      custom::vector<int> v{ 7 };
+      // exercise
+      int * p = v.append_uninitialized(3);
+      for (int i = 0; i < 3; i++)
+         p[i] = 10 + i;
+      // verify
+      assertUnit(p == v.data + 1);
+      assertUnit(v.numElements == 4);
+      assertUnit(v[0] == 7);
+      assertUnit(v[3] == 12);
+   }  // teardown
+
+   // appending a block at a time doubles, not creeps
+   void test_appendUninitialized_amortized()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         v.append_uninitialized(3);
+      // verify
+      assertUnit(v.numElements == 30);
+      assertUnit(v.numCapacity == 48);
+   }  // teardown
+
+   /***************************************
+    * BULK
+    ***************************************/
+
+   // insert two in the middle: one allocation, each copied once
+   void test_insert_middle()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      std::vector<Spy> more{ Spy(11), Spy(22) };
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::iterator it = v.insert(v.begin() + 1, more.begin(), more.end());
+      // verify
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(Spy::numAssign() == 0);
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 11 | 22 | 49 | 67 | 89 |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(it.p == v.data + 1);
+      assertUnit(v.numElements == 6);
+      assertUnit(v.numCapacity == 8);
+      if (v.numElements == 6)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[1] == Spy(11));
+         assertUnit(v.data[2] == Spy(22));
+         assertUnit(v.data[3] == Spy(49));
+         assertUnit(v.data[4] == Spy(67));
+         assertUnit(v.data[5] == Spy(89));
+      }
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // ints shift up in one move
+   void test_insert_trivial()
+   {  // setup
+      custom::vector<int> v{ 1, 2, 5 };
+      int more[] = { 3, 4 };
+      // exercise
+      v.insert(v.begin() + 2, more, more + 2);
+      // verify
+      assertUnit(v.numElements == 5);
+      bool ordered = true;
+      for (int i = 0; i < 5 && v.numElements == 5; i++)
+         ordered = ordered && v.data[i] == i + 1;
+      assertUnit(ordered);
+   }  // teardown
+
+   // inserting nothing changes nothing
+   void test_insert_nothing()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      std::vector<Spy> none;
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::iterator it = v.insert(v.begin() + 4, none.begin(), none.end());
+      // verify
+      assertUnit(it.p == v.data + 4);
+      assertUnit(Spy::numCopy() == 0);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // a copy that throws partway leaves the vector as it was
+   void test_insert_copyThrows()
+   {  // setup
+      {
+         custom::vector<ThrowingCopy> v;
+         v.reserve(8);
+         for (int i = 0; i < 4; i++)
+            v.push_back(ThrowingCopy(i * 10));
+         std::vector<ThrowingCopy> more{ ThrowingCopy(1), ThrowingCopy(2), ThrowingCopy(3) };
+         ThrowingCopy::copiesLeft = 1;
+         // exercise
+         bool thrown = false;
+         try
+         {
+            v.insert(v.begin() + 1, more.begin(), more.end());
+         }
+         catch (const std::runtime_error &)
+         {
+            thrown = true;
+         }
+         ThrowingCopy::copiesLeft = -1;
+         // verify
+         assertUnit(thrown);
+         assertUnit(ThrowingCopy::live == 7);   // the four, and the three in more
+         assertUnit(v.numElements == 4);
+         bool same = v.numElements == 4;
+         for (int i = 0; same && i < 4; i++)
+            same = *v.data[i].p == i * 10;
+         assertUnit(same);
+      }
+      assertUnit(ThrowingCopy::live == 0);
+   }  // teardown
+
+   // append a range: one reallocation for all of it
+   void test_appendRange_standard()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      std::vector<Spy> more{ Spy(1), Spy(2), Spy(3), Spy(4), Spy(5) };
+      Spy::reset();
+      // exercise
+      v.append_range(more.begin(), more.end());
+      // verify
+      assertUnit(Spy::numCopy() == 5);
+      assertUnit(Spy::numCopyMove() == 0);  // [26,49,67,89] relocated to the new buffer
+      assertUnit(v.numElements == 9);
+      assertUnit(v.numCapacity == 9);
+      if (v.numElements == 9)
+         assertUnit(v.data[8] == Spy(5));
+      v.numElements = 4;
+      v.numCapacity = 4;
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // assign replaces, reusing the buffer when it fits
+   void test_assign_range()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy * before = v.data;
+      std::vector<Spy> other{ Spy(7), Spy(8) };
+      Spy::reset();
+      // exercise
+      v.assign(other.begin(), other.end());
+      // verify
+      assertUnit(Spy::numDestructor() == 4);
+      assertUnit(Spy::numCopy() == 2);
+      assertUnit(v.data == before);
+      assertUnit(v.numElements == 2);
+      assertUnit(v.numCapacity == 4);
+      if (v.numElements == 2)
+      {
+         assertUnit(v.data[0] == Spy(7));
+         assertUnit(v.data[1] == Spy(8));
+      }
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // a copy that throws partway through assign leaves only what was built
+   void test_assign_copyThrows()
+   {  // setup
+      {
+         custom::vector<ThrowingCopy> v;
+         v.push_back(ThrowingCopy(10));
+         v.push_back(ThrowingCopy(20));
+         std::vector<ThrowingCopy> other{ ThrowingCopy(1), ThrowingCopy(2), ThrowingCopy(3) };
+         ThrowingCopy::copiesLeft = 1;
+         // exercise
+         bool thrown = false;
+         try
+         {
+            v.assign(other.begin(), other.end());
+         }
+         catch (const std::runtime_error &)
+         {
+            thrown = true;
+         }
+         ThrowingCopy::copiesLeft = -1;
+         // verify
+         assertUnit(thrown);
+         assertUnit(v.numElements == 1);
+         if (v.numElements == 1)
+            assertUnit(*v.data[0].p == 1);
+         assertUnit(ThrowingCopy::live == 4);   // the one copied, and the three in other
+      }
+      assertUnit(ThrowingCopy::live == 0);
+   }  // teardown
+
+   // a random-access range is measured, not walked
+   void test_distance_randomAccess()
+   {  // setup
+      RandomStep::steps = 0;
+      // exercise
+      size_t count = custom::vector<int>::distance(RandomStep{ 3 }, RandomStep{ 1003 });
+      // verify
+      assertUnit(count == 1000);
+      assertUnit(RandomStep::steps == 0);
+   }  // teardown
+
+   // a range with no traits and no subtraction is walked once
+   void test_distance_noTraits()
+   {  // setup
+      WalkStep::steps = 0;
+      custom::vector<int> v;
+      // exercise
+      v.append_range(WalkStep{ 0 }, WalkStep{ 10 });
+      // verify
+      assertUnit(custom::vector<int>::distance(WalkStep{ 0 }, WalkStep{ 10 }) == 10);
+      assertUnit(WalkStep::steps == 10 + 10 + 10);   // append_range measures and copies; distance measures
+      assertUnit(v.size() == 10);
+      if (v.size() == 10)
+         assertUnit(v[0] == 0 && v[9] == 9);
+   }  // teardown
+
+   // vector's own iterator has no traits, but subtracts
+   void test_distance_vectorIterator()
+   {  // setup
+      custom::vector<int> v{ 1, 2, 3, 4, 5 };
+      // exercise
+      size_t count = custom::vector<int>::distance(v.begin() + 1, v.end());
+      // verify
+      assertUnit(count == 4);
+      assertUnit(custom::can_subtract<custom::vector<int>::iterator>::value);
+      assertUnit(!custom::has_iterator_category<custom::vector<int>::iterator>::value);
+   }  // teardown
+
+   // erase the middle two
+   void test_erase_middle()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::iterator it = v.erase(v.begin() + 1, v.begin() + 3);
+      // verify
+      //      0    1
+      //    +----+----+----+----+
+      //    | 26 | 89 |    |    |
+      //    +----+----+----+----+
+      assertUnit(it.p == v.data + 1);
+      assertUnit(Spy::numAssignMove() == 0); // [89] relocated down
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(v.numElements == 2);
+      assertUnit(v.numCapacity == 4);
+      if (v.numElements == 2)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[1] == Spy(89));
+      }
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // ints shift down in one move
+   void test_erase_trivial()
+   {  // setup
+      custom::vector<int> v{ 1, 2, 3, 4, 5 };
+      // exercise
+      v.erase(v.begin(), v.begin() + 2);
+      // verify
+      assertUnit(v.numElements == 3);
+      if (v.numElements == 3)
+      {
+         assertUnit(v.data[0] == 3);
+         assertUnit(v.data[2] == 5);
+      }
+   }  // teardown
+
+   /***************************************
+    * RELOCATION
+    ***************************************/
+
+   // trivially copyable types qualify; Spy opts in; others do not
+   void test_relocatable_trait()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(custom::is_trivially_relocatable<int>::value);
+      assertUnit(custom::is_trivially_relocatable<Spy>::value);
+      assertUnit(!custom::is_trivially_relocatable<SelfPointer>::value);
+      assertUnit(!custom::is_trivially_relocatable<std::vector<int>>::value);
+   }  // teardown
+
+   // a type that knows its own address is still moved one at a time
+   void test_reserve_notRelocatable()
+   {  // setup
+      custom::vector<SelfPointer> v;
+      for (int i = 0; i < 5; i++)
+         v.push_back(SelfPointer());
+      // exercise
+      v.reserve(100);
+      // verify
+      bool home = true;
+      for (size_t i = 0; i < v.numElements; i++)
+         home = home && v.data[i].self == &v.data[i];
+      assertUnit(home);
+   }  // teardown
+
+   // points at itself, so its bytes cannot just move
+   struct SelfPointer
+   {
+      SelfPointer() : self(this) { }
+      SelfPointer(const SelfPointer &) : self(this) { }
+      SelfPointer & operator = (const SelfPointer &) { return *this; }
+      SelfPointer * self;
+   };
+
+   /***************************************
+    * OWNERSHIP
+    ***************************************/
+
+   // adopting a buffer takes it as it is: nothing copied or moved
+   void test_adopt_empty()
+   {  // setup
+      //      0    1    2    3    4
+      //    +----+----+----+----+----+
+      //    | 26 | 49 | 67 |    |    |
+      //    +----+----+----+----+----+
+      custom::vector<Spy> v;
+      std::allocator<Spy> alloc;
+      Spy * p = alloc.allocate(5);
+      new (p + 0) Spy(26);
+      new (p + 1) Spy(49);
+      new (p + 2) Spy(67);
+      Spy::reset();
+      // exercise
+      v.adopt(p, 3, 5);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(v.data == p);
+      assertUnit(v.numElements == 3);
+      assertUnit(v.numCapacity == 5);
+      assertUnit(v[2] == Spy(67));
+   }  // teardown
+
+   // what was there before is destroyed
+   void test_adopt_replaces()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      std::allocator<Spy> alloc;
+      Spy * p = alloc.allocate(1);
+      new (p) Spy(11);
+      Spy::reset();
+      // exercise
+      v.adopt(p, 1, 1);
+      // verify
+      assertUnit(Spy::numDestructor() == 4);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(v.data == p);
+      assertUnit(v.numElements == 1);
+      assertUnit(v[0] == Spy(11));
+   }  // teardown
+
+   // more elements than room is refused, and nothing changes
+   void test_adopt_tooSmall()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      bool thrown = false;
+      try
+      {
+         v.adopt(nullptr, 2, 1);
+      }
+      catch (const std::invalid_argument &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(Spy::numDestructor() == 0);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // a buffer with no capacity to hold it is refused, not dropped
+   void test_adopt_noCapacity()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      std::allocator<Spy> alloc;
+      Spy * p = alloc.allocate(1);
+      Spy::reset();
+      // exercise
+      bool thrown = false;
+      try
+      {
+         v.adopt(p, 0, 0);
+      }
+      catch (const std::invalid_argument &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(Spy::numDestructor() == 0);
+      assertStandardFixture(v);
+      // teardown
+      alloc.deallocate(p, 1);
+      teardownStandardFixture(v);
+   }
+
+   // adopting the buffer already held keeps it, and drops what is past SIZE
+   void test_adopt_ownBuffer()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy * p = v.data;
+      Spy::reset();
+      // exercise
+      v.adopt(p, 2, 4);
+      // verify
+      assertUnit(Spy::numDestructor() == 2);   // destroy [67, 89]
+      assertUnit(Spy::numDelete() == 2);
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 |    |    |
+      //    +----+----+----+----+
+      assertUnit(v.data == p);
+      assertUnit(v.numElements == 2);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v[0] == Spy(26));
+      assertUnit(v[1] == Spy(49));
+   }  // teardown
+
+   // release hands the buffer out and leaves the vector empty
+   void test_release_standard()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy * p = v.data;
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::buffer released = v.release();
+      // verify
+      assertUnit(released.data == p);
+      assertUnit(released.size == 4);
+      assertUnit(released.capacity == 4);
+      assertUnit(Spy::numDestructor() == 0);
+      assertEmptyFixture(v);
+      // teardown
+      std::allocator<Spy> alloc = v.get_allocator();
+      for (size_t i = 0; i < released.size; i++)
+         alloc.destroy(released.data + i);
+      alloc.deallocate(released.data, released.capacity);
+   }
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      0    1    2    3
@@ -0,0 +1,525 @@
+/***********************************************************************
+ * Header:
+ *    TIMER WHEEL
+ * Summary:
+ *    A hierarchical timing wheel for deadline-ordered workloads. The
+ *    element with the earliest deadline is at the top, so it can stand
+ *    in for priority_queue <T, vector <T>, std::greater <T>> when the
+ *    keys are monotonic timestamps.
+ *
+ *    Each level has 64 buckets, one per 6-bit digit of the deadline.
+ *    A timer lives at the level of the highest digit where its deadline
+ *    differs from the wheel's cursor. Level 0 buckets therefore hold a
+ *    single deadline each, and the top is found with one find-first-set.
+ *    When level 0 runs dry the lowest occupied bucket above it is
+ *    cascaded down, which moves each timer at most once per level.
+ *    Buckets are flat arrays of {deadline, node} so a cascade streams
+ *    through memory instead of chasing list pointers.
+ *
+ *    The cursor runs ahead of the clock: it sits at the bucket of the
+ *    earliest timer. A deadline before it (a short delay while only
+ *    long ones are pending) goes on a small binary heap of overdue
+ *    timers, which are all earlier than anything on the wheel. Only
+ *    when that heap outgrows the wheel is the cursor moved back and
+ *    everything relinked. A push, cancel or pop on the wheel costs
+ *    O(1) amortized; one on the overdue heap of k timers is a sift,
+ *    O(log k). The rebase keeps k no larger than the wheel.
+ *
+ *    This will contain the class definition of:
+ *        deadline_of            : Default deadline extractor (T is the key)
+ *        timer_wheel            : A class that represents a Timer Wheel
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>   // std::out_of_range
+#include <utility>     // std::swap
+#include "vector.h"    // for the bucket and node arrays
+#include "bitops.h"    // for find-first-set
+
+class TestTimerWheel;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * DEADLINE OF
+ * Fetch the deadline from an element. The default
+ * treats the element itself as an unsigned timestamp.
+ *************************************************/
+template <class T>
+struct deadline_of
+{
+   uint64_t operator () (const T & t) const { return static_cast<uint64_t>(t); }
+};
+
+/*************************************************
+ * TIMER WHEEL
+ * Insert, cancel, and expire the earliest timer in
+ * amortized O(1), or O(log k) for a deadline before
+ * the cursor, with k overdue timers. T must be
+ * default constructible.
+ *************************************************/
+template <class T, class Deadline = custom::deadline_of<T>>
+class timer_wheel
+{
+   friend class ::TestTimerWheel; // give the unit test class access to the privates
+   template <class TT, class DDeadline>
+   friend void swap(timer_wheel<TT, DDeadline>& lhs, timer_wheel<TT, DDeadline>& rhs);
+
+public:
+
+   // identifies a timer for cancel(): slot index plus a generation count
+   typedef uint64_t handle;
+
+   //
+   // construct
+   //
+   timer_wheel(const Deadline & d = Deadline()) :
+      buckets(NUM_LEVELS * NUM_SLOTS, custom::vector<Entry>()),
+      freeList(NIL), numTimers(0), cursor(0), deadline(d)
+   {
+      for (int level = 0; level < NUM_LEVELS; level++)
+         occupied[level] = 0;
+   }
+   template <class Iterator>
+   timer_wheel(Iterator first, Iterator last, const Deadline & d = Deadline()) : timer_wheel(d)
+   {
+      for (auto it = first; it != last; ++it)
+         push(*it);
+   }
+
+   //
+   // Access
+   //
+   const T & top() const;
+
+   //
+   // Insert
+   //
+   handle push(const T & t);
+   handle push(T && t);
+
+   //
+   // Remove
+   //
+   void pop();
+   bool cancel(handle h);
+   template <class Function>
+   size_t expire(uint64_t now, Function f);
+
+   //
+   // Status
+   //
+   size_t size()  const { return numTimers; }
+   bool empty()   const { return size() == size_t(0); }
+
+private:
+
+   static const int      BITS       = 6;                 // bits of deadline per level
+   static const int      NUM_SLOTS  = 1 << BITS;         // buckets per level
+   static const int      NUM_LEVELS = (64 + BITS - 1) / BITS;
+   static const uint32_t NIL        = 0xffffffff;        // no bucket / end of free list
+   static const uint32_t OVERDUE    = NIL - 1;           // bucket of a timer on the overdue heap
+
+   // a node owns the element; buckets only hold the deadline and node index
+   struct Node
+   {
+      Node() : bucket(NIL), position(NIL), generation(0) { }
+      T        value;       // the user's element
+      uint32_t bucket;      // owning bucket, OVERDUE, or NIL when the node is free
+      uint32_t position;    // index within the bucket or heap, or the next free node
+      uint32_t generation;  // bumped on release so stale handles miss
+   };
+
+   // cascades read the deadline straight out of the bucket
+   struct Entry
+   {
+      uint64_t key;
+      uint32_t index;
+   };
+
+   uint32_t allocate();                 // grab a free node
+   void     release(uint32_t index);    // return a node to the free list
+   void     link(const Entry & entry);  // place an entry in its bucket
+   void     unlink(uint32_t index);     // remove a node's entry from its bucket
+   void     schedule(const Entry & entry); // link, or put on the overdue heap
+   void     settle();                   // cascade until level 0 holds the top
+   void     rebase(uint64_t newCursor); // move the cursor backwards
+   void     placeOverdue(size_t position, const Entry & entry);
+   void     siftUpOverdue(size_t position);
+   void     siftDownOverdue(size_t position);
+   void     removeOverdue(size_t position);
+   const Entry & topEntry() const
+   {
+      if (!overdue.empty())
+         return overdue[0];
+      return buckets[bits::countTrailingZeros(occupied[0])].back();
+   }
+
+   custom::vector<Node>                   nodes;    // slab of timers, addressed by index
+   custom::vector<custom::vector<Entry>>  buckets;  // NUM_LEVELS rows of NUM_SLOTS buckets
+   custom::vector<Entry>                  scratch;  // bucket being cascaded
+   custom::vector<Entry>                  overdue;  // min-heap of timers before the cursor
+   uint64_t occupied[NUM_LEVELS];       // bitmap of non-empty buckets per level
+   uint32_t freeList;                   // first free node
+   size_t   numTimers;                  // number of live timers
+   uint64_t cursor;                     // no timer on the wheel is earlier than this
+   Deadline deadline;                   // deadline extractor
+};
+
+/************************************************
+ * TIMER WHEEL :: TOP
+ * Get the timer with the earliest deadline.
+ ***********************************************/
+template <class T, class Deadline>
+const T & timer_wheel <T, Deadline> :: top() const
+{
+   if (!empty())
+      return nodes[topEntry().index].value;
+   else
+      throw std::out_of_range("std:out_of_range");
+}
+
+/*****************************************
+ * TIMER WHEEL :: PUSH
+ * Add a new timer. A deadline earlier than the cursor
+ * goes on the overdue heap.
+ ****************************************/
+template <class T, class Deadline>
+typename timer_wheel <T, Deadline> :: handle timer_wheel <T, Deadline> :: push(const T & t)
+{
+   uint32_t index = allocate();
+   nodes[index].value = t;
+   schedule(Entry{deadline(t), index});
+   return ((handle)nodes[index].generation << 32) | index;
+}
+template <class T, class Deadline>
+typename timer_wheel <T, Deadline> :: handle timer_wheel <T, Deadline> :: push(T && t)
+{
+   uint64_t key = deadline(t);
+   uint32_t index = allocate();
+   nodes[index].value = std::move(t);
+   schedule(Entry{key, index});
+   return ((handle)nodes[index].generation << 32) | index;
+}
+
+/************************************************
+ * TIMER WHEEL :: SCHEDULE
+ * Count a new timer and give it a place: on the
+ * wheel, or on the overdue heap if it is before the
+ * cursor. Once the heap holds more than the wheel,
+ * rebase; that costs O(n), but only after n/2
+ * overdue pushes.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: schedule(const Entry & entry)
+{
+   numTimers++;
+   if (entry.key >= cursor)
+   {
+      link(entry);
+      settle();
+      return;
+   }
+
+   overdue.push_back(entry);
+   placeOverdue(overdue.size() - 1, entry);
+   siftUpOverdue(overdue.size() - 1);
+   if (overdue.size() > numTimers - overdue.size())
+      rebase(overdue[0].key);
+}
+
+/**********************************************
+ * TIMER WHEEL :: POP
+ * Delete the timer with the earliest deadline.
+ **********************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: pop()
+{
+   if (empty())
+      return;
+
+   uint32_t index = topEntry().index;
+   unlink(index);
+   release(index);
+   settle();
+}
+
+/**********************************************
+ * TIMER WHEEL :: CANCEL
+ * Remove a timer before it expires. Return FALSE if
+ * the handle refers to a timer that is already gone.
+ **********************************************/
+template <class T, class Deadline>
+bool timer_wheel <T, Deadline> :: cancel(handle h)
+{
+   uint32_t index = (uint32_t)(h & 0xffffffff);
+   uint32_t generation = (uint32_t)(h >> 32);
+   if (index >= nodes.size() ||
+       nodes[index].bucket == NIL ||
+       nodes[index].generation != generation)
+      return false;
+
+   unlink(index);
+   release(index);
+   settle();
+   return true;
+}
+
+/**********************************************
+ * TIMER WHEEL :: EXPIRE
+ * Hand every timer due at or before NOW to the callback,
+ * earliest first, and remove it. Return how many fired.
+ **********************************************/
+template <class T, class Deadline>
+template <class Function>
+size_t timer_wheel <T, Deadline> :: expire(uint64_t now, Function f)
+{
+   size_t numFired = 0;
+   while (!empty() && topEntry().key <= now)
+   {
+      f(top());
+      pop();
+      numFired++;
+   }
+   return numFired;
+}
+
+/************************************************
+ * TIMER WHEEL :: ALLOCATE
+ * Take a node off the free list, growing the slab if needed.
+ ************************************************/
+template <class T, class Deadline>
+uint32_t timer_wheel <T, Deadline> :: allocate()
+{
+   if (freeList != NIL)
+   {
+      uint32_t index = freeList;
+      freeList = nodes[index].position;
+      return index;
+   }
+   nodes.push_back(Node());
+   return (uint32_t)(nodes.size() - 1);
+}
+
+/************************************************
+ * TIMER WHEEL :: RELEASE
+ * Drop the element and put the node on the free list.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: release(uint32_t index)
+{
+   Node & node = nodes[index];
+   node.value = T();
+   node.bucket = NIL;
+   node.position = freeList;
+   node.generation++;
+   freeList = index;
+   numTimers--;
+}
+
+/************************************************
+ * TIMER WHEEL :: LINK
+ * Append an entry to the bucket for its deadline relative
+ * to the cursor.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: link(const Entry & entry)
+{
+   assert(entry.key >= cursor);
+
+   // the level is the highest 6-bit digit that differs from the cursor
+   uint64_t diff = entry.key ^ cursor;
+   int level = (diff == 0) ? 0 : bits::highestBit(diff) / BITS;
+   int slot = (int)((entry.key >> (level * BITS)) & (NUM_SLOTS - 1));
+   uint32_t b = (uint32_t)(level * NUM_SLOTS + slot);
+
+   Node & node = nodes[entry.index];
+   node.bucket = b;
+   node.position = (uint32_t)buckets[b].size();
+   buckets[b].push_back(entry);
+   occupied[level] |= (uint64_t)1 << slot;
+}
+
+/************************************************
+ * TIMER WHEEL :: UNLINK
+ * Remove a node's entry from whichever bucket holds it by
+ * moving the bucket's last entry into the hole.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: unlink(uint32_t index)
+{
+   Node & node = nodes[index];
+   if (node.bucket == OVERDUE)
+   {
+      removeOverdue(node.position);
+      return;
+   }
+   custom::vector<Entry> & bucket = buckets[node.bucket];
+
+   if (node.position != bucket.size() - 1)
+   {
+      bucket[node.position] = bucket.back();
+      nodes[bucket[node.position].index].position = node.position;
+   }
+   bucket.pop_back();
+
+   if (bucket.empty())
+      occupied[node.bucket / NUM_SLOTS] &= ~((uint64_t)1 << (node.bucket % NUM_SLOTS));
+}
+
+/************************************************
+ * TIMER WHEEL :: SETTLE
+ * While level 0 is empty, advance the cursor to the start of
+ * the lowest occupied bucket and redistribute that bucket.
+ * Every entry in it lands on a lower level.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: settle()
+{
+   while (numTimers > overdue.size() && occupied[0] == 0)
+   {
+      int level = 1;
+      while (occupied[level] == 0)
+         level++;
+      int slot = bits::countTrailingZeros(occupied[level]);
+      uint32_t b = (uint32_t)(level * NUM_SLOTS + slot);
+
+      // keep the digits above this level, take the slot, zero the rest
+      int shift = (level + 1) * BITS;
+      uint64_t keep = (shift >= 64) ? 0 : (~(uint64_t)0 << shift);
+      cursor = (cursor & keep) | ((uint64_t)slot << (level * BITS));
+
+      // detach the bucket, keeping its buffer around for the next cascade
+      scratch.swap(buckets[b]);
+      occupied[level] &= ~((uint64_t)1 << slot);
+      for (size_t i = 0; i < scratch.size(); i++)
+         link(scratch[i]);
+      scratch.clear();
+   }
+}
+
+/************************************************
+ * TIMER WHEEL :: REBASE
+ * Move the cursor back to an earlier deadline and
+ * relink every live timer, the overdue ones too.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: rebase(uint64_t newCursor)
+{
+   assert(newCursor < cursor);
+   cursor = newCursor;
+
+   for (size_t i = 0; i < overdue.size(); i++)
+      scratch.push_back(overdue[i]);
+   overdue.clear();
+
+   for (size_t b = 0; b < buckets.size(); b++)
+   {
+      for (size_t i = 0; i < buckets[b].size(); i++)
+         scratch.push_back(buckets[b][i]);
+      buckets[b].clear();
+   }
+   for (int level = 0; level < NUM_LEVELS; level++)
+      occupied[level] = 0;
+
+   for (size_t i = 0; i < scratch.size(); i++)
+      link(scratch[i]);
+   scratch.clear();
+   settle();
+}
+
+/************************************************
+ * TIMER WHEEL :: PLACE OVERDUE
+ * Put an entry at POSITION on the overdue heap and
+ * tell its node where it went.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: placeOverdue(size_t position, const Entry & entry)
+{
+   overdue[position] = entry;
+   nodes[entry.index].bucket = OVERDUE;
+   nodes[entry.index].position = (uint32_t)position;
+}
+
+/************************************************
+ * TIMER WHEEL :: SIFT UP OVERDUE
+ * Move the entry at POSITION toward the root until
+ * its parent is no later.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: siftUpOverdue(size_t position)
+{
+   Entry entry = overdue[position];
+   while (position > 0 && overdue[(position - 1) / 2].key > entry.key)
+   {
+      placeOverdue(position, overdue[(position - 1) / 2]);
+      position = (position - 1) / 2;
+   }
+   placeOverdue(position, entry);
+}
+
+/************************************************
+ * TIMER WHEEL :: SIFT DOWN OVERDUE
+ * Move the entry at POSITION toward the leaves
+ * until both children are no earlier.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: siftDownOverdue(size_t position)
+{
+   Entry entry = overdue[position];
+   for (size_t child = 2 * position + 1; child < overdue.size(); child = 2 * position + 1)
+   {
+      if (child + 1 < overdue.size() && overdue[child + 1].key < overdue[child].key)
+         child++;
+      if (overdue[child].key >= entry.key)
+         break;
+      placeOverdue(position, overdue[child]);
+      position = child;
+   }
+   placeOverdue(position, entry);
+}
+
+/************************************************
+ * TIMER WHEEL :: REMOVE OVERDUE
+ * Take the entry at POSITION off the overdue heap,
+ * filling the hole with the last one.
+ ************************************************/
+template <class T, class Deadline>
+void timer_wheel <T, Deadline> :: removeOverdue(size_t position)
+{
+   Entry last = overdue.back();
+   overdue.pop_back();
+   if (position == overdue.size())
+      return;
+   placeOverdue(position, last);
+   siftDownOverdue(position);
+   siftUpOverdue(position);
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two timer wheels
+ ************************************************/
+template <class T, class Deadline>
+inline void swap(custom::timer_wheel <T, Deadline> & lhs,
+                 custom::timer_wheel <T, Deadline> & rhs)
+{
+   lhs.nodes.swap(rhs.nodes);
+   lhs.buckets.swap(rhs.buckets);
+   lhs.scratch.swap(rhs.scratch);
+   lhs.overdue.swap(rhs.overdue);
+   for (int level = 0; level < timer_wheel<T, Deadline>::NUM_LEVELS; level++)
+      std::swap(lhs.occupied[level], rhs.occupied[level]);
+   std::swap(lhs.freeList, rhs.freeList);
+   std::swap(lhs.numTimers, rhs.numTimers);
+   std::swap(lhs.cursor, rhs.cursor);
+   std::swap(lhs.deadline, rhs.deadline);
+}
+
+} // namespace custom
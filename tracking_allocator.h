@@ -0,0 +1,182 @@
+/***********************************************************************
+ * Header:
+ *    TRACKING ALLOCATOR
+ * Summary:
+ *    An allocator for vector (and through it priority_queue) that
+ *    reports to an allocation_tracker: how many allocations, the bytes
+ *    live now and at the peak, the bytes of capacity holding no
+ *    element, and every allocate and free in order. Growth and shrink
+ *    policies can then be judged by their peak, not their guesses.
+ *
+ *    Each allocator points at a tracker; a default-constructed one
+ *    points at allocation_tracker::global(). Give a container its own
+ *    tracker for a per-instance report. Trackers are not thread-safe.
+ *
+ *    This will contain the class definitions of:
+ *        allocation_report      : The numbers, by value
+ *        allocation_tracker     : Collects them
+ *        tracking_allocator     : An allocator that feeds a tracker
+ * Author
+ *    Daniel Carr, Jarom Anderson, Arlo Jolley
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <memory>     // for std::allocator
+#include <new>        // for placement new
+#include <ostream>    // for std::ostream
+#include <utility>    // for std::forward
+#include <vector>     // for std::vector
+
+class TestTrackingAllocator;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * ALLOCATION REPORT
+ * What a tracker has seen. Used bytes are those
+ * holding a constructed element; the rest of the
+ * live bytes are capacity nobody is using.
+ *************************************************/
+struct allocation_report
+{
+   uint64_t allocations   = 0;
+   uint64_t deallocations = 0;
+   size_t   bytesLive     = 0;
+   size_t   bytesPeak     = 0;
+   size_t   bytesUsed     = 0;
+
+   size_t bytesWasted() const { return bytesLive - bytesUsed; }
+   double fractionWasted() const { return bytesLive ? (double)bytesWasted() / (double)bytesLive : 0.0; }
+
+   void print(std::ostream & out) const
+   {
+      out << "allocations " << allocations << ", frees " << deallocations
+          << ", live " << bytesLive << "B, peak " << bytesPeak
+          << "B, wasted " << bytesWasted() << "B\n";
+   }
+};
+
+/*************************************************
+ * ALLOCATION TRACKER
+ * Counts bytes as allocators hand them out and
+ * take them back
+ *************************************************/
+class allocation_tracker
+{
+   friend class ::TestTrackingAllocator; // give the unit test class access to the privates
+public:
+   // one allocate (positive) or free (negative), and the live bytes after it
+   struct event
+   {
+      long long bytes;
+      size_t    bytesLive;
+   };
+
+   void onAllocate(size_t bytes)
+   {
+      current.allocations++;
+      current.bytesLive += bytes;
+      if (current.bytesLive > current.bytesPeak)
+         current.bytesPeak = current.bytesLive;
+      events.push_back(event{ (long long)bytes, current.bytesLive });
+   }
+   void onDeallocate(size_t bytes)
+   {
+      current.deallocations++;
+      current.bytesLive -= bytes;
+      events.push_back(event{ -(long long)bytes, current.bytesLive });
+   }
+   void onConstruct(size_t bytes) { current.bytesUsed += bytes; }
+   void onDestroy(size_t bytes)   { current.bytesUsed -= bytes; }
+
+   allocation_report report() const            { return current; }
+   const std::vector<event> & history() const  { return events;  }
+
+   // start counting again; the peak restarts at what is live now
+   void reset()
+   {
+      size_t live = current.bytesLive;
+      size_t used = current.bytesUsed;
+      current = allocation_report();
+      current.bytesLive = current.bytesPeak = live;
+      current.bytesUsed = used;
+      events.clear();
+   }
+
+   static allocation_tracker & global()
+   {
+      static allocation_tracker tracker;
+      return tracker;
+   }
+
+private:
+   allocation_report  current;
+   std::vector<event> events;
+};
+
+/*************************************************
+ * TRACKING ALLOCATOR
+ * std::allocator, reporting to a tracker
+ *************************************************/
+template <class T>
+class tracking_allocator
+{
+   template <class U> friend class tracking_allocator;
+public:
+   typedef T value_type;
+   template <class U> struct rebind { typedef tracking_allocator<U> other; };
+
+   tracking_allocator() : tracker(&allocation_tracker::global()) { }
+   explicit tracking_allocator(allocation_tracker & tracker) : tracker(&tracker) { }
+   template <class U>
+   tracking_allocator(const tracking_allocator<U> & rhs) : tracker(rhs.tracker) { }
+
+   T * allocate(size_t n)
+   {
+      T * p = std::allocator<T>().allocate(n);
+      tracker->onAllocate(n * sizeof(T));
+      return p;
+   }
+   void deallocate(T * p, size_t n)
+   {
+      if (p == nullptr)
+         return;
+      tracker->onDeallocate(n * sizeof(T));
+      std::allocator<T>().deallocate(p, n);
+   }
+
+   template <class U, class ... Args>
+   void construct(U * p, Args && ... args)
+   {
+      new ((void *)p) U(std::forward<Args>(args)...);
+      tracker->onConstruct(sizeof(U));
+   }
+   template <class U>
+   void construct_default_init(U * p)
+   {
+      new ((void *)p) U;
+      tracker->onConstruct(sizeof(U));
+   }
+   template <class U>
+   void destroy(U * p)
+   {
+      p->~U();
+      tracker->onDestroy(sizeof(U));
+   }
+
+   allocation_tracker & get_tracker() const { return *tracker; }
+
+   template <class U>
+   bool operator == (const tracking_allocator<U> & rhs) const { return tracker == rhs.tracker; }
+   template <class U>
+   bool operator != (const tracking_allocator<U> & rhs) const { return tracker != rhs.tracker; }
+
+private:
+   allocation_tracker * tracker;
+};
+
+} // namespace custom
@@ -24,6 +24,12 @@
 #include <new>      // std::bad_alloc
 #include <memory>   // for std::allocator
 #include <initializer_list>
+#include <stdexcept> // std::invalid_argument
+#include <type_traits> // std::is_trivially_default_constructible
+#include <algorithm> // std::rotate, std::move
+#include <iterator>  // std::distance, std::iterator_traits
+#include "container_stats.h" // for the no_stats default
+#include "relocate.h"        // for is_trivially_relocatable
 
 class TestVector; // forward declaration for unit tests
 class TestStack;
@@ -33,17 +39,48 @@ class TestHash;
 namespace custom
 {
 
+struct serializer;   // reads and writes the elements (see serialize.h)
+
+/*****************************************
+ * HAS CONSTRUCT DEFAULT INIT
+ * Whether an allocator can default-initialize an
+ * element, leaving a trivial one unwritten, through
+ * alloc.construct_default_init(p), so that an
+ * allocator that counts what it constructs sees it.
+ ****************************************/
+template <class A, class T, class = void>
+struct has_construct_default_init : std::false_type { };
+template <class A, class T>
+struct has_construct_default_init<A, T, std::void_t<decltype(std::declval<A&>().construct_default_init((T *)nullptr))>> : std::true_type { };
+
+/*****************************************
+ * HAS ITERATOR CATEGORY / CAN SUBTRACT
+ * Whether std::distance knows an iterator, and
+ * whether one without traits (vector::iterator)
+ * still measures a range by subtraction.
+ ****************************************/
+template <class Iterator, class = void>
+struct has_iterator_category : std::false_type { };
+template <class Iterator>
+struct has_iterator_category<Iterator, std::void_t<typename std::iterator_traits<Iterator>::iterator_category>> : std::true_type { };
+template <class Iterator, class = void>
+struct can_subtract : std::false_type { };
+template <class Iterator>
+struct can_subtract<Iterator, std::void_t<decltype(std::declval<Iterator&>() - std::declval<Iterator&>())>> : std::true_type { };
+
 /*****************************************
  * VECTOR
- * Just like the std :: vector <T> class
+ * Just like the std :: vector <T> class. Stats
+ * hears about growth (see container_stats.h).
  ****************************************/
-template <typename T, typename A = std::allocator<T>>
+template <typename T, typename A = std::allocator<T>, typename Stats = custom::no_stats>
 class vector
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
+   friend struct custom::serializer;
 public:
 
    //
@@ -89,6 +126,14 @@ public:
    void reserve(size_t newCapacity);
    void resize(size_t newElements);
    void resize(size_t newElements, const T& t);
+   void resize_default_init(size_t newElements);
+   T *  append_uninitialized(size_t count);
+   template <class Iterator>
+   iterator insert(iterator pos, Iterator first, Iterator last);
+   template <class Iterator>
+   void append_range(Iterator first, Iterator last);
+   template <class Iterator>
+   void assign(Iterator first, Iterator last);
 
    //
    // Remove
@@ -104,13 +149,30 @@ public:
    }
    void pop_back()
    {
-       if (data != nullptr)
+       if (numElements > 0)
        {
            alloc.destroy(&data[numElements - 1]);
            numElements--;
+           stats.onPop();
        }
    }
-   void shrink_to_fit();
+   void shrink_to_fit() { shrink_to(numElements); }
+   void shrink_to(size_t newCapacity);
+   iterator erase(iterator first, iterator last);
+
+   //
+   // Ownership
+   //
+   struct buffer                              // an allocation and what is in it
+   {
+      T *    data;
+      size_t size;
+      size_t capacity;
+   };
+   void   adopt(T * p, size_t size, size_t capacity);
+   void   adopt(T * p, size_t size, size_t capacity, const A & a);
+   buffer release();
+   A      get_allocator() const { return alloc; }
 
    //
    // Status
@@ -118,10 +180,20 @@ public:
    size_t  size()          const { return numElements;}
    size_t  capacity()      const { return numCapacity;}
    bool empty()            const { return (size() == 0); }
+   stats_snapshot snapshot() const { return stats.snapshot(); }
 
 private:
 
+   void grow(size_t needed);  // room for NEEDED, at least doubling
+   void constructDefaultInit(size_t first, size_t last); // default-initialize [FIRST, LAST)
+   static void checkAdopt(const T * p, size_t size, size_t capacity);
+   template <class Iterator>
+   static size_t distance(Iterator first, Iterator last);
+   void countPushes(size_t n) { for (size_t i = 0; i < n; i++) stats.onPush(); } // a bulk add, as push_back counts it
+   void countPops(size_t n)   { for (size_t i = 0; i < n; i++) stats.onPop();  } // a bulk removal, as pop_back counts it
+
    A    alloc;                // use allocator for memory allocation
+   Stats stats;               // counts pushes and reallocations, if it cares
    T *  data;                 // user data, a dynamically-allocated array
    size_t  numCapacity;       // the capacity of the array
    size_t  numElements;       // the number of items currently used
@@ -138,8 +210,8 @@ private:
  * This particular iterator is a bi-directional meaning
  * that ++ and -- both work.  Not all iterators are that way.
  *************************************************/
-template <typename T, typename A>
-class vector <T, A> ::iterator
+template <typename T, typename A, typename Stats>
+class vector <T, A, Stats> ::iterator
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
@@ -150,7 +222,7 @@ public:
    iterator() : p(nullptr)                                  {  }
    iterator(T* p) : p(p)                                    {  }
    iterator(const iterator& rhs) : p(rhs.p)                 {  }
-   iterator(size_t index, vector<T>& v) : p(&v.data[index]) {  }
+   iterator(size_t index, vector& v) : p(&v.data[index])    {  }
    iterator& operator = (const iterator& rhs)
    {
       if (this != &rhs)
@@ -162,6 +234,10 @@ public:
    bool operator != (const iterator& rhs) const { return p != rhs.p; }
    bool operator == (const iterator& rhs) const { return p == rhs.p; }
 
+   // distance and offset
+   std::ptrdiff_t operator - (const iterator& rhs) const { return p - rhs.p; }
+   iterator operator + (std::ptrdiff_t n) const { return iterator(p + n); }
+
    // dereference operator
    T& operator * () { return *p;}
    const T& operator*() const { return *p; }
@@ -206,8 +282,8 @@ private:
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T, typename A>                                             // bob
-vector <T, A> :: vector(const A & a)
+template <typename T, typename A, typename Stats>                             // bob
+vector <T, A, Stats> :: vector(const A & a) : alloc(a)
 {
    data = nullptr;
    numElements = 0;
@@ -220,8 +296,8 @@ vector <T, A> :: vector(const A & a)
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T, typename A>                                             // joe
-vector <T, A> :: vector(size_t num, const T & t, const A & a)
+template <typename T, typename A, typename Stats>                             // joe
+vector <T, A, Stats> :: vector(size_t num, const T & t, const A & a) : alloc(a)
 {
     if (num > 0)
     {
@@ -240,9 +316,9 @@ vector <T, A> :: vector(size_t num, const T & t, const A & a)
  * VECTOR :: INITIALIZATION LIST constructors
  * Create a vector with an initialization list.
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector(const std::initializer_list<T> & l, const A & a)      // moe
-   : numElements(l.size()), numCapacity(l.size())
+template <typename T, typename A, typename Stats>
+vector <T, A, Stats> :: vector(const std::initializer_list<T> & l, const A & a)      // moe
+   : alloc(a), numCapacity(l.size()), numElements(l.size())
 {
    if (numElements > 0)
    {
@@ -250,6 +326,8 @@ vector <T, A> :: vector(const std::initializer_list<T> & l, const A & a)      //
       for (auto it = l.begin(); it != l.end(); ++it)
          alloc.construct(&data[it - l.begin()], *it);
    }
+   else
+      data = nullptr;
 }
 
 /*****************************************
@@ -257,8 +335,8 @@ vector <T, A> :: vector(const std::initializer_list<T> & l, const A & a)      //
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T, typename A>                                             // billy
-vector <T, A> :: vector(size_t num, const A & a)
+template <typename T, typename A, typename Stats>                             // billy
+vector <T, A, Stats> :: vector(size_t num, const A & a) : alloc(a)
 {
     if (num > 0)
     {
@@ -279,8 +357,8 @@ vector <T, A> :: vector(size_t num, const A & a)
  * Allocate the space for numElements and
  * call the copy constructor on each element
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector (const vector & rhs)                                  // jr
+template <typename T, typename A, typename Stats>
+vector <T, A, Stats> :: vector (const vector & rhs) : alloc(rhs.alloc)        // jr
 {
     if (rhs.numCapacity > 0)
     {
@@ -302,8 +380,8 @@ vector <T, A> :: vector (const vector & rhs)                                  //
  * VECTOR :: MOVE CONSTRUCTOR
  * Steal the values from the RHS and set it to zero.
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: vector (vector && rhs)                                      // guss
+template <typename T, typename A, typename Stats>
+vector <T, A, Stats> :: vector (vector && rhs) : alloc(rhs.alloc)            // guss
 {
    data = rhs.data;
    rhs.data = nullptr;
@@ -318,8 +396,8 @@ vector <T, A> :: vector (vector && rhs)                                      //
  * Call the destructor for each element from 0..numElements
  * and then free the memory
  ****************************************/
-template <typename T, typename A>
-vector <T, A> :: ~vector()
+template <typename T, typename A, typename Stats>
+vector <T, A, Stats> :: ~vector()
 {
    if (data != nullptr)
    {
@@ -336,8 +414,8 @@ vector <T, A> :: ~vector()
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T, typename A>
-void vector <T, A> :: resize(size_t newElements)
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: resize(size_t newElements)
 {
     // If capacity is the same, do nothing.
     if (newElements == numElements)
@@ -365,8 +443,8 @@ void vector <T, A> :: resize(size_t newElements)
     numElements = newElements;
 }
 
-template <typename T, typename A>
-void vector <T, A> :: resize(size_t newElements, const T & t)
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: resize(size_t newElements, const T & t)
 {
     // If capacity is the same, do nothing.
     if (newElements == numElements)
@@ -394,6 +472,226 @@ void vector <T, A> :: resize(size_t newElements, const T & t)
     numElements = newElements;
   }
 
+/***************************************
+ * VECTOR :: RESIZE DEFAULT INIT
+ * resize(), but new elements are default-initialized
+ * rather than value-initialized: for an int or a POD
+ * key that means left as they are, not zeroed only
+ * to be overwritten (see constructDefaultInit).
+ *     INPUT  : newElements the size wanted
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: resize_default_init(size_t newElements)
+{
+    if (newElements <= numElements)
+    {
+      resize(newElements);
+      return;
+    }
+
+    if (newElements > numCapacity)
+      reserve(newElements);
+
+    constructDefaultInit(numElements, newElements);
+    numElements = newElements;
+}
+
+/***************************************
+ * VECTOR :: APPEND UNINITIALIZED
+ * Grow by COUNT elements nobody has written and
+ * return where they start, for read() or a decoder
+ * to fill in bulk. Capacity at least doubles, so
+ * appending a block at a time stays amortized.
+ *     INPUT  : count the elements to add
+ *     OUTPUT : the first of them
+ **************************************/
+template <typename T, typename A, typename Stats>
+T * vector <T, A, Stats> :: append_uninitialized(size_t count)
+{
+   static_assert(std::is_trivially_default_constructible<T>::value,
+                 "append_uninitialized leaves the elements unwritten");
+   size_t oldElements = numElements;
+   grow(oldElements + count);
+   constructDefaultInit(oldElements, oldElements + count);
+   numElements = oldElements + count;
+   return data + oldElements;
+}
+
+/***************************************
+ * VECTOR :: CONSTRUCT DEFAULT INIT
+ * Default-initialize the elements in [FIRST, LAST),
+ * which are raw memory, so that destroy() may later
+ * be called on each. An allocator that offers
+ * construct_default_init does it. std::allocator
+ * has no say in construction, so placement new does,
+ * and nothing at all for a trivial T. Any other
+ * allocator gets its construct(): value-initialized,
+ * zeroed, but counted as it expects.
+ *     INPUT  : first, last
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: constructDefaultInit(size_t first, size_t last)
+{
+   if constexpr (has_construct_default_init<A, T>::value)
+   {
+      for (size_t i = first; i < last; i++)
+         alloc.construct_default_init(data + i);
+   }
+   else if constexpr (std::is_same<A, std::allocator<T>>::value)
+   {
+      if constexpr (!std::is_trivially_default_constructible<T>::value)
+         for (size_t i = first; i < last; i++)
+            new ((void *)(data + i)) T;
+   }
+   else
+   {
+      for (size_t i = first; i < last; i++)
+         alloc.construct(data + i);
+   }
+}
+
+/***************************************
+ * VECTOR :: INSERT
+ * Put copies of [FIRST, LAST) before POS, growing
+ * once. The elements after POS shift up by memmove
+ * when T is trivially relocatable; otherwise the new
+ * ones are appended and rotated into place. If a copy
+ * throws, the copies made so far are destroyed and
+ * the vector is as it was.
+ *     INPUT  : pos, and the range to copy
+ *     OUTPUT : the first element inserted
+ **************************************/
+template <typename T, typename A, typename Stats>
+template <class Iterator>
+typename vector <T, A, Stats> :: iterator
+vector <T, A, Stats> :: insert(iterator pos, Iterator first, Iterator last)
+{
+   size_t index = (size_t)(pos - begin());
+   size_t count = distance(first, last);
+   if (count == 0)
+      return begin() + index;
+   grow(numElements + count);
+
+   if constexpr (is_trivially_relocatable<T>::value)
+   {
+      relocate_overlapping(data + index + count, data + index, numElements - index);
+      size_t i = index;
+      try
+      {
+         for (; first != last; ++first, ++i)
+            alloc.construct(data + i, *first);
+      }
+      catch (...)
+      {
+         // the gap must be raw memory again before the tail comes back
+         while (i > index)
+            alloc.destroy(data + --i);
+         relocate_overlapping(data + index, data + index + count, numElements - index);
+         throw;
+      }
+      numElements += count;
+   }
+   else
+   {
+      size_t oldElements = numElements;
+      try
+      {
+         for (; first != last; ++first, ++numElements)
+            alloc.construct(data + numElements, *first);
+      }
+      catch (...)
+      {
+         while (numElements > oldElements)
+            alloc.destroy(data + --numElements);
+         throw;
+      }
+      std::rotate(data + index, data + oldElements, data + numElements);
+   }
+   countPushes(count);
+   stats.onSize(numElements);
+   return begin() + index;
+}
+
+/***************************************
+ * VECTOR :: APPEND RANGE
+ * push_back every element of [FIRST, LAST), with
+ * one capacity check instead of one each
+ *     INPUT  : the range to copy
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Stats>
+template <class Iterator>
+void vector <T, A, Stats> :: append_range(Iterator first, Iterator last)
+{
+   size_t oldElements = numElements;
+   grow(numElements + distance(first, last));
+   for (; first != last; ++first, ++numElements)
+      alloc.construct(data + numElements, *first);
+   countPushes(numElements - oldElements);
+   stats.onSize(numElements);
+}
+
+/***************************************
+ * VECTOR :: ASSIGN
+ * Replace the elements with copies of [FIRST, LAST),
+ * allocating only if they do not fit
+ *     INPUT  : the range to copy
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Stats>
+template <class Iterator>
+void vector <T, A, Stats> :: assign(Iterator first, Iterator last)
+{
+   countPops(numElements);
+   clear();
+   reserve(distance(first, last));
+   for (; first != last; ++first, ++numElements)
+      alloc.construct(data + numElements, *first);
+   countPushes(numElements);
+   stats.onSize(numElements);
+}
+
+/***************************************
+ * VECTOR :: GROW
+ * Make room for NEEDED elements. Capacity at least
+ * doubles, so a run of bulk appends stays amortized.
+ *     INPUT  : needed the size about to be reached
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: grow(size_t needed)
+{
+   if (needed > numCapacity)
+      reserve(needed > numCapacity * 2 ? needed : numCapacity * 2);
+}
+
+/***************************************
+ * VECTOR :: DISTANCE
+ * How many elements from FIRST to LAST, from any
+ * iterator that can be walked twice. std::distance
+ * takes those with traits: O(1) for random access.
+ * Without traits, subtraction if it is there, and
+ * only otherwise a walk.
+ **************************************/
+template <typename T, typename A, typename Stats>
+template <class Iterator>
+size_t vector <T, A, Stats> :: distance(Iterator first, Iterator last)
+{
+   if constexpr (has_iterator_category<Iterator>::value)
+      return (size_t)std::distance(first, last);
+   else if constexpr (can_subtract<Iterator>::value)
+      return (size_t)(last - first);
+   else
+   {
+      size_t count = 0;
+      for (; first != last; ++first)
+         count++;
+      return count;
+   }
+}
+
 /***************************************
  * VECTOR :: RESERVE
  * This method will grow the current buffer
@@ -402,22 +700,30 @@ void vector <T, A> :: resize(size_t newElements, const T & t)
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T, typename A>
-void vector <T, A> :: reserve(size_t newCapacity)
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: reserve(size_t newCapacity)
 {
    if (newCapacity <= numCapacity)
       return;
 
    // allocate new array
    T * dataNew = alloc.allocate(newCapacity);
+   stats.onRealloc();
 
-   // move old elements to new array
-   for (size_t i = 0; i < numElements; i++)
-      new ((void*)(dataNew + i)) T(std::move(data[i]));
-
+   // move old elements to new array: their bytes, if that is all they are
+   if constexpr (is_trivially_relocatable<T>::value)
+   {
+      if (numElements)
+         relocate(dataNew, data, numElements);
+   }
+   else
+   {
+      for (size_t i = 0; i < numElements; i++)
+         alloc.construct(dataNew + i, std::move(data[i]));
 
-   for (size_t i = 0; i < numElements; i++)
-      alloc.destroy(&data[i]);
+      for (size_t i = 0; i < numElements; i++)
+         alloc.destroy(&data[i]);
+   }
 
    alloc.deallocate(data, numCapacity);
    data = dataNew;
@@ -425,52 +731,180 @@ void vector <T, A> :: reserve(size_t newCapacity)
 }
 
 /***************************************
- * VECTOR :: SHRINK TO FIT
- * Get rid of any extra capacity
- *     INPUT  :
+ * VECTOR :: SHRINK TO
+ * Give back capacity beyond NEWCAPACITY, though
+ * never below what is in use. The elements are
+ * relocated, or moved, into the smaller array.
+ * shrink_to_fit is shrink_to(size()).
+ *     INPUT  : newCapacity
  *     OUTPUT :
  **************************************/
-template <typename T, typename A>
-void vector <T, A> :: shrink_to_fit()
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: shrink_to(size_t newCapacity)
 {
-    if (numElements == numCapacity)
+    if (newCapacity < numElements)
+        newCapacity = numElements;
+    if (newCapacity >= numCapacity)
         return;
-    else if (numElements == 0)
+    else if (newCapacity == 0)
     {
-        if (data != nullptr)
-        {
-            alloc.deallocate(data, numCapacity);
-            data = nullptr;
-            numCapacity = 0;
-        }
+        alloc.deallocate(data, numCapacity);
+        data = nullptr;
+        numCapacity = 0;
     }
     else
     {
-        // Allocate new memory with the size of numElements
-        T* newData = alloc.allocate(numElements);
+        // Allocate new memory with the size of newCapacity
+        T* newData = alloc.allocate(newCapacity);
+        stats.onRealloc();
 
         // Move elements to the new memory
-        for (size_t i = 0; i < numElements; ++i)
-        {
-            alloc.construct(&newData[i], data[i]);
-            alloc.destroy(&data[i]);
-        }
+        if constexpr (is_trivially_relocatable<T>::value)
+            relocate(newData, data, numElements);
+        else
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                alloc.construct(&newData[i], std::move(data[i]));
+                alloc.destroy(&data[i]);
+            }
 
         // Deallocate old memory
         alloc.deallocate(data, numCapacity);
 
         // Update data pointer and capacity
         data = newData;
-        numCapacity = numElements;
+        numCapacity = newCapacity;
     }
 }
 
+/***************************************
+ * VECTOR :: ERASE
+ * Remove [FIRST, LAST). The elements after it shift
+ * down by memmove when T is trivially relocatable,
+ * by move assignment otherwise.
+ *     INPUT  : the range to remove
+ *     OUTPUT : the element after the last removed
+ **************************************/
+template <typename T, typename A, typename Stats>
+typename vector <T, A, Stats> :: iterator
+vector <T, A, Stats> :: erase(iterator first, iterator last)
+{
+   size_t index = (size_t)(first - begin());
+   size_t count = (size_t)(last - first);
+   if (count == 0)
+      return first;
+
+   if constexpr (is_trivially_relocatable<T>::value)
+   {
+      for (size_t i = index; i < index + count; i++)
+         alloc.destroy(data + i);
+      relocate_overlapping(data + index, data + index + count, numElements - index - count);
+   }
+   else
+   {
+      std::move(data + index + count, data + numElements, data + index);
+      for (size_t i = numElements - count; i < numElements; i++)
+         alloc.destroy(data + i);
+   }
+   numElements -= count;
+   countPops(count);
+   return begin() + index;
+}
+
+/***************************************
+ * VECTOR :: ADOPT
+ * Take ownership of a buffer allocated elsewhere
+ * instead of copying it: the first SIZE of its
+ * CAPACITY elements are constructed. They will be
+ * destroyed with A::destroy and the buffer freed
+ * with A::deallocate(p, capacity), so both must have
+ * come from an allocator equal to A: its allocate()
+ * and its construct(), or what std::allocator takes
+ * as the same (a buffer from malloc or a decoder
+ * wants an allocator that frees the same way). What
+ * the vector held before is destroyed, unless P is
+ * the buffer it already has: then only the elements
+ * past SIZE are.
+ *     INPUT  : p, size, capacity, and optionally a
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: adopt(T * p, size_t size, size_t capacity)
+{
+   checkAdopt(p, size, capacity);
+
+   if (p != nullptr && p == data)
+   {
+      for (size_t i = size; i < numElements; i++)
+         alloc.destroy(&data[i]);
+   }
+   else if (data != nullptr)
+   {
+      for (size_t i = 0; i < numElements; i++)
+         alloc.destroy(&data[i]);
+      alloc.deallocate(data, numCapacity);
+   }
+   data = p;
+   numElements = size;
+   numCapacity = capacity;
+}
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: adopt(T * p, size_t size, size_t capacity, const A & a)
+{
+   checkAdopt(p, size, capacity);
+
+   if (p == nullptr || p != data)
+   {
+      clear();
+      shrink_to_fit();
+   }
+   alloc = a;
+   adopt(p, size, capacity);
+}
+
+/***************************************
+ * VECTOR :: CHECK ADOPT
+ * Refuse a buffer smaller than its size, or one
+ * whose pointer and capacity disagree about whether
+ * there is a buffer at all
+ *     INPUT  : p, size, capacity
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: checkAdopt(const T * p, size_t size, size_t capacity)
+{
+   if (size > capacity)
+      throw std::invalid_argument("vector: adopted buffer is smaller than its size");
+   if ((p == nullptr) != (capacity == 0))
+      throw std::invalid_argument("vector: adopted buffer and capacity disagree");
+}
+
+/***************************************
+ * VECTOR :: RELEASE
+ * Give up the buffer, elements and all, leaving the
+ * vector empty. The caller now owns it: destroy each
+ * element with get_allocator().destroy() and free it
+ * with get_allocator().deallocate(), or hand it to
+ * another vector's adopt().
+ *     INPUT  :
+ *     OUTPUT : the buffer, its size, and its capacity
+ **************************************/
+template <typename T, typename A, typename Stats>
+typename vector <T, A, Stats> :: buffer vector <T, A, Stats> :: release()
+{
+   buffer released{ data, numElements, numCapacity };
+   data = nullptr;
+   numElements = 0;
+   numCapacity = 0;
+   return released;
+}
+
 /*****************************************
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  ****************************************/
-template <typename T, typename A>
-T & vector <T, A> :: operator [] (size_t index)
+template <typename T, typename A, typename Stats>
+T & vector <T, A, Stats> :: operator [] (size_t index)
 {
    return data[index];
 }
@@ -479,8 +913,8 @@ T & vector <T, A> :: operator [] (size_t index)
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  *****************************************/
-template <typename T, typename A>
-const T & vector <T, A> :: operator [] (size_t index) const
+template <typename T, typename A, typename Stats>
+const T & vector <T, A, Stats> :: operator [] (size_t index) const
 {
    return data[index];
 }
@@ -489,8 +923,8 @@ const T & vector <T, A> :: operator [] (size_t index) const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T, typename A>
-T & vector <T, A> :: front ()
+template <typename T, typename A, typename Stats>
+T & vector <T, A, Stats> :: front ()
 {
    return data[0];
 }
@@ -499,8 +933,8 @@ T & vector <T, A> :: front ()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T, typename A>
-const T & vector <T, A> :: front () const
+template <typename T, typename A, typename Stats>
+const T & vector <T, A, Stats> :: front () const
 {
    return data[0];
 }
@@ -509,8 +943,8 @@ const T & vector <T, A> :: front () const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T, typename A>
-T & vector <T, A> :: back()
+template <typename T, typename A, typename Stats>
+T & vector <T, A, Stats> :: back()
 {
    return data[numElements - 1];
 }
@@ -519,8 +953,8 @@ T & vector <T, A> :: back()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T, typename A>
-const T & vector <T, A> :: back() const
+template <typename T, typename A, typename Stats>
+const T & vector <T, A, Stats> :: back() const
 {
    return data[numElements - 1];
 }
@@ -533,8 +967,8 @@ const T & vector <T, A> :: back() const
  *     INPUT  : 't' the new element to be added
  *     OUTPUT : *this
  **************************************/
-template <typename T, typename A>
-void vector <T, A> :: push_back (const T & t)
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> :: push_back (const T & t)
 {
    if (size() == 0)
       reserve(1);
@@ -543,12 +977,16 @@ void vector <T, A> :: push_back (const T & t)
    if (size() == capacity())
       reserve(capacity() * 2);
 
-   // Add t to end of current values and increment numElements
-   alloc.construct(data + numElements++, t);
+   // Add t to end of current values, then count it: a copy
+   // that throws leaves the vector as it was
+   alloc.construct(data + numElements, t);
+   numElements++;
+   stats.onPush();
+   stats.onSize(numElements);
 }
 
-template <typename T, typename A>
-void vector <T, A> ::push_back(T && t)
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> ::push_back(T && t)
 {
     if (size() == 0)
       reserve(1);
@@ -557,8 +995,11 @@ void vector <T, A> ::push_back(T && t)
     if (size() == capacity())
        reserve(capacity() * 2);
 
-    // Move t to end of current values and increment numElements
-    alloc.construct(data + numElements++, std::move(t));
+    // Move t to end of current values, then count it
+    alloc.construct(data + numElements, std::move(t));
+    numElements++;
+    stats.onPush();
+    stats.onSize(numElements);
 }
 
 /***************************************
@@ -568,8 +1009,8 @@ void vector <T, A> ::push_back(T && t)
  *     INPUT  : rhs the vector to swap with
  *     OUTPUT : *this
  **************************************/
-template <typename T, typename A>
-void vector <T, A> ::swap(vector& rhs)
+template <typename T, typename A, typename Stats>
+void vector <T, A, Stats> ::swap(vector& rhs)
 {
    // Swap data pointers
    T* tempData = data;
@@ -585,6 +1026,11 @@ void vector <T, A> ::swap(vector& rhs)
    size_t tempNumCapacity = numCapacity;
    numCapacity = rhs.numCapacity;
    rhs.numCapacity = tempNumCapacity;
+
+   // Swap allocators: each buffer goes back to the one that made it
+   A tempAlloc = alloc;
+   alloc = rhs.alloc;
+   rhs.alloc = tempAlloc;
 }
 
 /***************************************
@@ -594,8 +1040,8 @@ void vector <T, A> ::swap(vector& rhs)
  *     INPUT  : rhs the vector to copy from
  *     OUTPUT : *this
  **************************************/
-template <typename T, typename A>
-vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
+template <typename T, typename A, typename Stats>
+vector <T, A, Stats> & vector <T, A, Stats> :: operator = (const vector & rhs)
 {
    if (this != &rhs)
    {
@@ -639,8 +1085,8 @@ vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
    }
    return *this;
 }
-template <typename T, typename A>
-vector <T, A>& vector <T, A> :: operator = (vector&& rhs)
+template <typename T, typename A, typename Stats>
+vector <T, A, Stats>& vector <T, A, Stats> :: operator = (vector&& rhs)
 {
    if (this != &rhs)
    {